@@ -204,7 +204,7 @@ int GetFieldIntVal(int Dialog, int Field)
   if (p)
   {
     rc= atoi(p);
-    free(p);
+    MADB_FREE(p);
   }
   return rc;
 }
@@ -894,7 +894,7 @@ BOOL DSNDialog(HWND     hwndParent,
       /* Need to set driver after connstring parsing, and before saving */
       if (lpszDriver)
       {
-        Dsn->Driver= _strdup(lpszDriver);
+        Dsn->Driver= MADB_STRDUP(lpszDriver);
       }
 
       if (SQL_SUCCEEDED(TestDSN(Dsn, NULL, NULL)))
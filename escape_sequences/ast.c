@@ -19,133 +19,168 @@
 
 #include "ma_global.h"
 #include "ast.h"
+#include "ma_allocator.h"
 #include <stdarg.h>
 #include <string.h>
 
-struct ASTNode *newLeaf(const char* const lexeme)
+// Size of the data part of a regular arena block.
+// Bigger requests get a dedicated block of the requested size.
+//
+#define AST_ARENA_BLOCK_SIZE 4096
+#define AST_ARENA_ALIGNMENT sizeof(void*)
+#define AST_ARENA_ALIGN(size) (((size) + AST_ARENA_ALIGNMENT - 1) & ~(AST_ARENA_ALIGNMENT - 1))
+#define AST_ARENA_BLOCK_DATA(block) ((char*)(block) + AST_ARENA_ALIGN(sizeof(struct ASTArenaBlock)))
+
+void initArena(struct ASTArena *arena)
 {
-  struct ASTNode* x = malloc( sizeof( struct ASTNode ));
-  if (x == NULL)
+  arena->first = NULL;
+  arena->current = NULL;
+}
+
+static struct ASTArenaBlock *newArenaBlock(size_t size)
+{
+  struct ASTArenaBlock *block = MADB_Malloc(AST_ARENA_ALIGN(sizeof(struct ASTArenaBlock)) + size);
+  if (block == NULL)
   {
     return NULL;
   }
-  x->lexeme = strdup(lexeme);
-  if (x->lexeme == NULL)
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+  return block;
+}
+
+void *arenaAlloc(struct ASTArena *arena, size_t size)
+{
+  struct ASTArenaBlock *block = arena->current;
+  void *res;
+
+  size = AST_ARENA_ALIGN(size);
+
+  // Blocks after the current one are left from the previous escape block,
+  // so they can be reused before anything new is allocated
+  //
+  while (block != NULL && block->size - block->used < size && block->next != NULL)
   {
-    free(x);
-    return NULL;
+    block = block->next;
+    block->used = 0;
   }
-  x->totalLength = strlen(lexeme);
-  x->childrenCount = 0;
-  return x;
+
+  if (block == NULL || block->size - block->used < size)
+  {
+    struct ASTArenaBlock *newBlock = newArenaBlock(size > AST_ARENA_BLOCK_SIZE ? size : AST_ARENA_BLOCK_SIZE);
+    if (newBlock == NULL)
+    {
+      return NULL;
+    }
+    if (block == NULL)
+    {
+      arena->first = newBlock;
+    } else
+    {
+      newBlock->next = block->next;
+      block->next = newBlock;
+    }
+    block = newBlock;
+  }
+
+  arena->current = block;
+  res = AST_ARENA_BLOCK_DATA(block) + block->used;
+  block->used += size;
+  return res;
 }
 
-struct ASTNode *newNode(int childrenCount, va_list children)
+char *arenaStrdup(struct ASTArena *arena, const char* const str)
 {
-  struct ASTNode* x = malloc(sizeof(struct ASTNode));
-  if (x == NULL)
+  size_t length = strlen(str);
+  char *res = arenaAlloc(arena, length + 1);
+  if (res == NULL)
   {
     return NULL;
   }
+  memcpy(res, str, length + 1);
+  return res;
+}
 
-  x->childrenCount=childrenCount;
-  x->children = malloc(childrenCount * sizeof(struct ASTNode*));
-  if (x->children == NULL)
+void resetArena(struct ASTArena *arena)
+{
+  arena->current = arena->first;
+  if (arena->current != NULL)
   {
-    free(x);
-    return NULL;
+    arena->current->used = 0;
   }
-  x->totalLength = 0;
+}
 
-  int i;
-  for (i = 0; i < childrenCount; i++)
+void freeArena(struct ASTArena *arena)
+{
+  struct ASTArenaBlock *block = arena->first;
+  while (block != NULL)
   {
-    x->children[i] = va_arg(children, struct ASTNode*);
-    x->totalLength += x->children[i]->totalLength;
+    struct ASTArenaBlock *next = block->next;
+    MADB_Free(block);
+    block = next;
   }
-
-  return x;
+  initArena(arena);
 }
 
-void appendToString(MADB_DynString *res, struct ASTNode *x)
+// lexeme is not copied, it should be either a string literal or
+// a string that lives in the same arena
+//
+struct ASTNode *newLeaf(struct ASTArena *arena, const char* const lexeme)
 {
-  if (x->childrenCount == 0)
-  {
-    MADB_DynstrAppend(res, x->lexeme);
-  } else
+  struct ASTNode* x = arenaAlloc(arena, sizeof(struct ASTNode));
+  if (x == NULL || lexeme == NULL)
   {
-    int i;
-    for (i = 0; i < x->childrenCount; i++)
-    {
-      appendToString(res, x->children[i]);
-    }
+    return NULL;
   }
+  x->lexeme = lexeme;
+  x->totalLength = strlen(lexeme);
+  x->childrenCount = 0;
+  x->children = NULL;
+  return x;
 }
 
-struct ASTNode *copyTree(struct ASTNode *root)
+// Nodes are immutable after creation, so the same subtree may be
+// referenced by several parents without copying it
+//
+struct ASTNode *newNode(struct ASTArena *arena, int childrenCount, va_list children)
 {
-  struct ASTNode* x = malloc(sizeof(struct ASTNode));
+  struct ASTNode* x = arenaAlloc(arena, sizeof(struct ASTNode));
   if (x == NULL)
   {
     return NULL;
   }
 
-  if (root->childrenCount != 0)
+  x->childrenCount=childrenCount;
+  x->children = arenaAlloc(arena, childrenCount * sizeof(struct ASTNode*));
+  if (x->children == NULL)
   {
-    x->childrenCount=root->childrenCount;
-    x->children = malloc(root->childrenCount * sizeof(struct ASTNode*));
-    if (x->children == NULL)
-    {
-      free(x);
-      return NULL;
-    }
-    x->totalLength = root->totalLength;
+    return NULL;
+  }
+  x->totalLength = 0;
+  x->lexeme = NULL;
 
-    int i;
-    for (i = 0; i < root->childrenCount; i++)
-    {
-      x->children[i] = copyTree(root->children[i]);
-      if (x->children[i] == NULL)
-      {
-        int j;
-        for (j = 0; j < i; j++)
-        {
-          freeTree(x->children[j]);
-        }
-        free(x->children);
-        free(x);
-        return NULL;
-      }
-    }
-  } else
+  int i;
+  for (i = 0; i < childrenCount; i++)
   {
-    x->childrenCount = 0;
-    x->totalLength = root->totalLength;
-    x->lexeme = strdup(root->lexeme);
-    if (x->lexeme == NULL)
-    {
-      free(x);
-      return NULL;
-    }
+    x->children[i] = va_arg(children, struct ASTNode*);
+    x->totalLength += x->children[i]->totalLength;
   }
 
   return x;
 }
 
-void freeTree(struct ASTNode *x)
+void appendToString(MADB_DynString *res, struct ASTNode *x)
 {
   if (x->childrenCount == 0)
   {
-    free(x->lexeme);
+    MADB_DynstrAppendMem(res, x->lexeme, x->totalLength);
   } else
   {
     int i;
     for (i = 0; i < x->childrenCount; i++)
     {
-      freeTree(x->children[i]);
+      appendToString(res, x->children[i]);
     }
-    free(x->children);
   }
-
-  free(x);
 }
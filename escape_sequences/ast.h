@@ -27,13 +27,34 @@ struct ASTNode
   struct ASTNode **children;
   int childrenCount;
   size_t totalLength;
-  char *lexeme;
+  const char *lexeme;
 };
 
-struct ASTNode *newLeaf(const char* const lexeme);
-struct ASTNode *newNode(int childrenCount, va_list children);
-struct ASTNode *copyTree(struct ASTNode *root);
+// ASTArena is a bump allocator that owns every node and lexeme created while
+// parsing escape sequences. Nodes are never freed one by one, the whole arena is
+// rewound with resetArena after each escape block and released with freeArena.
+//
+struct ASTArenaBlock
+{
+  struct ASTArenaBlock *next;
+  size_t size;
+  size_t used;
+};
+
+struct ASTArena
+{
+  struct ASTArenaBlock *first;
+  struct ASTArenaBlock *current;
+};
+
+void initArena(struct ASTArena *arena);
+void *arenaAlloc(struct ASTArena *arena, size_t size);
+char *arenaStrdup(struct ASTArena *arena, const char* const str);
+void resetArena(struct ASTArena *arena);
+void freeArena(struct ASTArena *arena);
+
+struct ASTNode *newLeaf(struct ASTArena *arena, const char* const lexeme);
+struct ASTNode *newNode(struct ASTArena *arena, int childrenCount, va_list children);
 void appendToString(MADB_DynString *res, struct ASTNode *x);
-void freeTree(struct ASTNode *x);
 
 #endif //MARIADB_CONNECTOR_C_AST_H
@@ -540,6 +540,7 @@ static const flex_int16_t yy_chk[282] =
   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
 *************************************************************************************/
 #include "escape_sequences/parser.h"
+#include "escape_sequences/ast.h"
 #define YY_DECL int yylex(YYSTYPE * yylval_param, yyscan_t yyscanner, MADB_Error *error, MADB_Dbc *Dbc)
 int yylex();
 
@@ -932,7 +933,7 @@ case 17:
 /* rule 17 can match eol */
 YY_RULE_SETUP
 {
-                                                yylval->string = strdup(yytext);
+                                                yylval->string = arenaStrdup(yyextra, yytext);
                                                 if (yylval->string == NULL)
                                                 {
                                                     return ALLOCATION_ERROR;
@@ -957,7 +958,7 @@ case 18:
 /* rule 18 can match eol */
 YY_RULE_SETUP
 {
-                                                yylval->string = strdup(yytext);
+                                                yylval->string = arenaStrdup(yyextra, yytext);
                                                 if (yylval->string == NULL)
                                                 {
                                                     return ALLOCATION_ERROR;
@@ -969,7 +970,7 @@ case 19:
 /* rule 19 can match eol */
 YY_RULE_SETUP
 {
-                                                yylval->string = strdup(yytext);
+                                                yylval->string = arenaStrdup(yyextra, yytext);
                                                 if (yylval->string == NULL)
                                                 {
                                                     return ALLOCATION_ERROR;
@@ -980,7 +981,7 @@ YY_RULE_SETUP
 case 20:
 YY_RULE_SETUP
 {
-                                                yylval->string = strdup(yytext);
+                                                yylval->string = arenaStrdup(yyextra, yytext);
                                                 if (yylval->string == NULL)
                                                 {
                                                     return ALLOCATION_ERROR;
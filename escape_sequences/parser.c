@@ -216,16 +216,21 @@ static const char *getSingleStoreDataType(MADB_Dbc *Dbc, const char *dataType)
 
 void setRes(MADB_DynString *res, struct ASTNode *x)
 {
-	MADB_InitDynamicString(res, "", x->totalLength, 256);
+	MADB_InitDynamicString(res, "", x->totalLength + 1, 256);
 	appendToString(res, x);
 }
 
 // allocateNode creates a new ASTNode using newNode
 // If some error occurs during the memory allocation
-// or at least one child node is null,
-// it will free all children and return NULL
+// or at least one child node is null, it will return NULL.
+// All nodes are owned by the arena, so nothing has to be freed on error
 //
-struct ASTNode* allocateNode(int childrenCount, ...);
+struct ASTNode* allocateNode(struct ASTArena *arena, int childrenCount, ...);
+
+// The arena is attached to the scanner as its extra data
+//
+void *yyget_extra(void *scanner);
+#define ARENA ((struct ASTArena *)yyget_extra(scanner))
 
 #define YYALOCATION_ERROR do \
 { \
@@ -1223,41 +1228,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, void *scanner, MAD
   YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  switch (yytype)
-    {
-    case 20: /* STRING_LITERAL  */
-
-      { free (((*yyvaluep).string)); }
-
-        break;
-
-    case 21: /* LEXEME  */
-
-      { free (((*yyvaluep).string)); }
-
-        break;
-
-    case 24: /* function_call  */
-
-      { freeTree (((*yyvaluep).ast)); }
-
-        break;
-
-    case 25: /* lexemes  */
-
-      { freeTree (((*yyvaluep).ast)); }
-
-        break;
-
-    case 26: /* lexeme  */
-
-      { freeTree (((*yyvaluep).ast)); }
-
-        break;
-
-      default:
-        break;
-    }
+  YYUSE (yytype);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1523,19 +1494,17 @@ yyreduce:
         case 2:
 
     {
-		struct ASTNode *stringLiteral = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		struct ASTNode *stringLiteral = newLeaf(ARENA, (yyvsp[0].string));
 
 		// "($2 :> DATE)"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> DATE)"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> DATE)"));
 		if (x == NULL)
 		{
 			YYALOCATION_ERROR;
 		}
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1543,17 +1512,15 @@ yyreduce:
   case 3:
 
     {
-		struct ASTNode *stringLiteral = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		struct ASTNode *stringLiteral = newLeaf(ARENA, (yyvsp[0].string));
 
 		// "($2 :> TIME)"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> TIME)"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> TIME)"));
 		if (x == NULL)
 		{ YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1561,16 +1528,14 @@ yyreduce:
   case 4:
 
     {
-		struct ASTNode *stringLiteral = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		struct ASTNode *stringLiteral = newLeaf(ARENA, (yyvsp[0].string));
 
 		// "($2 :> TIMESTAMP(6))"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> TIMESTAMP(6))"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> TIMESTAMP(6))"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1578,16 +1543,14 @@ yyreduce:
   case 5:
 
     {
-		struct ASTNode *lexeme = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		struct ASTNode *lexeme = newLeaf(ARENA, (yyvsp[0].string));
 
 		// "CALL $2()"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("CALL "), lexeme, newLeaf("()"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "CALL "), lexeme, newLeaf(ARENA, "()"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1597,11 +1560,10 @@ yyreduce:
     {
 		// "CALL $2"
 		//
-		struct ASTNode *x = allocateNode(2, newLeaf("CALL "), (yyvsp[0].ast));
+		struct ASTNode *x = allocateNode(ARENA, 2, newLeaf(ARENA, "CALL "), (yyvsp[0].ast));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1610,7 +1572,6 @@ yyreduce:
 
     {
 		setRes(res, (yyvsp[0].ast));
-		freeTree((yyvsp[0].ast));
 	}
 
     break;
@@ -1618,16 +1579,14 @@ yyreduce:
   case 8:
 
     {
-		struct ASTNode *lexeme = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		struct ASTNode *lexeme = newLeaf(ARENA, (yyvsp[0].string));
 
 		// "$2()"
 		//
-		struct ASTNode *x = allocateNode(2, lexeme, newLeaf("()"));
+		struct ASTNode *x = allocateNode(ARENA, 2, lexeme, newLeaf(ARENA, "()"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 
     break;
@@ -1636,7 +1595,6 @@ yyreduce:
 
     {
 		setRes(res, (yyvsp[0].ast));
-		freeTree((yyvsp[0].ast));
 	}
 
     break;
@@ -1646,7 +1604,7 @@ yyreduce:
     {
 		// "LENGTH($3)*8"
 		//
-		(yyval.ast) = allocateNode(3, newLeaf("LENGTH("), (yyvsp[-1].ast), newLeaf(")*8"));
+		(yyval.ast) = allocateNode(ARENA, 3, newLeaf(ARENA, "LENGTH("), (yyvsp[-1].ast), newLeaf(ARENA, ")*8"));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1657,22 +1615,22 @@ yyreduce:
     {
 		// CONCAT(CONCAT(LEFT($3, $5 - 1), $9), RIGHT($3, CHAR_LENGTH($3) - $7 - $5 + 1))
 		//
-		(yyval.ast) = allocateNode(15,
-			newLeaf("CONCAT(CONCAT(LEFT("),
+		(yyval.ast) = allocateNode(ARENA, 15,
+			newLeaf(ARENA, "CONCAT(CONCAT(LEFT("),
 			(yyvsp[-7].ast),
-			newLeaf(", "),
+			newLeaf(ARENA, ", "),
 			(yyvsp[-5].ast),
-			newLeaf(" - 1), "),
+			newLeaf(ARENA, " - 1), "),
 			(yyvsp[-1].ast),
-			newLeaf("), RIGHT("),
-			copyTree((yyvsp[-7].ast)),
-			newLeaf(", CHAR_LENGTH("),
-			copyTree((yyvsp[-7].ast)),
-			newLeaf(") - "),
+			newLeaf(ARENA, "), RIGHT("),
+			(yyvsp[-7].ast),
+			newLeaf(ARENA, ", CHAR_LENGTH("),
+			(yyvsp[-7].ast),
+			newLeaf(ARENA, ") - "),
 			(yyvsp[-3].ast),
-			newLeaf(" - "),
-			copyTree((yyvsp[-5].ast)),
-			newLeaf(" + 1))"));
+			newLeaf(ARENA, " - "),
+			(yyvsp[-5].ast),
+			newLeaf(ARENA, " + 1))"));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1683,37 +1641,35 @@ yyreduce:
     {
 		if (strcasecmp((yyvsp[-5].string), "SQL_TSI_FRAC_SECOND") == 0)
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval((yyvsp[-5].string)));
-			free((yyvsp[-5].string));
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval((yyvsp[-5].string)));
 
 			// The interval is expected to be provided in the billionth of a second,
 			// according to the ODBC documentation
 			// "TIMESTAMPADD(getSingleStoreInterval($3), $5/1000, $7)"
 			//
-			(yyval.ast) = allocateNode(7,
-				newLeaf("TIMESTAMPADD("),
+			(yyval.ast) = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPADD("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-3].ast),
-				newLeaf("/1000, "),
+				newLeaf(ARENA, "/1000, "),
 				(yyvsp[-1].ast),
-				newLeaf(")"));
+				newLeaf(ARENA, ")"));
 			if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 		} else
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval((yyvsp[-5].string)));
-			free((yyvsp[-5].string));
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval((yyvsp[-5].string)));
 
 			// "TIMESTAMPADD(getSingleStoreInterval($3), $5, $7)"
 			//
-			(yyval.ast) = allocateNode(7,
-				newLeaf("TIMESTAMPADD("),
+			(yyval.ast) = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPADD("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-3].ast),
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-1].ast),
-				newLeaf(")"));
+				newLeaf(ARENA, ")"));
 			if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 		}
 	}
@@ -1725,38 +1681,36 @@ yyreduce:
     {
 		if (strcasecmp((yyvsp[-5].string), "SQL_TSI_FRAC_SECOND") == 0)
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval((yyvsp[-5].string)));
-			free((yyvsp[-5].string));
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval((yyvsp[-5].string)));
 
 			// The result is expected to be in the billionth of a second,
 			// according to the ODBC documentation
 			// "TIMESTAMPDIFF(getSingleStoreInterval($3), $5, $7)*1000"
 			//
-			(yyval.ast) = allocateNode(7,
-				newLeaf("TIMESTAMPDIFF("),
+			(yyval.ast) = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPDIFF("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-3].ast),
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-1].ast),
-				newLeaf(")*1000")
+				newLeaf(ARENA, ")*1000")
 			);
 			if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 		} else
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval((yyvsp[-5].string)));
-			free((yyvsp[-5].string));
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval((yyvsp[-5].string)));
 
 			// "TIMESTAMPDIFF(getSingleStoreInterval($3), $5, $7)"
 			//
-			(yyval.ast) = allocateNode(7,
-				newLeaf("TIMESTAMPDIFF("),
+			(yyval.ast) = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPDIFF("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-3].ast),
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				(yyvsp[-1].ast),
-				newLeaf(")")
+				newLeaf(ARENA, ")")
 			);
 			if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 		}
@@ -1767,12 +1721,11 @@ yyreduce:
   case 14:
 
     {
-		struct ASTNode *correctDataTypeName = newLeaf(getSingleStoreDataType(Dbc, (yyvsp[-1].string)));
-		free((yyvsp[-1].string));
+		struct ASTNode *correctDataTypeName = newLeaf(ARENA, getSingleStoreDataType(Dbc, (yyvsp[-1].string)));
 
 		// "$3 :> correctDataTypeName"
 		//
-		(yyval.ast) = allocateNode(3, (yyvsp[-3].ast), newLeaf(" :> "), correctDataTypeName);
+		(yyval.ast) = allocateNode(ARENA, 3, (yyvsp[-3].ast), newLeaf(ARENA, " :> "), correctDataTypeName);
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1783,14 +1736,14 @@ yyreduce:
     {
 		// "LPAD('', CHAR_LENGTH($3)*$5, $3)"
 		//
-		(yyval.ast) = allocateNode(7,
-			newLeaf("LPAD('', CHAR_LENGTH("),
+		(yyval.ast) = allocateNode(ARENA, 7,
+			newLeaf(ARENA, "LPAD('', CHAR_LENGTH("),
 			(yyvsp[-3].ast),
-			newLeaf(")*"),
+			newLeaf(ARENA, ")*"),
 			(yyvsp[-1].ast),
-			newLeaf(", "),
-			copyTree((yyvsp[-3].ast)),
-			newLeaf(")")
+			newLeaf(ARENA, ", "),
+			(yyvsp[-3].ast),
+			newLeaf(ARENA, ")")
 		);
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
@@ -1802,7 +1755,7 @@ yyreduce:
     {
 		// "LPAD('', $3, ' ')"
 		//
-		(yyval.ast) = allocateNode(3, newLeaf("LPAD('', "), (yyvsp[-1].ast), newLeaf(", ' ')"));
+		(yyval.ast) = allocateNode(ARENA, 3, newLeaf(ARENA, "LPAD('', "), (yyvsp[-1].ast), newLeaf(ARENA, ", ' ')"));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1811,16 +1764,15 @@ yyreduce:
   case 17:
 
     {
-		struct ASTNode *lexeme = newLeaf((yyvsp[-3].string));
-		free((yyvsp[-3].string));
+		struct ASTNode *lexeme = newLeaf(ARENA, (yyvsp[-3].string));
 
 		// "$1($3)"
 		//
-		(yyval.ast) = allocateNode(4,
+		(yyval.ast) = allocateNode(ARENA, 4,
 			lexeme,
-			newLeaf("("),
+			newLeaf(ARENA, "("),
 			(yyvsp[-1].ast),
-			newLeaf(")")
+			newLeaf(ARENA, ")")
 		);
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
@@ -1830,12 +1782,11 @@ yyreduce:
   case 18:
 
     {
-		struct ASTNode *lexeme = newLeaf((yyvsp[-2].string));
-		free((yyvsp[-2].string));
+		struct ASTNode *lexeme = newLeaf(ARENA, (yyvsp[-2].string));
 
 		// "$1()"
 		//
-		(yyval.ast) = allocateNode(2, lexeme, newLeaf("()"));
+		(yyval.ast) = allocateNode(ARENA, 2, lexeme, newLeaf(ARENA, "()"));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1854,7 +1805,7 @@ yyreduce:
     {
 		// "$1, $2"
 		//
-		(yyval.ast) = allocateNode(3, (yyvsp[-2].ast), newLeaf(", "), (yyvsp[0].ast));
+		(yyval.ast) = allocateNode(ARENA, 3, (yyvsp[-2].ast), newLeaf(ARENA, ", "), (yyvsp[0].ast));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1863,8 +1814,7 @@ yyreduce:
   case 21:
 
     {
-		(yyval.ast) = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		(yyval.ast) = newLeaf(ARENA, (yyvsp[0].string));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1873,8 +1823,7 @@ yyreduce:
   case 22:
 
     {
-		(yyval.ast) = newLeaf((yyvsp[0].string));
-		free((yyvsp[0].string));
+		(yyval.ast) = newLeaf(ARENA, (yyvsp[0].string));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1885,7 +1834,7 @@ yyreduce:
     {
 		// "$1 $2"
 		//
-		(yyval.ast) = allocateNode(3, (yyvsp[-1].ast), newLeaf(" "), (yyvsp[0].ast));
+		(yyval.ast) = allocateNode(ARENA, 3, (yyvsp[-1].ast), newLeaf(ARENA, " "), (yyvsp[0].ast));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -1904,7 +1853,7 @@ yyreduce:
     {
 		// "($2)"
 		//
-		(yyval.ast) = allocateNode(3, newLeaf("("), (yyvsp[-1].ast), newLeaf(")"));
+		(yyval.ast) = allocateNode(ARENA, 3, newLeaf(ARENA, "("), (yyvsp[-1].ast), newLeaf(ARENA, ")"));
 		if ((yyval.ast) == NULL) { YYALOCATION_ERROR; }
 	}
 
@@ -2145,49 +2094,24 @@ yyreturn:
 
 
 
-void freeChildren(int childrenCount, va_list children)
-{
-	int i;
-	for (i = 0; i < childrenCount; i++)
-	{
-		struct ASTNode *child = va_arg(children, struct ASTNode*);
-		if (child != NULL) { freeTree(child); }
-	}
-}
-
-struct ASTNode* allocateNode(int childrenCount, ...)
+struct ASTNode* allocateNode(struct ASTArena *arena, int childrenCount, ...)
 {
 	va_list valist;
 	va_start(valist, childrenCount);
-	my_bool children_allocated_successfully = TRUE;
 	int i;
 	for (i = 0; i < childrenCount; i++)
 	{
 		if (va_arg(valist, struct ASTNode*) == NULL)
 		{
-			children_allocated_successfully = FALSE;
+			va_end(valist);
+			return NULL;
 		}
 	}
 	va_end(valist);
 
-	if (!children_allocated_successfully)
-	{
-		va_start(valist, childrenCount);
-		freeChildren(childrenCount, valist);
-		va_end(valist);
-		return NULL;
-	}
-
 	va_start(valist, childrenCount);
-	struct ASTNode *res = newNode(childrenCount, valist);
+	struct ASTNode *res = newNode(arena, childrenCount, valist);
 	va_end(valist);
 
-	if (res == NULL)
-	{
-		va_start(valist, childrenCount);
-		freeChildren(childrenCount, valist);
-		va_end(valist);
-	}
-
 	return res;
 }
@@ -171,16 +171,21 @@ static const char *getSingleStoreDataType(MADB_Dbc *Dbc, const char *dataType)
 
 void setRes(MADB_DynString *res, struct ASTNode *x)
 {
-	MADB_InitDynamicString(res, "", x->totalLength, 256);
+	MADB_InitDynamicString(res, "", x->totalLength + 1, 256);
 	appendToString(res, x);
 }
 
 // allocateNode creates a new ASTNode using newNode
 // If some error occurs during the memory allocation
-// or at least one child node is null,
-// it will free all children and return NULL
+// or at least one child node is null, it will return NULL.
+// All nodes are owned by the arena, so nothing has to be freed on error
 //
-struct ASTNode* allocateNode(int childrenCount, ...);
+struct ASTNode* allocateNode(struct ASTArena *arena, int childrenCount, ...);
+
+// The arena is attached to the scanner as its extra data
+//
+void *yyget_extra(void *scanner);
+#define ARENA ((struct ASTArena *)yyget_extra(scanner))
 
 #define YYALOCATION_ERROR do \
 { \
@@ -230,99 +235,83 @@ struct ASTNode* allocateNode(int childrenCount, ...);
 
 %type <ast> function_call lexemes lexeme
 
-%destructor { freeTree ($$); } <ast>
-%destructor { free ($$); } <string>
-
 %%
 res:
 	DATE_ESCAPE STRING_LITERAL
 	{
-		struct ASTNode *stringLiteral = newLeaf($2);
-		free($2);
+		struct ASTNode *stringLiteral = newLeaf(ARENA, $2);
 
 		// "($2 :> DATE)"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> DATE)"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> DATE)"));
 		if (x == NULL)
 		{
 			YYALOCATION_ERROR;
 		}
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  TIME_ESCAPE STRING_LITERAL
 	{
-		struct ASTNode *stringLiteral = newLeaf($2);
-		free($2);
+		struct ASTNode *stringLiteral = newLeaf(ARENA, $2);
 
 		// "($2 :> TIME)"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> TIME)"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> TIME)"));
 		if (x == NULL)
 		{ YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  TIMESTAMP_ESCAPE STRING_LITERAL
 	{
-		struct ASTNode *stringLiteral = newLeaf($2);
-		free($2);
+		struct ASTNode *stringLiteral = newLeaf(ARENA, $2);
 
 		// "($2 :> TIMESTAMP(6))"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("("), stringLiteral, newLeaf(" :> TIMESTAMP(6))"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "("), stringLiteral, newLeaf(ARENA, " :> TIMESTAMP(6))"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  CALL_ESCAPE LEXEME
 	{
-		struct ASTNode *lexeme = newLeaf($2);
-		free($2);
+		struct ASTNode *lexeme = newLeaf(ARENA, $2);
 
 		// "CALL $2()"
 		//
-		struct ASTNode *x = allocateNode(3, newLeaf("CALL "), lexeme, newLeaf("()"));
+		struct ASTNode *x = allocateNode(ARENA, 3, newLeaf(ARENA, "CALL "), lexeme, newLeaf(ARENA, "()"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  CALL_ESCAPE function_call
 	{
 		// "CALL $2"
 		//
-		struct ASTNode *x = allocateNode(2, newLeaf("CALL "), $2);
+		struct ASTNode *x = allocateNode(ARENA, 2, newLeaf(ARENA, "CALL "), $2);
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  OUTER_JOIN_ESCAPE lexemes
 	{
 		setRes(res, $2);
-		freeTree($2);
 	}
 	|  FN_ESCAPE LEXEME
 	{
-		struct ASTNode *lexeme = newLeaf($2);
-		free($2);
+		struct ASTNode *lexeme = newLeaf(ARENA, $2);
 
 		// "$2()"
 		//
-		struct ASTNode *x = allocateNode(2, lexeme, newLeaf("()"));
+		struct ASTNode *x = allocateNode(ARENA, 2, lexeme, newLeaf(ARENA, "()"));
 		if (x == NULL) { YYALOCATION_ERROR; }
 
 		setRes(res, x);
-		freeTree(x);
 	}
 	|  FN_ESCAPE function_call
 	{
 		setRes(res, $2);
-		freeTree($2);
 	}
 	;
 
@@ -331,66 +320,64 @@ function_call:
 	{
 		// "LENGTH($3)*8"
 		//
-		$$ = allocateNode(3, newLeaf("LENGTH("), $3, newLeaf(")*8"));
+		$$ = allocateNode(ARENA, 3, newLeaf(ARENA, "LENGTH("), $3, newLeaf(ARENA, ")*8"));
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| INSERT OPENING_ROUND_BRACKET lexeme COMMA lexeme COMMA lexeme COMMA lexeme CLOSING_ROUND_BRACKET
 	{
 		// CONCAT(CONCAT(LEFT($3, $5 - 1), $9), RIGHT($3, CHAR_LENGTH($3) - $7 - $5 + 1))
 		//
-		$$ = allocateNode(15,
-			newLeaf("CONCAT(CONCAT(LEFT("),
+		$$ = allocateNode(ARENA, 15,
+			newLeaf(ARENA, "CONCAT(CONCAT(LEFT("),
 			$3,
-			newLeaf(", "),
+			newLeaf(ARENA, ", "),
 			$5,
-			newLeaf(" - 1), "),
+			newLeaf(ARENA, " - 1), "),
 			$9,
-			newLeaf("), RIGHT("),
-			copyTree($3),
-			newLeaf(", CHAR_LENGTH("),
-			copyTree($3),
-			newLeaf(") - "),
+			newLeaf(ARENA, "), RIGHT("),
+			$3,
+			newLeaf(ARENA, ", CHAR_LENGTH("),
+			$3,
+			newLeaf(ARENA, ") - "),
 			$7,
-			newLeaf(" - "),
-			copyTree($5),
-			newLeaf(" + 1))"));
+			newLeaf(ARENA, " - "),
+			$5,
+			newLeaf(ARENA, " + 1))"));
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| TIMESTAMPADD OPENING_ROUND_BRACKET LEXEME COMMA lexeme COMMA lexeme CLOSING_ROUND_BRACKET
 	{
 		if (strcasecmp($3, "SQL_TSI_FRAC_SECOND") == 0)
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval($3));
-			free($3);
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval($3));
 
 			// The interval is expected to be provided in the billionth of a second,
 			// according to the ODBC documentation
 			// "TIMESTAMPADD(getSingleStoreInterval($3), $5/1000, $7)"
 			//
-			$$ = allocateNode(7,
-				newLeaf("TIMESTAMPADD("),
+			$$ = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPADD("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$5,
-				newLeaf("/1000, "),
+				newLeaf(ARENA, "/1000, "),
 				$7,
-				newLeaf(")"));
+				newLeaf(ARENA, ")"));
 			if ($$ == NULL) { YYALOCATION_ERROR; }
 		} else
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval($3));
-			free($3);
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval($3));
 
 			// "TIMESTAMPADD(getSingleStoreInterval($3), $5, $7)"
 			//
-			$$ = allocateNode(7,
-				newLeaf("TIMESTAMPADD("),
+			$$ = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPADD("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$5,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$7,
-				newLeaf(")"));
+				newLeaf(ARENA, ")"));
 			if ($$ == NULL) { YYALOCATION_ERROR; }
 		}
 	}
@@ -398,64 +385,61 @@ function_call:
 	{
 		if (strcasecmp($3, "SQL_TSI_FRAC_SECOND") == 0)
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval($3));
-			free($3);
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval($3));
 
 			// The result is expected to be in the billionth of a second,
 			// according to the ODBC documentation
 			// "TIMESTAMPDIFF(getSingleStoreInterval($3), $5, $7)*1000"
 			//
-			$$ = allocateNode(7,
-				newLeaf("TIMESTAMPDIFF("),
+			$$ = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPDIFF("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$5,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$7,
-				newLeaf(")*1000")
+				newLeaf(ARENA, ")*1000")
 			);
 			if ($$ == NULL) { YYALOCATION_ERROR; }
 		} else
 		{
-			struct ASTNode *interval = newLeaf(getSingleStoreInterval($3));
-			free($3);
+			struct ASTNode *interval = newLeaf(ARENA, getSingleStoreInterval($3));
 
 			// "TIMESTAMPDIFF(getSingleStoreInterval($3), $5, $7)"
 			//
-			$$ = allocateNode(7,
-				newLeaf("TIMESTAMPDIFF("),
+			$$ = allocateNode(ARENA, 7,
+				newLeaf(ARENA, "TIMESTAMPDIFF("),
 				interval,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$5,
-				newLeaf(", "),
+				newLeaf(ARENA, ", "),
 				$7,
-				newLeaf(")")
+				newLeaf(ARENA, ")")
 			);
 			if ($$ == NULL) { YYALOCATION_ERROR; }
 		}
 	}
 	| CONVERT OPENING_ROUND_BRACKET lexeme COMMA LEXEME CLOSING_ROUND_BRACKET
 	{
-		struct ASTNode *correctDataTypeName = newLeaf(getSingleStoreDataType(Dbc, $5));
-		free($5);
+		struct ASTNode *correctDataTypeName = newLeaf(ARENA, getSingleStoreDataType(Dbc, $5));
 
 		// "$3 :> correctDataTypeName"
 		//
-		$$ = allocateNode(3, $3, newLeaf(" :> "), correctDataTypeName);
+		$$ = allocateNode(ARENA, 3, $3, newLeaf(ARENA, " :> "), correctDataTypeName);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| REPEAT OPENING_ROUND_BRACKET lexeme COMMA lexeme CLOSING_ROUND_BRACKET
 	{
 		// "LPAD('', CHAR_LENGTH($3)*$5, $3)"
 		//
-		$$ = allocateNode(7,
-			newLeaf("LPAD('', CHAR_LENGTH("),
+		$$ = allocateNode(ARENA, 7,
+			newLeaf(ARENA, "LPAD('', CHAR_LENGTH("),
 			$3,
-			newLeaf(")*"),
+			newLeaf(ARENA, ")*"),
 			$5,
-			newLeaf(", "),
-			copyTree($3),
-			newLeaf(")")
+			newLeaf(ARENA, ", "),
+			$3,
+			newLeaf(ARENA, ")")
 		);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
@@ -463,32 +447,30 @@ function_call:
 	{
 		// "LPAD('', $3, ' ')"
 		//
-		$$ = allocateNode(3, newLeaf("LPAD('', "), $3, newLeaf(", ' ')"));
+		$$ = allocateNode(ARENA, 3, newLeaf(ARENA, "LPAD('', "), $3, newLeaf(ARENA, ", ' ')"));
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| LEXEME OPENING_ROUND_BRACKET lexemes CLOSING_ROUND_BRACKET
 	{
-		struct ASTNode *lexeme = newLeaf($1);
-		free($1);
+		struct ASTNode *lexeme = newLeaf(ARENA, $1);
 
 		// "$1($3)"
 		//
-		$$ = allocateNode(4,
+		$$ = allocateNode(ARENA, 4,
 			lexeme,
-			newLeaf("("),
+			newLeaf(ARENA, "("),
 			$3,
-			newLeaf(")")
+			newLeaf(ARENA, ")")
 		);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| LEXEME OPENING_ROUND_BRACKET CLOSING_ROUND_BRACKET
 	{
-		struct ASTNode *lexeme = newLeaf($1);
-		free($1);
+		struct ASTNode *lexeme = newLeaf(ARENA, $1);
 
 		// "$1()"
 		//
-		$$ = allocateNode(2, lexeme, newLeaf("()"));
+		$$ = allocateNode(ARENA, 2, lexeme, newLeaf(ARENA, "()"));
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	;
@@ -501,7 +483,7 @@ lexemes : lexeme
 	{
 		// "$1, $2"
 		//
-		$$ = allocateNode(3, $1, newLeaf(", "), $3);
+		$$ = allocateNode(ARENA, 3, $1, newLeaf(ARENA, ", "), $3);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	;
@@ -510,21 +492,19 @@ lexemes : lexeme
 lexeme :
 	STRING_LITERAL
 	{
-		$$ = newLeaf($1);
-		free($1);
+		$$ = newLeaf(ARENA, $1);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| LEXEME
 	{
-		$$ = newLeaf($1);
-		free($1);
+		$$ = newLeaf(ARENA, $1);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| lexeme lexeme
 	{
 		// "$1 $2"
 		//
-		$$ = allocateNode(3, $1, newLeaf(" "), $2);
+		$$ = allocateNode(ARENA, 3, $1, newLeaf(ARENA, " "), $2);
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	| function_call
@@ -535,7 +515,7 @@ lexeme :
 	{
 		// "($2)"
 		//
-		$$ = allocateNode(3, newLeaf("("), $2, newLeaf(")"));
+		$$ = allocateNode(ARENA, 3, newLeaf(ARENA, "("), $2, newLeaf(ARENA, ")"));
 		if ($$ == NULL) { YYALOCATION_ERROR; }
 	}
 	;
@@ -545,49 +525,24 @@ allocation_error:
 	{ YYALOCATION_ERROR; }
 %%
 
-void freeChildren(int childrenCount, va_list children)
-{
-	int i;
-	for (i = 0; i < childrenCount; i++)
-	{
-		struct ASTNode *child = va_arg(children, struct ASTNode*);
-		if (child != NULL) { freeTree(child); }
-	}
-}
-
-struct ASTNode* allocateNode(int childrenCount, ...)
+struct ASTNode* allocateNode(struct ASTArena *arena, int childrenCount, ...)
 {
 	va_list valist;
 	va_start(valist, childrenCount);
-	my_bool children_allocated_successfully = TRUE;
 	int i;
 	for (i = 0; i < childrenCount; i++)
 	{
 		if (va_arg(valist, struct ASTNode*) == NULL)
 		{
-			children_allocated_successfully = FALSE;
+			va_end(valist);
+			return NULL;
 		}
 	}
 	va_end(valist);
 
-	if (!children_allocated_successfully)
-	{
-		va_start(valist, childrenCount);
-		freeChildren(childrenCount, valist);
-		va_end(valist);
-		return NULL;
-	}
-
 	va_start(valist, childrenCount);
-	struct ASTNode *res = newNode(childrenCount, valist);
+	struct ASTNode *res = newNode(arena, childrenCount, valist);
 	va_end(valist);
 
-	if (res == NULL)
-	{
-		va_start(valist, childrenCount);
-		freeChildren(childrenCount, valist);
-		va_end(valist);
-	}
-
 	return res;
 }
\ No newline at end of file
@@ -79,6 +79,7 @@ struct st_mysql_options_extension {
   char *proxy_header;
   size_t proxy_header_len;
   int (*io_wait)(my_socket handle, my_bool is_read, int timeout);
+  my_bool large_pages;
 };
 
 typedef struct st_connection_handler
@@ -24,6 +24,8 @@
 
 void free_rows(MYSQL_DATA *cur);
 int ma_multi_command(MYSQL *mysql, enum enum_multi_status status);
+int ma_skip_rows(MYSQL *mysql, unsigned long long kill_threshold,
+                 mariadb_skip_callback kill_callback, void *arg);
 MYSQL_FIELD * unpack_fields(const MYSQL *mysql, MYSQL_DATA *data,
                             MA_MEM_ROOT *alloc,uint fields,
                             my_bool default_value);
@@ -520,7 +520,14 @@ my_bool set_changeable_var(my_string str,CHANGEABLE_VAR *vars);
 my_bool set_changeable_varval(const char *var, ulong val,
 			      CHANGEABLE_VAR *vars);
 #define ma_alloc_root_inited(A) ((A)->min_malloc != 0)
+/* Flag in the low bit of MA_MEM_ROOT::block_size: blocks of MA_ROOT_LARGE_PAGE_SIZE and bigger are mapped, and backed
+   by huge pages where the system provides them */
+#define MA_ROOT_FLAG_LARGE_PAGES 1
+#define MA_ROOT_LARGE_PAGE_SIZE  (2*1024*1024)
+/* Blocks double with each one allocated, up to this size */
+#define MA_ROOT_MAX_BLOCK_SIZE   (64*1024*1024)
 void ma_init_alloc_root(MA_MEM_ROOT *mem_root, size_t block_size, size_t pre_alloc_size);
+void ma_alloc_root_large_pages(MA_MEM_ROOT *mem_root);
 void *ma_alloc_root(MA_MEM_ROOT *mem_root, size_t Size);
 void ma_free_root(MA_MEM_ROOT *root, myf MyFLAGS);
 char *ma_strdup_root(MA_MEM_ROOT *root,const char *str);
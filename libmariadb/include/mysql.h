@@ -254,7 +254,8 @@ extern const char *SQLSTATE_UNKNOWN;
     MARIADB_OPT_MULTI_STATEMENTS,
     MARIADB_OPT_INTERACTIVE,
     MARIADB_OPT_PROXY_HEADER,
-    MARIADB_OPT_IO_WAIT
+    MARIADB_OPT_IO_WAIT,
+    MARIADB_OPT_LARGE_PAGES         /* buffered results are kept in blocks backed by huge pages */
   };
 
   enum mariadb_value {
@@ -379,6 +380,9 @@ struct st_mysql_options {
     struct st_mariadb_extension *extension;
 } MYSQL;
 
+/* called by mariadb_skip_result, when too much data has been skipped */
+typedef void (*mariadb_skip_callback)(MYSQL *mysql, void *arg);
+
 typedef struct st_mysql_res {
   unsigned long long  row_count;
   unsigned int	field_count, current_field;
@@ -617,6 +621,8 @@ unsigned int STDCALL mysql_get_timeout_value(const MYSQL *mysql);
 unsigned int STDCALL mysql_get_timeout_value_ms(const MYSQL *mysql);
 my_bool STDCALL mariadb_reconnect(MYSQL *mysql);
 int STDCALL mariadb_cancel(MYSQL *mysql);
+int STDCALL mariadb_skip_result(MYSQL *mysql, unsigned long long kill_threshold,
+                                mariadb_skip_callback kill_callback, void *arg);
 void STDCALL mysql_debug(const char *debug);
 unsigned long STDCALL mysql_net_read_packet(MYSQL *mysql);
 unsigned long STDCALL mysql_net_field_length(unsigned char **packet);
@@ -857,6 +863,8 @@ struct st_mariadb_api {
   my_bool (STDCALL *mysql_stmt_more_results)(MYSQL_STMT *stmt);
   int (STDCALL *mariadb_stmt_execute_direct)(MYSQL_STMT *stmt, const char *stmtstr, size_t length);
   int (STDCALL *mysql_reset_connection)(MYSQL *mysql);
+  int (STDCALL *mariadb_skip_result)(MYSQL *mysql, unsigned long long kill_threshold, mariadb_skip_callback kill_callback, void *arg);
+  int (STDCALL *mariadb_stmt_skip_result)(MYSQL_STMT *stmt, unsigned long long kill_threshold, mariadb_skip_callback kill_callback, void *arg);
 };
   
 /* these methods can be overwritten by db plugins */
@@ -20,12 +20,82 @@
 #include <ma_global.h>
 #include <ma_sys.h>
 #include <ma_string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#if defined(MAP_ANONYMOUS) && !(defined(HAVE_purify) && defined(EXTRA_DEBUG))
+#define MA_ROOT_MMAP
+#endif
+#endif
+
+/* Size of the next block. Starts with the root's block size, and doubles
+   with each block allocated, so that a large result takes a few big blocks
+   instead of a lot of small ones */
+static size_t ma_root_next_block_size(MA_MEM_ROOT *mem_root)
+{
+  size_t block_size= mem_root->block_size & ~(size_t)MA_ROOT_FLAG_LARGE_PAGES;
+  unsigned int i;
+
+  for (i= 4; i < mem_root->block_num && block_size < MA_ROOT_MAX_BLOCK_SIZE; i++)
+    block_size= MIN(block_size << 1, MA_ROOT_MAX_BLOCK_SIZE);
+  return block_size;
+}
+
+#ifdef MA_ROOT_MMAP
+/* Mapped blocks are recognized by the size, thus the root has to be flagged
+   before it allocates blocks that big */
+#define ma_root_block_mapped(R, S) \
+  (((R)->block_size & MA_ROOT_FLAG_LARGE_PAGES) && (S) >= MA_ROOT_LARGE_PAGE_SIZE)
+
+static MA_USED_MEM *ma_root_map_block(size_t size)
+{
+  void *block;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  /* reserved 2MB huge pages, if the system has any */
+  block= mmap(NULL, size, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+  if (block != MAP_FAILED)
+    return (MA_USED_MEM *)block;
+#endif
+  block= mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (block == MAP_FAILED)
+    return NULL;
+#ifdef MADV_HUGEPAGE
+  /* otherwise transparent huge pages */
+  madvise(block, size, MADV_HUGEPAGE);
+#endif
+  return (MA_USED_MEM *)block;
+}
+#endif
+
+static MA_USED_MEM *ma_root_alloc_block(MA_MEM_ROOT *mem_root, size_t *size)
+{
+#ifdef MA_ROOT_MMAP
+  if (ma_root_block_mapped(mem_root, *size))
+  {
+    *size= (*size + MA_ROOT_LARGE_PAGE_SIZE - 1) & ~(size_t)(MA_ROOT_LARGE_PAGE_SIZE - 1);
+    return ma_root_map_block(*size);
+  }
+#endif
+  return (MA_USED_MEM *)malloc(*size);
+}
+
+static void ma_root_free_block(MA_MEM_ROOT *mem_root, MA_USED_MEM *block)
+{
+#ifdef MA_ROOT_MMAP
+  if (ma_root_block_mapped(mem_root, block->size))
+  {
+    munmap(block, block->size);
+    return;
+  }
+#endif
+  free(block);
+}
 
 void ma_init_alloc_root(MA_MEM_ROOT *mem_root, size_t block_size, size_t pre_alloc_size)
 {
   mem_root->free= mem_root->used= mem_root->pre_alloc= 0;
   mem_root->min_malloc=32;
-  mem_root->block_size= (block_size-MALLOC_OVERHEAD-sizeof(MA_USED_MEM)+8);
+  mem_root->block_size= (block_size-MALLOC_OVERHEAD-sizeof(MA_USED_MEM)+8) & ~(size_t)MA_ROOT_FLAG_LARGE_PAGES;
   mem_root->error_handler=0;
   mem_root->block_num= 4;
   mem_root->first_block_usage= 0;
@@ -43,6 +113,14 @@ void ma_init_alloc_root(MA_MEM_ROOT *mem_root, size_t block_size, size_t pre_all
 #endif
 }
 
+/* Big blocks of the root are mapped, and backed by huge pages where
+   possible. Has to be called before the root allocates them. Roots of
+   buffered results use that, to lower the TLB pressure on scans over them */
+void ma_alloc_root_large_pages(MA_MEM_ROOT *mem_root)
+{
+  mem_root->block_size|= MA_ROOT_FLAG_LARGE_PAGES;
+}
+
 void * ma_alloc_root(MA_MEM_ROOT *mem_root, size_t Size)
 {
 #if defined(HAVE_purify) && defined(EXTRA_DEBUG)
@@ -85,9 +163,9 @@ void * ma_alloc_root(MA_MEM_ROOT *mem_root, size_t Size)
   if (! next)
   {						/* Time to alloc new block */
     get_size= MAX(Size+ALIGN_SIZE(sizeof(MA_USED_MEM)),
-              (mem_root->block_size & ~1) * (mem_root->block_num >> 2));
+                  ma_root_next_block_size(mem_root));
 
-    if (!(next = (MA_USED_MEM*) malloc(get_size)))
+    if (!(next= ma_root_alloc_block(mem_root, &get_size)))
     {
       if (mem_root->error_handler)
 	(*mem_root->error_handler)();
@@ -126,15 +204,18 @@ void ma_free_root(MA_MEM_ROOT *root, myf MyFlags)
   {
     old=next; next= next->next ;
     if (old != root->pre_alloc)
-      free(old);
+      ma_root_free_block(root, old);
   }
   for (next= root->free ; next ; )
   {
     old=next; next= next->next ;
     if (old != root->pre_alloc)
-      free(old);
+      ma_root_free_block(root, old);
   }
   root->used=root->free=0;
+  /* the next result starts with small blocks again */
+  root->block_num= 4;
+  root->first_block_usage= 0;
   if (root->pre_alloc)
   {
     root->free=root->pre_alloc;
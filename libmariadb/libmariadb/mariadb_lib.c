@@ -577,6 +577,63 @@ void mthd_my_skip_result(MYSQL *mysql)
   return;
 }
 
+/*
+  Reads and discards rows of the current result set up to its EOF, without
+  building MYSQL_ROWS: every packet only passes through the net buffer.
+  If kill_threshold is not zero, kill_callback is called once, as soon as
+  more than kill_threshold bytes have been skipped. The callback is supposed
+  to KILL QUERY over another connection, so the server stops sending rows;
+  the resulting "interrupted" error is then swallowed.
+*/
+int ma_skip_rows(MYSQL *mysql, unsigned long long kill_threshold,
+                 mariadb_skip_callback kill_callback, void *arg)
+{
+  ulong pkt_len;
+  unsigned long long skipped= 0;
+  my_bool killed= 0;
+
+  while ((pkt_len= ma_net_safe_read(mysql)) != packet_error)
+  {
+    uchar *pos= mysql->net.read_pos;
+
+    if (pkt_len < 8 && *pos == 254) /* EOF */
+    {
+      if (pkt_len > 1)
+      {
+        mysql->warning_count= uint2korr(pos + 1);
+        mysql->server_status= uint2korr(pos + 3);
+      }
+      mysql->status= MYSQL_STATUS_READY;
+      return 0;
+    }
+    skipped+= pkt_len;
+    if (kill_threshold && !killed && skipped > kill_threshold && kill_callback)
+    {
+      killed= 1;
+      kill_callback(mysql, arg);
+    }
+  }
+
+  mysql->status= MYSQL_STATUS_READY;
+  if (killed && mysql->net.last_errno == ER_QUERY_INTERRUPTED)
+  {
+    /* the error terminates the whole batch */
+    mysql->server_status&= ~SERVER_MORE_RESULTS_EXIST;
+    CLEAR_CLIENT_ERROR(mysql);
+    return 0;
+  }
+  return 1;
+}
+
+int STDCALL mariadb_skip_result(MYSQL *mysql, unsigned long long kill_threshold,
+                                mariadb_skip_callback kill_callback, void *arg)
+{
+  if (mysql->status != MYSQL_STATUS_GET_RESULT &&
+      mysql->status != MYSQL_STATUS_USE_RESULT)
+    return 0;
+  return ma_skip_rows(mysql, kill_threshold, kill_callback, arg);
+}
+
 void STDCALL
 mysql_free_result(MYSQL_RES *result)
 {
@@ -960,6 +1017,8 @@ MYSQL_DATA *mthd_my_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
     return(0);
   }
   ma_init_alloc_root(&result->alloc,8192,0);	/* Assume rowlength < 8192 */
+  if (mysql->options.extension && mysql->options.extension->large_pages)
+    ma_alloc_root_large_pages(&result->alloc);
   result->alloc.min_malloc=sizeof(MYSQL_ROWS);
   prev_ptr= &result->data;
   result->rows=0;
@@ -3296,6 +3355,9 @@ mysql_optionsv(MYSQL *mysql,enum mysql_option option, ...)
     CHECK_OPT_EXTENSION_SET(&mysql->options);
     mysql->options.extension->io_wait = (int(*)(my_socket, my_bool, int))arg1;
     break;
+  case MARIADB_OPT_LARGE_PAGES:
+    OPT_SET_EXTENDED_VALUE_INT(&mysql->options, large_pages, *(my_bool *)arg1);
+    break;
   default:
     va_end(ap);
     SET_CLIENT_ERROR(mysql, CR_NOT_IMPLEMENTED, SQLSTATE_UNKNOWN, 0);
@@ -3511,6 +3573,9 @@ mysql_get_optionv(MYSQL *mysql, enum mysql_option option, void *arg, ...)
   case MARIADB_OPT_IO_WAIT:
     *((int(**)(my_socket, my_bool, int))arg) = mysql->options.extension ? mysql->options.extension->io_wait : NULL;
     break;
+  case MARIADB_OPT_LARGE_PAGES:
+    *((my_bool *)arg)= mysql->options.extension ? mysql->options.extension->large_pages : 0;
+    break;
   default:
     va_end(ap);
     SET_CLIENT_ERROR(mysql, CR_NOT_IMPLEMENTED, SQLSTATE_UNKNOWN, 0);
@@ -4397,7 +4462,9 @@ struct st_mariadb_api MARIADB_API=
   mysql_stmt_next_result,
   mysql_stmt_more_results,
   mariadb_stmt_execute_direct,
-  mysql_reset_connection
+  mysql_reset_connection,
+  mariadb_skip_result,
+  mariadb_stmt_skip_result
 };
 
 /*
@@ -364,6 +364,27 @@ end:
   stmt->state= MYSQL_STMT_FETCH_DONE;
 }
 
+/* binary protocol counterpart of mariadb_skip_result */
+int STDCALL mariadb_stmt_skip_result(MYSQL_STMT *stmt, unsigned long long kill_threshold,
+                                     mariadb_skip_callback kill_callback, void *arg)
+{
+  int rc;
+
+  /* only the statement, that owns the unbuffered result, may skip it */
+  if (!stmt->mysql || stmt->mysql->status != MYSQL_STATUS_STMT_RESULT ||
+      stmt->cursor_exists ||
+      stmt->state < MYSQL_STMT_WAITING_USE_OR_STORE ||
+      stmt->state >= MYSQL_STMT_FETCH_DONE ||
+      (stmt->state > MYSQL_STMT_WAITING_USE_OR_STORE &&
+       stmt->fetch_row_func != stmt_unbuffered_fetch))
+    return 0;
+
+  rc= ma_skip_rows(stmt->mysql, kill_threshold, kill_callback, arg);
+  stmt->state= MYSQL_STMT_FETCH_DONE;
+  stmt->upsert_status.server_status= stmt->mysql->server_status;
+  return rc;
+}
+
 int mthd_stmt_fetch_to_bind(MYSQL_STMT *stmt, unsigned char *row)
 {
   uint i;
@@ -1616,6 +1637,8 @@ MYSQL_STMT * STDCALL mysql_stmt_init(MYSQL *mysql)
 
   ma_init_alloc_root(&stmt->mem_root, 2048, 2048);
   ma_init_alloc_root(&stmt->result.alloc, 4096, 4096);
+  if (mysql && mysql->options.extension && mysql->options.extension->large_pages)
+    ma_alloc_root_large_pages(&stmt->result.alloc);
   ma_init_alloc_root(&((MADB_STMT_EXTENSION *)stmt->extension)->fields_ma_alloc_root, 2048, 2048);
 
   return(stmt);
@@ -0,0 +1,180 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+#ifdef _WIN32
+# define MADB_THREAD_LOCAL __declspec(thread)
+# define MADB_ATOMIC_ADD(Counter, Value) InterlockedExchangeAdd64((LONGLONG volatile *)&(Counter), (LONGLONG)(Value))
+#else
+# define MADB_THREAD_LOCAL __thread
+# define MADB_ATOMIC_ADD(Counter, Value) __sync_fetch_and_add(&(Counter), (long long)(Value))
+#endif
+
+/* NULL hooks mean libc allocator. Hooks are written only by MADB_SetAllocatorHooks, that is called before the driver
+   allocates anything and before any other thread enters it, thus they are read without synchronization */
+static MADB_AllocatorHooks MADB_Hooks;
+/* Once used, hooks can't be changed anymore - memory, allocated by one allocator, would be freed by another. This only
+   catches the misuse of the single-threaded MADB_SetAllocatorHooks, and does not make it safe to call concurrently */
+static int                 MADB_AllocatorUsed= 0;
+
+static MADB_THREAD_LOCAL MADB_AllocCounters *MADB_AllocScope= NULL;
+
+/* {{{ MADB_CountAllocation */
+static void MADB_CountAllocation(void *Ptr, size_t Size)
+{
+  MADB_AllocCounters *Counters= MADB_AllocScope;
+
+  if (!MADB_AllocatorUsed)
+  {
+    MADB_AllocatorUsed= 1;
+  }
+  if (Ptr != NULL && Counters != NULL && Counters->Enabled)
+  {
+    MADB_ATOMIC_ADD(Counters->Allocations, 1);
+    MADB_ATOMIC_ADD(Counters->Bytes, Size);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_SetAllocatorHooks - exported. Installs application's allocator, or restores the default one if Hooks is
+       NULL. Not thread-safe - has to be called from a single thread before the first SQLAllocHandle. Returns 0 on
+       success, and -1 if some of hooks is missing, or if the driver has already allocated memory. Hooks are not
+       changed on failure */
+int MADB_SetAllocatorHooks(const MADB_AllocatorHooks *Hooks)
+{
+  if (MADB_AllocatorUsed ||
+      (Hooks != NULL &&
+       (Hooks->Malloc == NULL || Hooks->Calloc == NULL || Hooks->Realloc == NULL || Hooks->Free == NULL)))
+  {
+    return -1;
+  }
+  if (Hooks == NULL)
+  {
+    memset(&MADB_Hooks, 0, sizeof(MADB_AllocatorHooks));
+  }
+  else
+  {
+    MADB_Hooks= *Hooks;
+  }
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_Malloc */
+void *MADB_Malloc(size_t Size)
+{
+  void *Ptr= MADB_Hooks.Malloc != NULL ? MADB_Hooks.Malloc(Size, MADB_Hooks.Context) : malloc(Size);
+
+  MADB_CountAllocation(Ptr, Size);
+  return Ptr;
+}
+/* }}} */
+
+/* {{{ MADB_Calloc */
+void *MADB_Calloc(size_t Size)
+{
+  void *Ptr= MADB_Hooks.Calloc != NULL ? MADB_Hooks.Calloc(Size, 1, MADB_Hooks.Context) : calloc(Size, 1);
+
+  MADB_CountAllocation(Ptr, Size);
+  return Ptr;
+}
+/* }}} */
+
+/* {{{ MADB_Realloc - counted as new allocation of Size bytes */
+void *MADB_Realloc(void *Ptr, size_t Size)
+{
+  void *NewPtr= MADB_Hooks.Realloc != NULL ? MADB_Hooks.Realloc(Ptr, Size, MADB_Hooks.Context) : realloc(Ptr, Size);
+
+  MADB_CountAllocation(NewPtr, Size);
+  return NewPtr;
+}
+/* }}} */
+
+/* {{{ MADB_Free */
+void MADB_Free(void *Ptr)
+{
+  MADB_AllocCounters *Counters= MADB_AllocScope;
+
+  if (Ptr == NULL)
+  {
+    return;
+  }
+  /* Counted before the freeing, as counters may be in the freed memory */
+  if (Counters != NULL && Counters->Enabled)
+  {
+    MADB_ATOMIC_ADD(Counters->Frees, 1);
+  }
+  if (MADB_Hooks.Free != NULL)
+  {
+    MADB_Hooks.Free(Ptr, MADB_Hooks.Context);
+  }
+  else
+  {
+    free(Ptr);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_Strndup - copies at most Length bytes of the string, that has to be freed with MADB_FREE */
+char *MADB_Strndup(const char *Str, size_t Length)
+{
+  size_t Len= 0;
+  char  *Copy;
+
+  while (Len < Length && Str[Len] != '\0')
+  {
+    ++Len;
+  }
+  if ((Copy= (char *)MADB_Malloc(Len + 1)) != NULL)
+  {
+    memcpy(Copy, Str, Len);
+    Copy[Len]= '\0';
+  }
+  return Copy;
+}
+/* }}} */
+
+/* {{{ MADB_AllocScopeEnter - returns the scope, that has to be passed to MADB_AllocScopeLeave */
+MADB_AllocCounters *MADB_AllocScopeEnter(MADB_AllocCounters *Counters)
+{
+  MADB_AllocCounters *Previous= MADB_AllocScope;
+
+  MADB_AllocScope= Counters;
+  return Previous;
+}
+/* }}} */
+
+/* {{{ MADB_AllocScopeLeave */
+void MADB_AllocScopeLeave(MADB_AllocCounters *Previous)
+{
+  MADB_AllocScope= Previous;
+}
+/* }}} */
+
+/* {{{ MADB_AllocCountersReset */
+void MADB_AllocCountersReset(MADB_AllocCounters *Counters, int Enabled)
+{
+  Counters->Enabled=     0;
+  Counters->Allocations= 0;
+  Counters->Frees=       0;
+  Counters->Bytes=       0;
+  Counters->Enabled=     Enabled;
+}
+/* }}} */
@@ -0,0 +1,73 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#ifndef _ma_allocator_h_
+#define _ma_allocator_h_
+
+#include <stddef.h>
+
+/* Memory, allocated by the driver itself(i.e. via MADB_ALLOC/MADB_CALLOC/MADB_REALLOC/MADB_STRDUP, and released with
+   MADB_FREE), may be taken from the application's allocator. Hooks are installed with the exported
+   MADB_SetAllocatorHooks. It is not thread-safe, and has to be called from a single thread before the first
+   SQLAllocHandle - hooks are read without synchronization afterwards. Context is passed to each hook as is.
+   Hooks do not cover memory, that the Connector/C allocates with its own malloc - result sets, prepared statement
+   buffers, and the blocks of ma_alloc_root memory roots, including the statement's arena(MADB_StmtArenaInit). The
+   driver may be linked against the shared client library, thus the vendored sources are not patched to use them */
+typedef struct st_madb_allocator_hooks
+{
+  void *(*Malloc)(size_t Size, void *Context);
+  void *(*Calloc)(size_t Count, size_t Size, void *Context);
+  void *(*Realloc)(void *Ptr, size_t Size, void *Context);
+  void  (*Free)(void *Ptr, void *Context);
+  void  *Context;
+} MADB_AllocatorHooks;
+
+/* Driver specific connection attributes. If MADB_ATTR_MEMORY_ACCOUNTING is set to SQL_TRUE, driver counts
+   allocations made on the connection's behalf - while executing, fetching, preparing or getting data on its
+   statements, allocating/freeing them, and connecting. Setting of the attribute resets counters. Counters are read
+   via the SQLULEN attributes below. Bytes is the total size of the allocations, not the amount of memory in use.
+   Same as hooks, counters do not include the client library's memory, i.e. the statement's arena and result buffers */
+#define MADB_ATTR_MEMORY_ACCOUNTING  (SQL_DRIVER_CONN_ATTR_BASE + 0x0100)
+#define MADB_ATTR_MEMORY_ALLOCATIONS (SQL_DRIVER_CONN_ATTR_BASE + 0x0101)
+#define MADB_ATTR_MEMORY_FREES       (SQL_DRIVER_CONN_ATTR_BASE + 0x0102)
+#define MADB_ATTR_MEMORY_BYTES       (SQL_DRIVER_CONN_ATTR_BASE + 0x0103)
+
+typedef struct st_madb_alloc_counters
+{
+  volatile long long Allocations;
+  volatile long long Frees;
+  volatile long long Bytes;
+  volatile int       Enabled;
+} MADB_AllocCounters;
+
+int   MADB_SetAllocatorHooks(const MADB_AllocatorHooks *Hooks);
+
+void *MADB_Malloc(size_t Size);
+void *MADB_Calloc(size_t Size);
+void *MADB_Realloc(void *Ptr, size_t Size);
+void  MADB_Free(void *Ptr);
+char *MADB_Strndup(const char *Str, size_t Length);
+
+/* Allocations of the thread are attributed to the Counters between the Enter and the Leave. Scopes may nest. Frees
+   are charged to the scope, in which they happen, not to the one, that has made the allocation - thus Frees of a
+   connection may include memory, allocated on behalf of another one, or outside of any scope */
+MADB_AllocCounters *MADB_AllocScopeEnter(MADB_AllocCounters *Counters);
+void  MADB_AllocScopeLeave(MADB_AllocCounters *Previous);
+void  MADB_AllocCountersReset(MADB_AllocCounters *Counters, int Enabled);
+
+#endif /* _ma_allocator_h_ */
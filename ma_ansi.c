@@ -262,7 +262,7 @@ SQLRETURN SQL_API SQLExecDirect(SQLHSTMT StatementHandle,
     if (!Stmt)
         ret= SQL_INVALID_HANDLE;
     else
-        ret= Stmt->Methods->ExecDirect(Stmt, (char *)StatementText, TextLength);
+        ret= MADB_AsyncExecDirect(Stmt, (char *)StatementText, TextLength);
 
     MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
 }
@@ -483,6 +483,8 @@ SQLRETURN SQL_API SQLPrepare(SQLHSTMT StatementHandle,
                              SQLINTEGER TextLength)
 {
     MADB_Stmt *Stmt= (MADB_Stmt *)StatementHandle;
+    MADB_AllocCounters *SavedScope;
+    SQLRETURN ret;
 
     if (StatementHandle == SQL_NULL_HSTMT)
     {
@@ -497,7 +499,38 @@ SQLRETURN SQL_API SQLPrepare(SQLHSTMT StatementHandle,
 
     /* Prepare method clears error */
 
-    return Stmt->Methods->Prepare(Stmt, (char *)StatementText, TextLength, FALSE);
+    SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+    ret= Stmt->Methods->Prepare(Stmt, (char *)StatementText, TextLength, FALSE);
+    MADB_AllocScopeLeave(SavedScope);
+
+    return ret;
+}
+/* }}} */
+
+/* {{{ SQLPoolConnect */
+SQLRETURN SQL_API SQLPoolConnect(SQLHDBC hDbc,
+                                 SQLHDBC_INFO_TOKEN hDbcInfoToken,
+                                 SQLCHAR *szConnStrOut,
+                                 SQLSMALLINT cchConnStrOutMax,
+                                 SQLSMALLINT *pcchConnStrOut)
+{
+    MADB_Dbc *Dbc= (MADB_Dbc *)hDbc;
+    SQLRETURN ret;
+
+    if (!Dbc)
+        return SQL_INVALID_HANDLE;
+
+    MADB_CLEAR_ERROR(&Dbc->Error);
+
+    Dbc->IsAnsi= 1;
+
+    MDBUG_C_ENTER(Dbc, "SQLPoolConnect");
+    MDBUG_C_DUMP(Dbc, Dbc, 0x);
+    MDBUG_C_DUMP(Dbc, hDbcInfoToken, 0x);
+
+    ret= MADB_PoolConnect(Dbc, (MADB_DbcInfoToken *)hDbcInfoToken, szConnStrOut, cchConnStrOutMax, pcchConnStrOut);
+
+    MDBUG_C_RETURN(Dbc, ret, &Dbc->Error);
 }
 /* }}} */
 
@@ -590,6 +623,40 @@ SQLRETURN SQL_API SQLSetConnectAttr(SQLHDBC ConnectionHandle,
     return MA_SQLSetConnectAttr(ConnectionHandle, Attribute, ValuePtr, StringLength);
 }
 
+/* {{{ SQLSetConnectAttrForDbcInfo */
+SQLRETURN SQL_API SQLSetConnectAttrForDbcInfo(SQLHDBC_INFO_TOKEN hDbcInfoToken,
+                                              SQLINTEGER Attribute,
+                                              SQLPOINTER Value,
+                                              SQLINTEGER StringLength)
+{
+    return MADB_DbcInfoTokenSetAttr((MADB_DbcInfoToken *)hDbcInfoToken, Attribute, Value, StringLength, FALSE);
+}
+/* }}} */
+
+/* {{{ SQLSetConnectInfo */
+SQLRETURN SQL_API SQLSetConnectInfo(SQLHDBC_INFO_TOKEN TokenHandle,
+                                    SQLCHAR *ServerName,
+                                    SQLSMALLINT NameLength1,
+                                    SQLCHAR *UserName,
+                                    SQLSMALLINT NameLength2,
+                                    SQLCHAR *Authentication,
+                                    SQLSMALLINT NameLength3)
+{
+    return MADB_DbcInfoTokenSetConnectInfo((MADB_DbcInfoToken *)TokenHandle, (char *)ServerName, NameLength1,
+                                           (char *)UserName, NameLength2, (char *)Authentication, NameLength3);
+}
+/* }}} */
+
+/* {{{ SQLSetDriverConnectInfo */
+SQLRETURN SQL_API SQLSetDriverConnectInfo(SQLHDBC_INFO_TOKEN TokenHandle,
+                                          SQLCHAR *InConnectionString,
+                                          SQLSMALLINT StringLength1)
+{
+    return MADB_DbcInfoTokenSetDriverConnectInfo((MADB_DbcInfoToken *)TokenHandle, (char *)InConnectionString,
+                                                 StringLength1);
+}
+/* }}} */
+
 /* {{{ SQLSetConnectOption */
 SQLRETURN SQL_API SQLSetConnectOption(SQLHDBC Hdbc, SQLUSMALLINT Option, SQLULEN Param)
 {
@@ -0,0 +1,511 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include "ma_global.h"
+#include "ma_sys.h"
+#include <ma_odbc.h>
+
+#ifndef MADB_ASYNC_DISABLED
+# include "ma_common.h"
+# include "ma_context.h"
+# ifndef _WIN32
+#  include <poll.h>
+# endif
+#endif
+
+/* {{{ MADB_AsyncEntry - body of the coroutine, or of the synchronous call */
+static void MADB_AsyncEntry(void *Arg)
+{
+  MADB_Stmt    *Stmt= (MADB_Stmt *)Arg;
+  MADB_AsyncOp *Op=   &Stmt->Async;
+
+  switch (Op->Func)
+  {
+  case MADB_ASYNC_EXECUTE:
+    Op->Result= Stmt->Methods->Execute(Stmt, FALSE);
+    break;
+  case MADB_ASYNC_EXECDIRECT:
+    Op->Result= Stmt->Methods->ExecDirect(Stmt, Op->StatementText, Op->TextLength);
+    break;
+  case MADB_ASYNC_FETCHSCROLL:
+    Op->Result= Stmt->Methods->FetchScroll(Stmt, Op->FetchOrientation, Op->FetchOffset);
+    break;
+  default:
+    Op->Result= SQL_ERROR;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_AsyncRunSync */
+static SQLRETURN MADB_AsyncRunSync(MADB_Stmt *Stmt)
+{
+  MADB_AsyncEntry(Stmt);
+  Stmt->Async.Func=          MADB_ASYNC_NONE;
+  Stmt->Async.StatementText= NULL;
+
+  return Stmt->Async.Result;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncTime - monotonic time in milliseconds */
+unsigned long long MADB_AsyncTime()
+{
+#ifdef _WIN32
+  return GetTickCount64();
+#else
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (unsigned long long)Now.tv_sec * 1000 + Now.tv_nsec / 1000000;
+#endif
+}
+/* }}} */
+
+#ifndef MADB_ASYNC_DISABLED
+
+/* {{{ MADB_AsyncSetThread */
+static void MADB_AsyncSetThread(MADB_AsyncOp *Op)
+{
+#ifdef _WIN32
+  Op->Thread= GetCurrentThreadId();
+#else
+  Op->Thread= pthread_self();
+#endif
+}
+/* }}} */
+
+/* {{{ MADB_AsyncIsOwnThread - the operation can be resumed only by the thread, that has started it, since it may hold
+       the connection's lock */
+static my_bool MADB_AsyncIsOwnThread(MADB_AsyncOp *Op)
+{
+#ifdef _WIN32
+  return Op->Thread == GetCurrentThreadId();
+#else
+  return pthread_equal(Op->Thread, pthread_self()) != 0;
+#endif
+}
+/* }}} */
+
+/* {{{ MADB_AsyncBusy - TRUE if an asynchronous operation is suspended on the connection. It holds the connection
+       mid-protocol, and nothing else may be sent over it until it is finished. Calls, that the operation makes itself
+       from inside the coroutine, are not affected */
+my_bool MADB_AsyncBusy(MADB_Dbc *Dbc)
+{
+  struct mysql_async_context *b;
+
+  if (Dbc->AsyncStmt == NULL)
+  {
+    return FALSE;
+  }
+  b= Dbc->mariadb != NULL && Dbc->mariadb->options.extension != NULL ? Dbc->mariadb->options.extension->async_context :
+                                                                        NULL;
+  return b == NULL || !b->active || !MADB_AsyncIsOwnThread(&Dbc->AsyncStmt->Async);
+}
+/* }}} */
+
+/* {{{ MADB_AsyncContext - returns the async context of the connection handle, creating it on first use. NULL means,
+       that the function has to be executed synchronously */
+static struct mysql_async_context *MADB_AsyncContext(MYSQL *Mariadb)
+{
+  size_t StackSize= MADB_ASYNC_STACK_SIZE;
+
+  if (Mariadb->options.extension == NULL || Mariadb->options.extension->async_context == NULL)
+  {
+    mysql_optionsv(Mariadb, MYSQL_OPT_NONBLOCK, &StackSize);
+    if (Mariadb->options.extension == NULL)
+    {
+      return NULL;
+    }
+  }
+  return Mariadb->options.extension->async_context;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncReady - returns the events, that have occurred out of those the coroutine waits for */
+static unsigned int MADB_AsyncReady(MYSQL *Mariadb, MADB_AsyncOp *Op, struct mysql_async_context *b)
+{
+  my_socket    Socket= mysql_get_socket(Mariadb);
+  unsigned int Events= 0;
+#ifdef _WIN32
+  fd_set         Rs, Ws, Es;
+  struct timeval Tv= {0, 0};
+
+  FD_ZERO(&Rs);
+  FD_ZERO(&Ws);
+  FD_ZERO(&Es);
+  if (b->events_to_wait_for & MYSQL_WAIT_READ)
+    FD_SET(Socket, &Rs);
+  if (b->events_to_wait_for & MYSQL_WAIT_WRITE)
+    FD_SET(Socket, &Ws);
+  FD_SET(Socket, &Es);
+  if (select(0, &Rs, &Ws, &Es, &Tv) > 0)
+  {
+    if (FD_ISSET(Socket, &Rs))
+      Events|= MYSQL_WAIT_READ;
+    if (FD_ISSET(Socket, &Ws))
+      Events|= MYSQL_WAIT_WRITE;
+    if (FD_ISSET(Socket, &Es))
+      Events|= b->events_to_wait_for & (MYSQL_WAIT_READ | MYSQL_WAIT_WRITE | MYSQL_WAIT_EXCEPT);
+  }
+#else
+  struct pollfd Pfd;
+
+  Pfd.fd=      Socket;
+  Pfd.events=  0;
+  Pfd.revents= 0;
+  if (b->events_to_wait_for & MYSQL_WAIT_READ)
+    Pfd.events|= POLLIN;
+  if (b->events_to_wait_for & MYSQL_WAIT_WRITE)
+    Pfd.events|= POLLOUT;
+  if (b->events_to_wait_for & MYSQL_WAIT_EXCEPT)
+    Pfd.events|= POLLPRI;
+  if (poll(&Pfd, 1, 0) > 0)
+  {
+    if (Pfd.revents & POLLIN)
+      Events|= MYSQL_WAIT_READ;
+    if (Pfd.revents & POLLOUT)
+      Events|= MYSQL_WAIT_WRITE;
+    if (Pfd.revents & POLLPRI)
+      Events|= MYSQL_WAIT_EXCEPT;
+    /* Let the coroutine find out about the broken connection */
+    if (Pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+      Events|= b->events_to_wait_for & (MYSQL_WAIT_READ | MYSQL_WAIT_WRITE | MYSQL_WAIT_EXCEPT);
+  }
+#endif
+  if (Events == 0 && (b->events_to_wait_for & MYSQL_WAIT_TIMEOUT) &&
+      MADB_AsyncTime() - Op->SuspendedAt >= b->timeout_value)
+  {
+    Events= MYSQL_WAIT_TIMEOUT;
+  }
+  return Events;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncSwitch - spawns the coroutine with Entry, or resumes it, if Entry is NULL and the socket is ready.
+       Returns >0 if the coroutine is suspended, 0 if it has returned, and <0 if it could not run */
+static int MADB_AsyncSwitch(MYSQL *Mariadb, MADB_AsyncOp *Op, void (*Entry)(void *), void *Arg)
+{
+  struct mysql_async_context *b= Mariadb->options.extension->async_context;
+  int                         res;
+
+  if (Entry != NULL)
+  {
+    MADB_AsyncSetThread(Op);
+  }
+  else if ((b->events_occured= MADB_AsyncReady(Mariadb, Op, b)) == 0)
+  {
+    return 1;
+  }
+
+  b->active= 1;
+  res= Entry != NULL ? my_context_spawn(&b->async_context, Entry, Arg) : my_context_continue(&b->async_context);
+  b->active= 0;
+
+  b->suspended= res > 0;
+  if (res > 0)
+  {
+    Op->SuspendedAt= MADB_AsyncTime();
+  }
+  return res;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncDone - finishes the statement's operation, unless the coroutine is suspended */
+static SQLRETURN MADB_AsyncDone(MADB_Stmt *Stmt, int res)
+{
+  MADB_AsyncOp *Op= &Stmt->Async;
+
+  if (res > 0)
+  {
+    return SQL_STILL_EXECUTING;
+  }
+
+  Stmt->Connection->AsyncStmt= NULL;
+  Op->Func= MADB_ASYNC_NONE;
+  MADB_FREE(Op->StatementText);
+
+  if (res < 0)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "Could not resume asynchronous operation", 0);
+  }
+  return Op->Result;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncStart - runs the function as coroutine, if the statement is in asynchronous mode, and synchronously
+       otherwise */
+static SQLRETURN MADB_AsyncStart(MADB_Stmt *Stmt)
+{
+  MADB_Dbc     *Dbc= Stmt->Connection;
+  MADB_AsyncOp *Op=  &Stmt->Async;
+  char         *Text;
+  int           res;
+
+  if (Stmt->Options.AsyncEnable != SQL_ASYNC_ENABLE_ON ||
+      (Op->Func == MADB_ASYNC_EXECDIRECT &&
+       (Op->StatementText == NULL || (Op->TextLength < 0 && Op->TextLength != SQL_NTS))) ||
+      Dbc->mariadb == NULL || mysql_get_socket(Dbc->mariadb) == INVALID_SOCKET ||
+      MADB_AsyncContext(Dbc->mariadb) == NULL)
+  {
+    return MADB_AsyncRunSync(Stmt);
+  }
+
+  /* Text has to stay valid until the operation completes */
+  if (Op->Func == MADB_ASYNC_EXECDIRECT)
+  {
+    if (Op->TextLength == SQL_NTS)
+    {
+      Op->TextLength= (SQLINTEGER)strlen(Op->StatementText);
+    }
+    if ((Text= (char *)MADB_ALLOC((size_t)Op->TextLength + 1)) == NULL)
+    {
+      Op->Func=          MADB_ASYNC_NONE;
+      Op->StatementText= NULL;
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    }
+    memcpy(Text, Op->StatementText, (size_t)Op->TextLength);
+    Text[Op->TextLength]= '\0';
+    Op->StatementText= Text;
+  }
+
+  Dbc->AsyncStmt= Stmt;
+  if ((res= MADB_AsyncSwitch(Dbc->mariadb, Op, MADB_AsyncEntry, Stmt)) < 0)
+  {
+    /* Coroutine could not be spawned */
+    Dbc->AsyncStmt= NULL;
+    MADB_AsyncEntry(Stmt);
+    res= 0;
+  }
+  return MADB_AsyncDone(Stmt, res);
+}
+/* }}} */
+
+/* {{{ MADB_AsyncContinue */
+static SQLRETURN MADB_AsyncContinue(MADB_Stmt *Stmt)
+{
+  return MADB_AsyncDone(Stmt, MADB_AsyncSwitch(Stmt->Connection->mariadb, &Stmt->Async, NULL, NULL));
+}
+/* }}} */
+
+/* {{{ MADB_AsyncEnter - returns SQL_SUCCESS if the function has to be started, SQL_STILL_EXECUTING if its operation is
+       in progress, or error if the function can't be called now */
+static SQLRETURN MADB_AsyncEnter(MADB_Stmt *Stmt, enum enum_madb_async_func Func)
+{
+  if (MADB_ASYNC_IN_PROGRESS(Stmt))
+  {
+    if (Stmt->Async.Func != Func || !MADB_AsyncIsOwnThread(&Stmt->Async))
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
+    }
+    return SQL_STILL_EXECUTING;
+  }
+  if (Stmt->Connection->AsyncStmt != NULL)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY010, "Asynchronous operation is in progress on the connection", 0);
+  }
+  Stmt->Async.Func= Func;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncConnectEntry */
+static void MADB_AsyncConnectEntry(void *Arg)
+{
+  MADB_Dbc *Dbc= (MADB_Dbc *)Arg;
+
+  Dbc->AsyncConnect.Result= Dbc->Methods->ConnectDB(Dbc, Dbc->AsyncConnect.Dsn);
+}
+/* }}} */
+
+/* {{{ MADB_AsyncConnectDone - finishes connecting, unless the coroutine is suspended */
+static SQLRETURN MADB_AsyncConnectDone(MADB_Dbc *Dbc, int res)
+{
+  MADB_AsyncOp *Op= &Dbc->AsyncConnect;
+
+  if (res > 0)
+  {
+    return SQL_STILL_EXECUTING;
+  }
+
+  Op->Func= MADB_ASYNC_NONE;
+  Op->Dsn=  NULL;
+  if (res < 0)
+  {
+    Op->Result= MADB_SetError(&Dbc->Error, MADB_ERR_HY000, "Could not resume asynchronous operation", 0);
+  }
+  /* The coroutine's stack belongs to the connection handle, thus the failed connection is closed only here */
+  if (!SQL_SUCCEEDED(Op->Result) && Dbc->mariadb != NULL)
+  {
+    mysql_close(Dbc->mariadb);
+    Dbc->mariadb= NULL;
+  }
+  return Op->Result;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncConnect - connects with Dsn, asynchronously if SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE is on. Calls
+       following SQL_STILL_EXECUTING resume connecting, and ignore Dsn */
+static SQLRETURN MADB_AsyncConnect(MADB_Dbc *Dbc, MADB_Dsn *Dsn)
+{
+  MADB_AsyncOp *Op= &Dbc->AsyncConnect;
+  int           res;
+
+  if (Op->Func == MADB_ASYNC_CONNECT)
+  {
+    if (!MADB_AsyncIsOwnThread(Op))
+    {
+      return MADB_SetError(&Dbc->Error, MADB_ERR_HY010, NULL, 0);
+    }
+    return MADB_AsyncConnectDone(Dbc, MADB_AsyncSwitch(Dbc->mariadb, Op, NULL, NULL));
+  }
+
+  /* Named pipe can't be polled, browser authentication waits for the user anyway, and the RACE of hosts polls their
+     sockets itself */
+  if (Dbc->AsyncDbcFunctions != SQL_ASYNC_DBC_ENABLE_ON || Dsn->IsNamedPipe || Dsn->IsBrowserAuth ||
+      MADB_HostStrategy(Dsn->HostStrategy) == MADB_HOSTS_RACE || Dbc->mariadb != NULL)
+  {
+    return Dbc->Methods->ConnectDB(Dbc, Dsn);
+  }
+  if ((Dbc->mariadb= mysql_init(NULL)) == NULL)
+  {
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  if (MADB_AsyncContext(Dbc->mariadb) == NULL)
+  {
+    return Dbc->Methods->ConnectDB(Dbc, Dsn);
+  }
+
+  Op->Func= MADB_ASYNC_CONNECT;
+  Op->Dsn=  Dsn;
+  if ((res= MADB_AsyncSwitch(Dbc->mariadb, Op, MADB_AsyncConnectEntry, Dbc)) < 0)
+  {
+    MADB_AsyncConnectEntry(Dbc);
+    res= 0;
+  }
+  return MADB_AsyncConnectDone(Dbc, res);
+}
+/* }}} */
+
+#else
+
+/* Connector/C is linked dynamically, and its coroutine API is not exported - functions are always synchronous */
+static SQLRETURN MADB_AsyncStart(MADB_Stmt *Stmt)
+{
+  return MADB_AsyncRunSync(Stmt);
+}
+
+static SQLRETURN MADB_AsyncContinue(MADB_Stmt *Stmt)
+{
+  return MADB_AsyncRunSync(Stmt);
+}
+
+static SQLRETURN MADB_AsyncEnter(MADB_Stmt *Stmt, enum enum_madb_async_func Func)
+{
+  Stmt->Async.Func= Func;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN MADB_AsyncConnect(MADB_Dbc *Dbc, MADB_Dsn *Dsn)
+{
+  return Dbc->Methods->ConnectDB(Dbc, Dsn);
+}
+
+my_bool MADB_AsyncBusy(MADB_Dbc *Dbc)
+{
+  return FALSE;
+}
+
+#endif
+
+/* {{{ MADB_AsyncConnectDB */
+SQLRETURN MADB_AsyncConnectDB(MADB_Dbc *Dbc, MADB_Dsn *Dsn)
+{
+  MADB_AllocCounters *SavedScope= MADB_AllocScopeEnter(&Dbc->MemCounters);
+  SQLRETURN           ret= MADB_AsyncConnect(Dbc, Dsn);
+
+  MADB_AllocScopeLeave(SavedScope);
+  return ret;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncExecute */
+SQLRETURN MADB_AsyncExecute(MADB_Stmt *Stmt)
+{
+  MADB_AllocCounters *SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+  SQLRETURN           ret= MADB_AsyncEnter(Stmt, MADB_ASYNC_EXECUTE);
+
+  if (ret == SQL_STILL_EXECUTING)
+  {
+    ret= MADB_AsyncContinue(Stmt);
+  }
+  else if (ret == SQL_SUCCESS)
+  {
+    ret= MADB_AsyncStart(Stmt);
+  }
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncExecDirect */
+SQLRETURN MADB_AsyncExecDirect(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER TextLength)
+{
+  MADB_AllocCounters *SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+  SQLRETURN           ret= MADB_AsyncEnter(Stmt, MADB_ASYNC_EXECDIRECT);
+
+  if (ret == SQL_STILL_EXECUTING)
+  {
+    ret= MADB_AsyncContinue(Stmt);
+  }
+  else if (ret == SQL_SUCCESS)
+  {
+    Stmt->Async.StatementText= StatementText;
+    Stmt->Async.TextLength=    TextLength;
+
+    ret= MADB_AsyncStart(Stmt);
+  }
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
+}
+/* }}} */
+
+/* {{{ MADB_AsyncFetchScroll */
+SQLRETURN MADB_AsyncFetchScroll(MADB_Stmt *Stmt, SQLSMALLINT FetchOrientation, SQLLEN FetchOffset)
+{
+  MADB_AllocCounters *SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+  SQLRETURN           ret= MADB_AsyncEnter(Stmt, MADB_ASYNC_FETCHSCROLL);
+
+  if (ret == SQL_STILL_EXECUTING)
+  {
+    ret= MADB_AsyncContinue(Stmt);
+  }
+  else if (ret == SQL_SUCCESS)
+  {
+    Stmt->Async.FetchOrientation= FetchOrientation;
+    Stmt->Async.FetchOffset=      FetchOffset;
+
+    ret= MADB_AsyncStart(Stmt);
+  }
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
+}
+/* }}} */
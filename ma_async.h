@@ -0,0 +1,60 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#ifndef _ma_async_h_
+#define _ma_async_h_
+
+/* Asynchronous execution of statement functions (SQL_ATTR_ASYNC_ENABLE). The function runs as a coroutine on the
+   Connector/C async context of the connection. Whenever network I/O would block, the coroutine yields, and the function
+   returns SQL_STILL_EXECUTING. Each following call of the function resumes the coroutine, if the socket is ready.
+   Connecting (SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE) works the same way */
+#define MADB_ASYNC_STACK_SIZE (256 * 1024)
+
+enum enum_madb_async_func { MADB_ASYNC_NONE= 0, MADB_ASYNC_EXECUTE, MADB_ASYNC_EXECDIRECT, MADB_ASYNC_FETCHSCROLL,
+                            MADB_ASYNC_CONNECT };
+
+typedef struct st_madb_async_op
+{
+  enum enum_madb_async_func Func;     /* Function in progress, MADB_ASYNC_NONE if there is none */
+  SQLRETURN                 Result;
+  char                     *StatementText;
+  SQLINTEGER                TextLength;
+  SQLSMALLINT               FetchOrientation;
+  SQLLEN                    FetchOffset;
+  struct st_madb_dsn       *Dsn;
+  unsigned long long        SuspendedAt; /* ms, for the MYSQL_WAIT_TIMEOUT */
+#ifdef _WIN32
+  DWORD                     Thread;
+#else
+  pthread_t                 Thread;
+#endif
+} MADB_AsyncOp;
+
+#define MADB_ASYNC_IN_PROGRESS(Stmt) ((Stmt)->Async.Func != MADB_ASYNC_NONE)
+/* Any function, that sends anything over the connection, fails with HY010 while an asynchronous operation is suspended */
+#define MADB_CHECK_ASYNC_BUSY(Stmt) if (MADB_AsyncBusy((Stmt)->Connection))\
+  return MADB_SetError(&(Stmt)->Error, MADB_ERR_HY010, NULL, 0)
+
+SQLRETURN MADB_AsyncExecute(MADB_Stmt *Stmt);
+SQLRETURN MADB_AsyncExecDirect(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER TextLength);
+SQLRETURN MADB_AsyncFetchScroll(MADB_Stmt *Stmt, SQLSMALLINT FetchOrientation, SQLLEN FetchOffset);
+SQLRETURN MADB_AsyncConnectDB(MADB_Dbc *Dbc, struct st_madb_dsn *Dsn);
+unsigned long long MADB_AsyncTime();
+my_bool MADB_AsyncBusy(MADB_Dbc *Dbc);
+
+#endif /* _ma_async_h_ */
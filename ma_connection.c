@@ -19,6 +19,7 @@
 *************************************************************************************/
 #include <keywords/keywords.hpp>
 #include <ma_odbc.h>
+#include <odbc_3_api.h>
 
 extern const char* DefaultPluginLocation;
 
@@ -31,6 +32,22 @@ struct st_madb_isolation MADB_IsolationLevel[] =
   {0, 0}
 };
 
+/* {{{ MADB_GetIsolationLevel - returns NULL, if the SQL_ATTR_TXN_ISOLATION value is not supported */
+static struct st_madb_isolation *MADB_GetIsolationLevel(SQLLEN SqlIsolation)
+{
+  unsigned int i;
+
+  for (i= 0; MADB_IsolationLevel[i].StrIsolation != NULL; ++i)
+  {
+    if (MADB_IsolationLevel[i].SqlIsolation == SqlIsolation)
+    {
+      return &MADB_IsolationLevel[i];
+    }
+  }
+  return NULL;
+}
+/* }}} */
+
 /* used by SQLGetFunctions */
 SQLUSMALLINT MADB_supported_api[]=
 {
@@ -115,6 +132,7 @@ SQLUSMALLINT MADB_supported_api[]=
 
 
 struct st_ma_connection_methods MADB_Dbc_Methods; /* declared at the end of file */
+static SQLRETURN MADB_DbcResetSession(MADB_Dbc *Dbc);
 
 extern Client_Charset utf8;
 #define CHARSET_PTR(isWChar, Dbc) isWChar ? (Dbc->Charset.cs_info ? &Dbc->Charset : &utf8 ): NULL
@@ -136,6 +154,99 @@ my_bool CheckConnection(MADB_Dbc *Dbc)
   return TRUE;
 }
 
+/* {{{ MADB_DbcSetAccessMode - SQL_MODE_READ_ONLY connection goes to READ_SERVER hosts, if the DSN has them. Switching
+       the mode of the established connection reconnects it to the other hosts. That can be done only while the
+       connection has no transaction open, and no statement prepared */
+static SQLRETURN MADB_DbcSetAccessMode(MADB_Dbc *Dbc, SQLINTEGER Mode)
+{
+  MYSQL      *Old= Dbc->mariadb;
+  SQLINTEGER  OldMode= Dbc->AccessMode, OldIsolation= Dbc->SessionTxnIsolation;
+  my_bool     OldAutoCommit= Dbc->SessionAutoCommit;
+  MADB_List  *Item;
+  MADB_Stmt  *Stmt;
+  SQLRETURN   ret;
+
+  if (Mode != SQL_MODE_READ_WRITE && Mode != SQL_MODE_READ_ONLY)
+  {
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
+  }
+  /* Before connect the mode is only recorded, and connect picks hosts by it */
+  if (Old == NULL)
+  {
+    Dbc->AccessMode= Mode;
+    return SQL_SUCCESS;
+  }
+  if (Dbc->Dsn == NULL || MADB_IS_EMPTY(Dbc->Dsn->ReadServer) || Dbc->Dsn->Socket || Dbc->Dsn->IsNamedPipe)
+  {
+    Dbc->AccessMode= SQL_MODE_READ_WRITE;
+    if (Mode != SQL_MODE_READ_WRITE)
+    {
+      return MADB_SetError(&Dbc->Error, MADB_ERR_01S02, NULL, 0);
+    }
+    return SQL_SUCCESS;
+  }
+  if (Mode == Dbc->AccessMode)
+  {
+    return SQL_SUCCESS;
+  }
+
+  LOCK_MARIADB(Dbc);
+  EnterCriticalSection(&Dbc->ListsCs);
+  for (Item= Dbc->Stmts; Item != NULL; Item= Item->next)
+  {
+    if (((MADB_Stmt *)Item->data)->State != MADB_SS_INITED)
+    {
+      break;
+    }
+  }
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  if (Item != NULL || Dbc->AsyncStmt != NULL || (Old->server_status & SERVER_STATUS_IN_TRANS))
+  {
+    UNLOCK_MARIADB(Dbc);
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY011, NULL, 0);
+  }
+
+  /* Cached server-side statements belong to the old connection */
+  MADB_StmtCacheFree(Dbc);
+  Dbc->mariadb=    NULL;
+  Dbc->AccessMode= Mode;
+  if (!SQL_SUCCEEDED(ret= Dbc->Methods->ConnectDB(Dbc, Dbc->Dsn)))
+  {
+    Dbc->mariadb=             Old;
+    Dbc->AccessMode=          OldMode;
+    Dbc->SessionTxnIsolation= OldIsolation;
+    Dbc->SessionAutoCommit=   OldAutoCommit;
+    UNLOCK_MARIADB(Dbc);
+    return ret;
+  }
+
+  /* Handles of statements are bound to the connection, they have been created on */
+  EnterCriticalSection(&Dbc->ListsCs);
+  for (Item= Dbc->Stmts; Item != NULL; Item= Item->next)
+  {
+    Stmt= (MADB_Stmt *)Item->data;
+    if (Stmt->stmt != NULL)
+    {
+      MADB_STMT_CLOSE_STMT(Stmt);
+    }
+    Stmt->stmt= MADB_NewStmtHandle(Stmt);
+  }
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  /* Session continues in the database, the application has switched to */
+  if (Old->db != NULL && (Dbc->mariadb->db == NULL || strcmp(Old->db, Dbc->mariadb->db) != 0) &&
+      mysql_select_db(Dbc->mariadb, Old->db))
+  {
+    MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+  }
+  mysql_close(Old);
+  UNLOCK_MARIADB(Dbc);
+
+  return Dbc->Error.ReturnValue;
+}
+/* }}} */
+
 /* {{{ MADB_DbcSetAttr */
 SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValuePtr, SQLINTEGER StringLength, my_bool isWChar)
 {
@@ -150,12 +261,16 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     return SQL_SUCCESS;
   } 
 
+  /* These are applied on the server right away */
+  if ((Attribute == SQL_ATTR_ACCESS_MODE || Attribute == SQL_ATTR_AUTOCOMMIT || Attribute == SQL_ATTR_CURRENT_CATALOG ||
+       Attribute == SQL_ATTR_RESET_CONNECTION || Attribute == SQL_ATTR_DBC_INFO_TOKEN) && MADB_AsyncBusy(Dbc))
+  {
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY010, NULL, 0);
+  }
+
   switch(Attribute) {
   case SQL_ATTR_ACCESS_MODE:
-    if ((SQLPOINTER)SQL_MODE_READ_WRITE != ValuePtr)
-      MADB_SetError(&Dbc->Error, MADB_ERR_01S02, NULL, 0);
-    Dbc->AccessMode= SQL_MODE_READ_WRITE;
-    break;
+    return MADB_DbcSetAccessMode(Dbc, (SQLINTEGER)(SQLLEN)ValuePtr);
 #if (ODBCVER >= 0x0351)
   case SQL_ATTR_ANSI_APP:
     if (ValuePtr != NULL)
@@ -171,10 +286,33 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     break;
 #endif
   case SQL_ATTR_ASYNC_ENABLE:
+#ifndef MADB_ASYNC_DISABLED
+    /* Statement level asynchronous mode - the value is default for statements, allocated afterwards */
+    if ((SQLPOINTER)SQL_ASYNC_ENABLE_OFF != ValuePtr && (SQLPOINTER)SQL_ASYNC_ENABLE_ON != ValuePtr)
+    {
+      return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Dbc->AsyncEnable= (SQLULEN)ValuePtr;
+#else
      if ((SQLPOINTER)SQL_ASYNC_ENABLE_OFF != ValuePtr)
       MADB_SetError(&Dbc->Error, MADB_ERR_01S02, NULL, 0);
      Dbc->AsyncEnable= SQL_ASYNC_ENABLE_OFF;
+#endif
+    break;
+#ifdef SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE
+  case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+#ifndef MADB_ASYNC_DISABLED
+    if ((SQLPOINTER)SQL_ASYNC_DBC_ENABLE_OFF != ValuePtr && (SQLPOINTER)SQL_ASYNC_DBC_ENABLE_ON != ValuePtr)
+    {
+      return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Dbc->AsyncDbcFunctions= (SQLUINTEGER)(SQLULEN)ValuePtr;
+#else
+    if ((SQLPOINTER)SQL_ASYNC_DBC_ENABLE_OFF != ValuePtr)
+      MADB_SetError(&Dbc->Error, MADB_ERR_01S02, NULL, 0);
+#endif
     break;
+#endif
   case SQL_ATTR_AUTO_IPD:
     /* read only */
     MADB_SetError(&Dbc->Error, MADB_ERR_HY092, NULL, 0);
@@ -183,15 +321,23 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     {
       SQLULEN ValidAttrs[]= {2, SQL_AUTOCOMMIT_ON, SQL_AUTOCOMMIT_OFF};
       MADB_CHECK_ATTRIBUTE(Dbc, ValuePtr, ValidAttrs);
-      /* if a connection is open, try to apply setting to the connection */
       if (Dbc->mariadb)
       {
         if (Dbc->EnlistInDtc) {
           return MADB_SetError(&Dbc->Error, MADB_ERR_25000, NULL, 0);
         }
-        if (mysql_autocommit(Dbc->mariadb, (my_bool)(size_t)ValuePtr))
+        /* Switching autocommit on commits the open transaction, that can't wait for the next statement. Otherwise the
+           change is sent together with other pending session changes before the next statement, if it's needed then */
+        if ((SQLULEN)ValuePtr == SQL_AUTOCOMMIT_ON && (Dbc->mariadb->server_status & SERVER_STATUS_IN_TRANS))
         {
-          return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
+          LOCK_MARIADB(Dbc);
+          if (mysql_autocommit(Dbc->mariadb, TRUE))
+          {
+            UNLOCK_MARIADB(Dbc);
+            return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
+          }
+          Dbc->SessionAutoCommit= TRUE;
+          UNLOCK_MARIADB(Dbc);
         }
       }
       Dbc->AutoCommit= (SQLUINTEGER)(SQLULEN)ValuePtr;
@@ -200,6 +346,42 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
   case SQL_ATTR_CONNECTION_DEAD:
     /* read only! */
     return MADB_SetError(&Dbc->Error, MADB_ERR_HY092, NULL, 0);
+  case SQL_ATTR_RESET_CONNECTION:
+    /* DM returns connection to its pool - attributes go back to their defaults */
+    if ((SQLULEN)ValuePtr != SQL_RESET_CONNECTION_YES)
+    {
+      return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Dbc->AutoCommit= SQL_AUTOCOMMIT_ON;
+    Dbc->TxnIsolation= 0;
+    MADB_FREE(Dbc->CatalogName);
+    if (Dbc->AccessMode != SQL_MODE_READ_WRITE && !SQL_SUCCEEDED(MADB_DbcSetAccessMode(Dbc, SQL_MODE_READ_WRITE)))
+    {
+      return Dbc->Error.ReturnValue;
+    }
+    return MADB_DbcResetSession(Dbc);
+  case SQL_ATTR_DBC_INFO_TOKEN:
+    {
+      /* Pooled connection is reused for the request the token describes */
+      MADB_DbcInfoToken *Token= (MADB_DbcInfoToken *)ValuePtr;
+
+      if (Token == NULL)
+      {
+        return MADB_SetError(&Dbc->Error, MADB_ERR_HY009, NULL, 0);
+      }
+      Dbc->AutoCommit= Token->AutoCommit;
+      Dbc->TxnIsolation= Token->TxnIsolation;
+      MADB_FREE(Dbc->CatalogName);
+      if (Token->CatalogName != NULL && (Dbc->CatalogName= MADB_STRDUP(Token->CatalogName)) == NULL)
+      {
+        return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
+      }
+      if (Token->AccessMode != Dbc->AccessMode && !SQL_SUCCEEDED(MADB_DbcSetAccessMode(Dbc, Token->AccessMode)))
+      {
+        return Dbc->Error.ReturnValue;
+      }
+      return MADB_DbcResetSession(Dbc);
+    }
   case SQL_ATTR_CURRENT_CATALOG:
     {
       MADB_FREE(Dbc->CatalogName);
@@ -210,12 +392,15 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
       }
       else {
           ADJUST_LENGTH(ValuePtr, StringLength);
-          Dbc->CatalogName= strndup((char *)ValuePtr, StringLength);
+          Dbc->CatalogName= MADB_STRNDUP((char *)ValuePtr, StringLength);
       }
-      if (Dbc->mariadb &&
-          mysql_select_db(Dbc->mariadb, Dbc->CatalogName))
+      if (Dbc->mariadb)
       {
-        return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
+        if (mysql_select_db(Dbc->mariadb, Dbc->CatalogName))
+        {
+          return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
+        }
+        Dbc->CurrentDbUnknown= FALSE;
       }
     }
     break;
@@ -257,35 +442,16 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
   case SQL_ATTR_TRANSLATE_OPTION:
     break;
   case SQL_ATTR_TXN_ISOLATION:
-    if (Dbc->mariadb)
+    /* The level is set on the server before the next statement, thus has to be checked now, connected or not */
+    if (MADB_GetIsolationLevel((SQLLEN)ValuePtr) == NULL)
     {
-      my_bool ValidTx= FALSE;
-      unsigned int i;
-      for (i=0; i < 4; i++)
-      {
-        if (MADB_IsolationLevel[i].SqlIsolation == (SQLLEN)ValuePtr)
-        {
-          char StmtStr[128];
-          _snprintf(StmtStr, sizeof(StmtStr), "SET SESSION TRANSACTION ISOLATION LEVEL %s",
-                      MADB_IsolationLevel[i].StrIsolation);
-          LOCK_MARIADB(Dbc);
-          if (mysql_query(Dbc->mariadb, StmtStr))
-          {
-            UNLOCK_MARIADB(Dbc);
-            return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
-          }
-          UNLOCK_MARIADB(Dbc);
-          ValidTx= TRUE;
-          break;
-        }
-      }
-      if (!ValidTx)
-      {
-        return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
-      }
+      return MADB_SetError(&Dbc->Error, MADB_ERR_HY024, NULL, 0);
     }
     Dbc->TxnIsolation= (SQLINTEGER)(SQLLEN)ValuePtr;
     break;
+  case MADB_ATTR_MEMORY_ACCOUNTING:
+    MADB_AllocCountersReset(&Dbc->MemCounters, (SQLULEN)ValuePtr == SQL_TRUE);
+    break;
   default:
     break;
   }
@@ -311,11 +477,16 @@ SQLRETURN MADB_DbcGetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
 
   switch(Attribute) {
   case SQL_ATTR_ACCESS_MODE:
-    *(SQLUINTEGER *)ValuePtr= SQL_MODE_READ_WRITE;
+    *(SQLUINTEGER *)ValuePtr= Dbc->AccessMode;
     break;
   case SQL_ATTR_ASYNC_ENABLE:
-    *(SQLULEN *)ValuePtr= SQL_ASYNC_ENABLE_OFF;
+    *(SQLULEN *)ValuePtr= Dbc->AsyncEnable;
     break;
+#ifdef SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE
+  case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+    *(SQLUINTEGER *)ValuePtr= Dbc->AsyncDbcFunctions;
+    break;
+#endif
   case SQL_ATTR_AUTO_IPD:
     *(SQLUINTEGER *)ValuePtr= SQL_FALSE;
     break;
@@ -323,13 +494,27 @@ SQLRETURN MADB_DbcGetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     *(SQLUINTEGER *)ValuePtr= Dbc->AutoCommit;
     break;
   case SQL_ATTR_CONNECTION_DEAD:
+  {
+    /* Connection pools check connections with this attribute - ping latency is fed to the host statistics */
+    unsigned long long Start= MADB_HostTime();
+
     /* ping may fail if status isn't ready, so we need to check errors */
     if (mysql_ping(Dbc->mariadb))
+    {
       *(SQLUINTEGER *)ValuePtr= (mysql_errno(Dbc->mariadb) == CR_SERVER_GONE_ERROR ||
                                  mysql_errno(Dbc->mariadb) == CR_SERVER_LOST) ? SQL_CD_TRUE : SQL_CD_FALSE;
+      if (*(SQLUINTEGER *)ValuePtr == SQL_CD_TRUE)
+      {
+        MADB_HostFailure(Dbc->mariadb->host, Dbc->mariadb->port);
+      }
+    }
     else
+    {
       *(SQLUINTEGER *)ValuePtr= SQL_CD_FALSE;
+      MADB_HostSuccess(Dbc->mariadb->host, Dbc->mariadb->port, MADB_HostTime() - Start);
+    }
     break;
+  }
   case SQL_ATTR_CURRENT_CATALOG:
   {
     SQLSMALLINT StrLen;
@@ -423,6 +608,18 @@ SQLRETURN MADB_DbcGetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     else 
       *(SQLULEN *)ValuePtr= Dbc->TxnIsolation;
     break;
+  case MADB_ATTR_MEMORY_ACCOUNTING:
+    *(SQLULEN *)ValuePtr= Dbc->MemCounters.Enabled ? SQL_TRUE : SQL_FALSE;
+    break;
+  case MADB_ATTR_MEMORY_ALLOCATIONS:
+    *(SQLULEN *)ValuePtr= (SQLULEN)Dbc->MemCounters.Allocations;
+    break;
+  case MADB_ATTR_MEMORY_FREES:
+    *(SQLULEN *)ValuePtr= (SQLULEN)Dbc->MemCounters.Frees;
+    break;
+  case MADB_ATTR_MEMORY_BYTES:
+    *(SQLULEN *)ValuePtr= (SQLULEN)Dbc->MemCounters.Bytes;
+    break;
 
   default:
     MADB_SetError(&Dbc->Error, MADB_ERR_HYC00, NULL, 0);
@@ -464,7 +661,7 @@ MADB_Dbc *MADB_DbcInit(MADB_Env *Env)
   return Connection;      
 cleanup:
   if (Connection)
-    free(Connection);
+    MADB_FREE(Connection);
   else
     MADB_SetError(&Env->Error, MADB_ERR_HY001, NULL, 0);
 
@@ -487,6 +684,8 @@ SQLRETURN MADB_DbcFree(MADB_Dbc *Connection)
   /* TODO: If somebody uses connection it won't help if lock it here. At least it requires
            more fingers movements
     LOCK_MARIADB(Dbc);*/
+  MADB_StmtCacheFree(Connection);
+  Connection->AsyncStmt= NULL;
   if (Connection->mariadb)
   {
     mysql_close(Connection->mariadb);
@@ -501,50 +700,90 @@ SQLRETURN MADB_DbcFree(MADB_Dbc *Connection)
   LeaveCriticalSection(&Env->cs);
 
   MADB_FREE(Connection->CatalogName);
+  MADB_ParseCacheFree(Connection);
+  MADB_StmtFreeListClear(Connection);
   CloseClientCharset(&Connection->Charset);
   MADB_FREE(Connection->DataBase);
   MADB_DSN_Free(Connection->Dsn);
   DeleteCriticalSection(&Connection->cs);
 
-  free(Connection);
+  MADB_FREE(Connection);
   return SQL_SUCCESS;
 }
 /* }}} */
 
-/* {{{ MADB_Dbc_GetCurrentDB */
-SQLRETURN MADB_Dbc_GetCurrentDB(MADB_Dbc *Connection, SQLPOINTER CurrentDB, SQLINTEGER CurrentDBLength, 
-                                SQLSMALLINT *StringLengthPtr, my_bool isWChar) 
+/* {{{ MADB_DbcReadCurrentDB - queries the current database, and stores it where connector tracks it */
+static SQLRETURN MADB_DbcReadCurrentDB(MADB_Dbc *Connection)
 {
   MADB_Stmt *Stmt;
   SQLRETURN ret;
   SQLLEN Size;
-  char Buffer[65 * sizeof(SQLWCHAR)];
+  char Buffer[NAME_CHAR_LEN * 4 + 1];
 
-  MADB_CLEAR_ERROR(&Connection->Error);
   ret= MA_SQLAllocHandle(SQL_HANDLE_STMT, (SQLHANDLE) Connection, (SQLHANDLE*)&Stmt);
   if (!SQL_SUCCEEDED(ret))
     return ret;
 
-  // Currently we have to check if DATABASE() != '' because SingleStore returns an empty string (rather than NULL)
-  // for a connection with no database.
-  char* currentDbQuery = "SELECT IF(DATABASE() IS NOT NULL AND DATABASE() != '',DATABASE(),'null')";
-  if (!SQL_SUCCEEDED(Stmt->Methods->ExecDirect(Stmt, currentDbQuery, SQL_NTS)) ||
-      !SQL_SUCCEEDED(Stmt->Methods->Fetch(Stmt)))
+  if (!SQL_SUCCEEDED(Stmt->Methods->ExecDirect(Stmt, "SELECT DATABASE()", SQL_NTS)) ||
+      !SQL_SUCCEEDED(Stmt->Methods->Fetch(Stmt)) ||
+      !SQL_SUCCEEDED(Stmt->Methods->GetData(Stmt, 1, SQL_CHAR, Buffer, sizeof(Buffer), &Size, TRUE)))
   {
     MADB_CopyError(&Connection->Error, &Stmt->Error);
     goto end;
   }
-  
-  ret= Stmt->Methods->GetData(Stmt, 1, SQL_CHAR, Buffer, 65, &Size, TRUE);
 
+  /* Owned by the client library, thus libc allocator is used for it */
+  free(Connection->mariadb->db);
+  Connection->mariadb->db= NULL;
+  if (Size != SQL_NULL_DATA && (Connection->mariadb->db= strdup(Buffer)) == NULL)
+  {
+    MADB_SetError(&Connection->Error, MADB_ERR_HY001, NULL, 0);
+    goto end;
+  }
+  Connection->CurrentDbUnknown= FALSE;
+
+end:
+  MA_SQLFreeStmt(Stmt, SQL_DROP);
+  return Connection->Error.ReturnValue;
+}
+/* }}} */
+
+/* {{{ MADB_Dbc_GetCurrentDB - current database is kept by connector - set on connect and by mysql_select_db, and updated
+       from the session state changes, server reports in OK packets. It is queried only if the server doesn't track it */
+SQLRETURN MADB_Dbc_GetCurrentDB(MADB_Dbc *Connection, SQLPOINTER CurrentDB, SQLINTEGER CurrentDBLength, 
+                                SQLSMALLINT *StringLengthPtr, my_bool isWChar) 
+{
+  const char *Db;
+  SQLLEN Size;
+
+  MADB_CLEAR_ERROR(&Connection->Error);
+  if (!CheckConnection(Connection))
+  {
+    return MADB_SetError(&Connection->Error, MADB_ERR_08003, NULL, 0);
+  }
+  if (Connection->CurrentDbUnknown && MADB_AsyncBusy(Connection))
+  {
+    return MADB_SetError(&Connection->Error, MADB_ERR_HY010, NULL, 0);
+  }
+
+  /* Other thread's query may change it meanwhile */
+  LOCK_MARIADB(Connection);
+  if (Connection->CurrentDbUnknown && !SQL_SUCCEEDED(MADB_DbcReadCurrentDB(Connection)))
+  {
+    UNLOCK_MARIADB(Connection);
+    return Connection->Error.ReturnValue;
+  }
+
+  // SingleStore reports an empty string (rather than NULL) for a connection with no database.
+  Db= MADB_IS_EMPTY(Connection->mariadb->db) ? "null" : Connection->mariadb->db;
   Size= (SQLSMALLINT)MADB_SetString(isWChar ? & Connection->Charset : 0, 
-                                     (void *)CurrentDB, BUFFER_CHAR_LEN(CurrentDBLength, isWChar), Buffer,
+                                     (void *)CurrentDB, BUFFER_CHAR_LEN(CurrentDBLength, isWChar), Db,
                                      SQL_NTS, &Connection->Error);
+  UNLOCK_MARIADB(Connection);
+
   if (StringLengthPtr)
     *StringLengthPtr= isWChar ? (SQLSMALLINT)Size * sizeof(SQLWCHAR) : (SQLSMALLINT)Size;
-  
-end:
-  MA_SQLFreeStmt(Stmt, SQL_DROP);
+
   return Connection->Error.ReturnValue;
 }
 /* }}} */
@@ -555,6 +794,8 @@ SQLRETURN MADB_DbcEndTran(MADB_Dbc *Dbc, SQLSMALLINT CompletionType)
   MADB_CLEAR_ERROR(&Dbc->Error);
   if (!Dbc)
     return SQL_INVALID_HANDLE;
+  if (MADB_AsyncBusy(Dbc))
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY010, NULL, 0);
 
   LOCK_MARIADB(Dbc);
   switch (CompletionType) {
@@ -575,125 +816,441 @@ SQLRETURN MADB_DbcEndTran(MADB_Dbc *Dbc, SQLSMALLINT CompletionType)
 }
 /* }}} */
 
-/* {{{ MADB_Dbc_ConnectDB
-       Mind that this function is used for establishing connection from the setup lib
-*/
-SQLRETURN MADB_DbcConnectDB(MADB_Dbc *Connection,
-    MADB_Dsn *Dsn)
+/* Control connections, KILL is sent over. They are kept in the environment, and reused by all its connections to the
+   same server and user */
+typedef struct st_madb_kill_conn
 {
-  char StmtStr[128];
-  unsigned ReportDataTruncation= 1;
-  unsigned int i;
-  unsigned long client_flags= 0L;
-  my_bool my_reconnect= 1;
-  
-  if (!Connection || !Dsn)
-    return SQL_ERROR;
+  MADB_List ListItem;
+  MYSQL    *Mariadb;
+  char     *Key;
+  time_t    LastUsed;
+} MADB_KillConn;
 
-  MADB_CLEAR_ERROR(&Connection->Error);
+#define MADB_KILL_CONN_IDLE_CHECK 30 /* Seconds idle, after which control connection is pinged before use */
+#define MADB_KILL_CONN_MAX_IDLE   8  /* Max number of control connections kept by environment */
 
-  if (Connection->mariadb == NULL)
+/* {{{ MADB_KillConnFree */
+static void MADB_KillConnFree(MADB_KillConn *Kill)
+{
+  mysql_close(Kill->Mariadb);
+  MADB_FREE(Kill->Key);
+  MADB_FREE(Kill);
+}
+/* }}} */
+
+/* {{{ MADB_KillConnGet - takes idle control connection for the key from the environment, or establishes the new one.
+       The connection is used by one thread at a time, and has to be returned with MADB_KillConnPut */
+static MADB_KillConn *MADB_KillConnGet(MADB_Dbc *Dbc, const char *Key, my_bool Reuse)
+{
+  MADB_Env      *Env= Dbc->Environment;
+  MYSQL         *MariaDb= Dbc->mariadb;
+  MADB_List     *Item;
+  MADB_KillConn *Kill= NULL;
+
+  if (Reuse && Env != NULL)
   {
-    if (!(Connection->mariadb= mysql_init(NULL)))
+    EnterCriticalSection(&Env->cs);
+    for (Item= Env->KillConns; Item != NULL; Item= Item->next)
     {
-      MADB_SetError(&Connection->Error, MADB_ERR_HY001, NULL, 0);
-      goto end;
+      if (strcmp(((MADB_KillConn *)Item->data)->Key, Key) == 0)
+      {
+        Kill= (MADB_KillConn *)Item->data;
+        Env->KillConns= MADB_ListDelete(Env->KillConns, Item);
+        break;
+      }
+    }
+    LeaveCriticalSection(&Env->cs);
+
+    /* Server could have closed it by wait_timeout meanwhile */
+    if (Kill != NULL && time(NULL) - Kill->LastUsed > MADB_KILL_CONN_IDLE_CHECK && mysql_ping(Kill->Mariadb))
+    {
+      MADB_KillConnFree(Kill);
+      Kill= NULL;
+    }
+    if (Kill != NULL)
+    {
+      return Kill;
     }
   }
 
-  if( !MADB_IS_EMPTY(Dsn->ConnCPluginsDir))
+  if ((Kill= (MADB_KillConn *)MADB_CALLOC(sizeof(MADB_KillConn))) == NULL)
   {
-    mysql_optionsv(Connection->mariadb, MYSQL_PLUGIN_DIR, Dsn->ConnCPluginsDir);
+    return NULL;
   }
-  else
+  if ((Kill->Key= MADB_STRDUP(Key)) == NULL || (Kill->Mariadb= mysql_init(NULL)) == NULL ||
+      !mysql_real_connect(Kill->Mariadb, MariaDb->host, MariaDb->user, MariaDb->passwd,
+                          "", MariaDb->port, MariaDb->unix_socket, 0))
   {
-    if (DefaultPluginLocation != NULL)
+    if (Kill->Mariadb != NULL)
     {
-      mysql_optionsv(Connection->mariadb, MYSQL_PLUGIN_DIR, DefaultPluginLocation);
+      mysql_close(Kill->Mariadb);
     }
+    MADB_FREE(Kill->Key);
+    MADB_FREE(Kill);
+    return NULL;
   }
+  Kill->ListItem.data= (void *)Kill;
 
-  if (Dsn->ReadMycnf != '\0')
+  return Kill;
+}
+/* }}} */
+
+/* {{{ MADB_KillConnPut - returns control connection to the environment for reuse */
+static void MADB_KillConnPut(MADB_Dbc *Dbc, MADB_KillConn *Kill)
+{
+  MADB_Env *Env= Dbc->Environment;
+
+  if (Env != NULL)
   {
-    mysql_optionsv(Connection->mariadb, MYSQL_READ_DEFAULT_GROUP, (void *)"odbc");
+    EnterCriticalSection(&Env->cs);
+    if (MADB_ListLength(Env->KillConns) < MADB_KILL_CONN_MAX_IDLE)
+    {
+      Kill->LastUsed= time(NULL);
+      Env->KillConns= MADB_ListAdd(Env->KillConns, &Kill->ListItem);
+      Kill= NULL;
+    }
+    LeaveCriticalSection(&Env->cs);
   }
-  /* If a client character set was specified in DSN, we will always use it.
-     Otherwise for ANSI applications we will use the current character set,
-     for unicode connections we use utf8
-  */
+  if (Kill != NULL)
   {
-    const char* cs_name= NULL;
+    MADB_KillConnFree(Kill);
+  }
+}
+/* }}} */
 
-    if (!MADB_IS_EMPTY(Dsn->CharacterSet))
+/* {{{ MADB_KillConnsFree - closes control connections of the environment */
+void MADB_KillConnsFree(MADB_Env *Env)
+{
+  while (Env->KillConns != NULL)
+  {
+    MADB_KillConn *Kill= (MADB_KillConn *)Env->KillConns->data;
+
+    Env->KillConns= MADB_ListDelete(Env->KillConns, Env->KillConns);
+    MADB_KillConnFree(Kill);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_DbcKillQuery - kills the query currently running on the connection. The connection itself is busy with it,
+       thus KILL is sent over a separate control connection, shared with other connections to the same server under
+       the same user. Returns 0 on success */
+int MADB_DbcKillQuery(MADB_Dbc *Dbc)
+{
+  MYSQL         *MariaDb= Dbc->mariadb;
+  MADB_KillConn *Kill;
+  char           StmtStr[32], Key[512];
+  unsigned int   Error;
+  int            rc= 1, Attempt;
+
+  _snprintf(Key, sizeof(Key), "%s:%u:%s:%s", MariaDb->host ? MariaDb->host : "", MariaDb->port,
+            MariaDb->unix_socket ? MariaDb->unix_socket : "", MariaDb->user ? MariaDb->user : "");
+  _snprintf(StmtStr, sizeof(StmtStr), "KILL QUERY %lu", mysql_thread_id(MariaDb));
+
+  /* If the reused connection is gone despite the check, one more attempt is made with a new one */
+  for (Attempt= 0; Attempt < 2; ++Attempt)
+  {
+    if ((Kill= MADB_KillConnGet(Dbc, Key, Attempt == 0)) == NULL)
     {
-     cs_name= Dsn->CharacterSet;
+      break;
     }
-    else if (Connection->IsAnsi)
+    rc= mysql_query(Kill->Mariadb, StmtStr);
+    Error= rc ? mysql_errno(Kill->Mariadb) : 0;
+    if (Error == CR_SERVER_GONE_ERROR || Error == CR_SERVER_LOST)
     {
-      MARIADB_CHARSET_INFO *cs= mariadb_get_charset_by_name("auto");
-      cs_name= cs->csname;
+      MADB_KillConnFree(Kill);
+      continue;
     }
+    MADB_KillConnPut(Dbc, Kill);
+    break;
+  }
 
-    // Use utf8mb3 by default if no specific charset was provided by the client.
-    if (InitClientCharset(&Connection->Charset, MADB_IS_EMPTY(cs_name) ? "utf8" : cs_name))
+  return rc;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInitSession - applies session settings the driver relies on, and the attributes the application has
+       set on the connection handle. Used right after connect, and after the session has been reset. Everything goes
+       in one SET, autocommit only if the server status says it differs from what is required */
+static SQLRETURN MADB_DbcInitSession(MADB_Dbc *Dbc)
+{
+  char StmtStr[128];
+  my_bool AutoCommit= Dbc->AutoCommit != SQL_AUTOCOMMIT_OFF;
+  unsigned int i;
+
+  /* Turn sql_auto_is_null behavior off.
+     For more details see: http://bugs.mysql.com/bug.php?id=47005 */
+  if (AutoCommit == ((Dbc->mariadb->server_status & SERVER_STATUS_AUTOCOMMIT) != 0))
+  {
+    strcpy(StmtStr, "SET SESSION SQL_AUTO_IS_NULL=0");
+  }
+  else
+  {
+    _snprintf(StmtStr, sizeof(StmtStr), "SET SESSION SQL_AUTO_IS_NULL=0, AUTOCOMMIT=%d", AutoCommit ? 1 : 0);
+  }
+  if (mysql_query(Dbc->mariadb, StmtStr))
+    goto mysql_native_err;
+  Dbc->SessionAutoCommit= AutoCommit;
+
+  /* Set isolation level */
+  if (Dbc->TxnIsolation)
+    for (i=0; i < 4; i++)
     {
-      /* Memory allocation error */
-      MADB_SetError(&Connection->Error, MADB_ERR_HY001, "Charset is not supported", 0);
-      goto end;
+      if (MADB_IsolationLevel[i].SqlIsolation == Dbc->TxnIsolation)
+      {
+        _snprintf(StmtStr, 128, "SET SESSION TRANSACTION ISOLATION LEVEL %s",
+                    MADB_IsolationLevel[i].StrIsolation);
+        if (mysql_query(Dbc->mariadb, StmtStr))
+          goto mysql_native_err;
+        break;
+      }
     }
-    if (iOdbc() && strcmp(Connection->Charset.cs_info->csname, "swe7") == 0)
+  Dbc->SessionTxnIsolation= Dbc->TxnIsolation;
+
+  return SQL_SUCCESS;
+
+mysql_native_err:
+  return MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+}
+/* }}} */
+
+/* {{{ MADB_DbcApplySessionState - sends autocommit mode and isolation level, application has set since the last
+       statement, to the server. Values already in effect are not sent, thus toggling autocommit back and forth between
+       statements costs nothing. Failure is reported as such, and not as the error of the statement */
+SQLRETURN MADB_DbcApplySessionState(MADB_Dbc *Dbc)
+{
+  char        StmtStr[128], ErrorMsg[SQL_MAX_MESSAGE_LENGTH];
+  const char *Attribute;
+  struct st_madb_isolation *Isolation;
+
+  /* Server status is updated by any query on the connection */
+  LOCK_MARIADB(Dbc);
+  if (!MADB_SESSION_STATE_PENDING(Dbc))
+  {
+    UNLOCK_MARIADB(Dbc);
+    return SQL_SUCCESS;
+  }
+
+  Attribute= "SQL_ATTR_AUTOCOMMIT";
+  if ((Dbc->AutoCommit != SQL_AUTOCOMMIT_OFF) != Dbc->SessionAutoCommit)
+  {
+    if (mysql_autocommit(Dbc->mariadb, Dbc->AutoCommit != SQL_AUTOCOMMIT_OFF))
     {
-      MADB_SetError(&Connection->Error, MADB_ERR_HY001, "Charset SWE7 is not supported with iODBC", 0);
-      goto end;
+      goto apply_err;
+    }
+    Dbc->SessionAutoCommit= Dbc->AutoCommit != SQL_AUTOCOMMIT_OFF;
+  }
+  if (Dbc->TxnIsolation != Dbc->SessionTxnIsolation)
+  {
+    Attribute= "SQL_ATTR_TXN_ISOLATION";
+    /* Value has been validated, when it was set */
+    if ((Isolation= MADB_GetIsolationLevel(Dbc->TxnIsolation)) != NULL)
+    {
+      _snprintf(StmtStr, sizeof(StmtStr), "SET SESSION TRANSACTION ISOLATION LEVEL %s", Isolation->StrIsolation);
+      if (mysql_query(Dbc->mariadb, StmtStr))
+      {
+        goto apply_err;
+      }
+    }
+    Dbc->SessionTxnIsolation= Dbc->TxnIsolation;
+  }
+  UNLOCK_MARIADB(Dbc);
+
+  return SQL_SUCCESS;
+
+apply_err:
+  /* Lost connection is reported as such */
+  if (mysql_errno(Dbc->mariadb) == CR_SERVER_GONE_ERROR || mysql_errno(Dbc->mariadb) == CR_SERVER_LOST)
+  {
+    MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+  }
+  else
+  {
+    _snprintf(ErrorMsg, sizeof(ErrorMsg), "Could not apply %s, set on the connection, before executing the statement: %s",
+              Attribute, mysql_error(Dbc->mariadb));
+    MADB_SetError(&Dbc->Error, MADB_ERR_HY000, ErrorMsg, mysql_errno(Dbc->mariadb));
+  }
+  UNLOCK_MARIADB(Dbc);
+  return Dbc->Error.ReturnValue;
+}
+/* }}} */
+
+/* {{{ MADB_DbcReadSessionInfo - reads with one query SingleStore version, if requested, and the character set of the
+       current database. Caller has to hold the connection lock. Info discovered by other connections to the same
+       server, user and database is taken from the process-wide cache instead of querying, while it's fresh */
+static SQLRETURN MADB_DbcReadSessionInfo(MADB_Dbc *Dbc, my_bool ReadVersion)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW  row;
+
+  if (MADB_ServerInfoGet(Dbc, ReadVersion))
+  {
+    return SQL_SUCCESS;
+  }
+
+  Dbc->DBCharsetnr= 0;
+  if (mysql_query(Dbc->mariadb, ReadVersion ? "SELECT @@collation_database, @@memsql_version" :
+                                              "SELECT @@collation_database"))
+  {
+    return MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+  }
+  if ((result= mysql_store_result(Dbc->mariadb)) == NULL)
+  {
+    return MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+  }
+  if ((row= mysql_fetch_row(result)))
+  {
+    SetDBCharsetnr(Dbc, row[0]);
+    if (ReadVersion && row[1] != NULL)
+    {
+      mysql_optionsv(Dbc->mariadb, MYSQL_SS_VERSION, row[1]);
+    }
+    MADB_ServerInfoPut(Dbc, ReadVersion);
+  }
+  mysql_free_result(result);
 
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_DbcResetSession - returns the session of the pooled connection to the state of the freshly established
+       one, i.e. drops user variables, temporary tables, prepared statements and transaction, and re-applies the
+       connection attributes. COM_RESET_CONNECTION is used if the server knows it, COM_CHANGE_USER otherwise */
+static SQLRETURN MADB_DbcResetSession(MADB_Dbc *Dbc)
+{
+  MYSQL      *MariaDb= Dbc->mariadb;
+  const char *Catalog;
+  SQLRETURN   ret;
+
+  if (!CheckConnection(Dbc))
+  {
+    return MADB_SetError(&Dbc->Error, MADB_ERR_08003, NULL, 0);
+  }
+
+  LOCK_MARIADB(Dbc);
+  if (mysql_reset_connection(MariaDb))
+  {
+    if (mysql_errno(MariaDb) != 1047 /*ER_UNKNOWN_COM_ERROR*/ ||
+        mysql_change_user(MariaDb, MariaDb->user, MariaDb->passwd, MariaDb->db))
+    {
+      goto mysql_native_err;
     }
-    if (!Connection->IsAnsi || iOdbc())
+  }
+  /* Both commands release server-side prepared statements, cached ones are not usable anymore */
+  MADB_StmtCacheFree(Dbc);
+  /* and session variables are back to the server defaults */
+  Dbc->SessionTxnIsolation= 0;
+
+  /* Character set is a session variable, that has been reset as well */
+  if (mysql_set_character_set(MariaDb, Dbc->Charset.cs_info->csname))
+  {
+    goto mysql_native_err;
+  }
+  if (Dbc->Dsn != NULL)
+  {
+    if (!MADB_IS_EMPTY(Dbc->Dsn->InitCommand))
     {
-      /* If application is not ansi, we should convert wchar into connection string */
-      Connection->ConnOrSrcCharset= &Connection->Charset;
+      if (mysql_query(MariaDb, Dbc->Dsn->InitCommand))
+      {
+        goto mysql_native_err;
+      }
+      QuickDropAllPendingResults(Dbc, MariaDb);
+      Dbc->CurrentDbUnknown= TRUE;
+    }
+  }
+  /* Application could change current database with USE - getting back to the requested one, or to the one of the
+     connection string */
+  Catalog= MADB_IS_EMPTY(Dbc->CatalogName) && Dbc->Dsn != NULL ? Dbc->Dsn->Catalog : Dbc->CatalogName;
+  if (!MADB_IS_EMPTY(Catalog))
+  {
+    if (mysql_select_db(MariaDb, Catalog))
+    {
+      goto mysql_native_err;
+    }
+    Dbc->CurrentDbUnknown= FALSE;
+  }
+
+  ret= MADB_DbcInitSession(Dbc);
+  if (SQL_SUCCEEDED(ret))
+  {
+    ret= MADB_DbcReadSessionInfo(Dbc, FALSE);
+  }
+  UNLOCK_MARIADB(Dbc);
+
+  return ret;
+
+mysql_native_err:
+  MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, MariaDb);
+  UNLOCK_MARIADB(Dbc);
+  return Dbc->Error.ReturnValue;
+}
+/* }}} */
+
+/* {{{ MADB_DbcSetConnectOptions - sets connection options from the Dsn on the Mariadb handle. Returns client flags
+       for the mysql_real_connect */
+static unsigned long MADB_DbcSetConnectOptions(MADB_Dbc *Connection, MADB_Dsn *Dsn, MYSQL *Mariadb)
+{
+  unsigned ReportDataTruncation= 1;
+  unsigned long ClientFlags= 0L;
+  my_bool my_reconnect= 1;
+
+  if( !MADB_IS_EMPTY(Dsn->ConnCPluginsDir))
+  {
+    mysql_optionsv(Mariadb, MYSQL_PLUGIN_DIR, Dsn->ConnCPluginsDir);
+  }
+  else
+  {
+    if (DefaultPluginLocation != NULL)
+    {
+      mysql_optionsv(Mariadb, MYSQL_PLUGIN_DIR, DefaultPluginLocation);
     }
   }
 
+  if (Dsn->ReadMycnf != '\0')
+  {
+    mysql_optionsv(Mariadb, MYSQL_READ_DEFAULT_GROUP, (void *)"odbc");
+  }
   /* todo: error handling */
-  mysql_optionsv(Connection->mariadb, MYSQL_SET_CHARSET_NAME, Connection->Charset.cs_info->csname);
+  mysql_optionsv(Mariadb, MYSQL_SET_CHARSET_NAME, Connection->Charset.cs_info->csname);
 
   if (Dsn->InitCommand && Dsn->InitCommand[0])
-    mysql_optionsv(Connection->mariadb, MYSQL_INIT_COMMAND, Dsn->InitCommand);
+    mysql_optionsv(Mariadb, MYSQL_INIT_COMMAND, Dsn->InitCommand);
  
   if (Dsn->ConnectionTimeout)
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_CONNECT_TIMEOUT, (const char *)&Dsn->ConnectionTimeout);
-
-  Connection->Options= Dsn->Options;
+    mysql_optionsv(Mariadb, MYSQL_OPT_CONNECT_TIMEOUT, (const char *)&Dsn->ConnectionTimeout);
 
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_AUTO_RECONNECT))
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_RECONNECT, &my_reconnect);
+    mysql_optionsv(Mariadb, MYSQL_OPT_RECONNECT, &my_reconnect);
 
   if (Dsn->IsNamedPipe) /* DSN_OPTION(Connection, MADB_OPT_FLAG_NAMED_PIPE) */
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_NAMED_PIPE, (void *)Dsn->ServerName);
+    mysql_optionsv(Mariadb, MYSQL_OPT_NAMED_PIPE, (void *)Dsn->ServerName);
 
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_NO_SCHEMA))
-    client_flags|= CLIENT_NO_SCHEMA;
+    ClientFlags|= CLIENT_NO_SCHEMA;
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_IGNORE_SPACE))
-    client_flags|= CLIENT_IGNORE_SPACE;
+    ClientFlags|= CLIENT_IGNORE_SPACE;
 
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_FOUND_ROWS))
-    client_flags|= CLIENT_FOUND_ROWS;
+    ClientFlags|= CLIENT_FOUND_ROWS;
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_COMPRESSED_PROTO))
-    client_flags|= CLIENT_COMPRESS;
+    ClientFlags|= CLIENT_COMPRESS;
   if (DSN_OPTION(Connection, MADB_OPT_FLAG_MULTI_STATEMENTS))
-    client_flags|= CLIENT_MULTI_STATEMENTS;
+    ClientFlags|= CLIENT_MULTI_STATEMENTS;
 
   if (Dsn->InteractiveClient)
   {
-    mysql_optionsv(Connection->mariadb, MARIADB_OPT_INTERACTIVE, 1);
+    mysql_optionsv(Mariadb, MARIADB_OPT_INTERACTIVE, 1);
+  }
+  if (Dsn->LargePages)
+  {
+    mysql_optionsv(Mariadb, MARIADB_OPT_LARGE_PAGES, &Dsn->LargePages);
   }
   /* enable truncation reporting */
-  mysql_optionsv(Connection->mariadb, MYSQL_REPORT_DATA_TRUNCATION, &ReportDataTruncation);
+  mysql_optionsv(Mariadb, MYSQL_REPORT_DATA_TRUNCATION, &ReportDataTruncation);
 
   if (Dsn->Socket)
   {
     int protocol= MYSQL_PROTOCOL_SOCKET;
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_PROTOCOL, (void*)&protocol);
+    mysql_optionsv(Mariadb, MYSQL_OPT_PROTOCOL, (void*)&protocol);
   }
 
   {
@@ -712,27 +1269,27 @@ SQLRETURN MADB_DbcConnectDB(MADB_Dbc *Connection,
      || !MADB_IS_EMPTY(SslKey))
     {
       char Enable= 1;
-      mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_ENFORCE, &Enable);
+      mysql_optionsv(Mariadb, MYSQL_OPT_SSL_ENFORCE, &Enable);
 
       if (!MADB_IS_EMPTY(SslKey))
       {
-        mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_KEY, SslKey);
+        mysql_optionsv(Mariadb, MYSQL_OPT_SSL_KEY, SslKey);
       }
       if (!MADB_IS_EMPTY(SslCert))
       {
-        mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CERT, SslCert);
+        mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CERT, SslCert);
       }
       if (!MADB_IS_EMPTY(SslCa))
       {
-        mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CA, SslCa);
+        mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CA, SslCa);
       }
       if (!MADB_IS_EMPTY(SslCaPath))
       {
-        mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CAPATH, SslCaPath);
+        mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CAPATH, SslCaPath);
       }
       if (!MADB_IS_EMPTY(SslCipher))
       {
-        mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CIPHER, SslCipher);
+        mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CIPHER, SslCipher);
       }
 
       if (Dsn->TlsVersion > 0)
@@ -756,55 +1313,220 @@ SQLRETURN MADB_DbcConnectDB(MADB_Dbc *Connection,
             Ptr += strlen(TlsVersionName[i]);
           }
         }
-        mysql_optionsv(Connection->mariadb, MARIADB_OPT_TLS_VERSION, (void *)TlsVersion);
+        mysql_optionsv(Mariadb, MARIADB_OPT_TLS_VERSION, (void *)TlsVersion);
       }
     }
   
     if (Dsn->SslVerify)
     {
       const unsigned int verify= 0x01010101;
-      mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, (const char*)&verify);
+      mysql_optionsv(Mariadb, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, (const char*)&verify);
     }
     else
     {
       const unsigned int verify= 0;
-      mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, (const char*)&verify);
+      mysql_optionsv(Mariadb, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, (const char*)&verify);
     }
   }
   
   if (Dsn->ForceTls != '\0')
   {
     const unsigned int ForceTls= 0x01010101;
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_ENFORCE, (const char*)&ForceTls);
+    mysql_optionsv(Mariadb, MYSQL_OPT_SSL_ENFORCE, (const char*)&ForceTls);
   }
 
   if (!MADB_IS_EMPTY(Dsn->SslCrl))
   {
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CRL, Dsn->SslCrl);
+    mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CRL, Dsn->SslCrl);
   }
   if (!MADB_IS_EMPTY(Dsn->SslCrlPath))
   {
-    mysql_optionsv(Connection->mariadb, MYSQL_OPT_SSL_CRLPATH, Dsn->SslCrlPath);
+    mysql_optionsv(Mariadb, MYSQL_OPT_SSL_CRLPATH, Dsn->SslCrlPath);
   }
 
   if (!MADB_IS_EMPTY(Dsn->ServerKey))
   {
-    mysql_optionsv(Connection->mariadb, MYSQL_SERVER_PUBLIC_KEY, Dsn->ServerKey);
+    mysql_optionsv(Mariadb, MYSQL_SERVER_PUBLIC_KEY, Dsn->ServerKey);
+  }
+
+  if (!MADB_IS_EMPTY(Dsn->TlsPeerFp))
+  {
+    mysql_optionsv(Mariadb, MARIADB_OPT_TLS_PEER_FP, (void*)Dsn->TlsPeerFp);
+  }
+  if (!MADB_IS_EMPTY(Dsn->TlsPeerFpList))
+  {
+    mysql_optionsv(Mariadb, MARIADB_OPT_TLS_PEER_FP_LIST, (void*)Dsn->TlsPeerFpList);
+  }
+
+  if (!MADB_IS_EMPTY(Dsn->TlsKeyPwd))
+  {
+    mysql_optionsv(Mariadb, MARIADB_OPT_TLS_PASSPHRASE, (void*)Dsn->TlsKeyPwd);
+  }
+
+  return ClientFlags;
+}
+/* }}} */
+
+/* {{{ MADB_DbcRealConnect - connects Connection->mariadb to the server. If Servers is the list of hosts, they are tried
+       in the order of the HOST_STRATEGY, until one accepts the connection. With the RACE strategy connection to the
+       winner replaces Connection->mariadb */
+static my_bool MADB_DbcRealConnect(MADB_Dbc *Connection, MADB_Dsn *Dsn, const char *Servers, const char *Catalog,
+                                   unsigned long ClientFlags)
+{
+  MADB_HostList List;
+  const char   *Db= !MADB_IS_EMPTY(Catalog) ? Catalog : NULL;
+  int           Strategy= MADB_HostStrategy(Dsn->HostStrategy);
+  unsigned int  i;
+  my_bool       Connected= FALSE;
+
+  if (Dsn->Socket || Dsn->IsNamedPipe || !MADB_HostListInit(&List, Servers, Dsn->Port))
+  {
+    return mysql_real_connect(Connection->mariadb, Dsn->Socket ? "localhost" : Servers, Dsn->UserName,
+                              Dsn->Password, Db, Dsn->Port, Dsn->Socket, ClientFlags) != NULL;
+  }
+
+  MADB_HostListOrder(&List, Strategy);
+
+  if (Strategy == MADB_HOSTS_RACE && List.Count > 1)
+  {
+    MYSQL **Racers= (MYSQL **)MADB_CALLOC(List.Count * sizeof(MYSQL *));
+    size_t  StackSize= MADB_ASYNC_STACK_SIZE;
+    int     Result= -1;
+
+    for (i= 0; Racers != NULL && i < List.Count; ++i)
+    {
+      if ((Racers[i]= mysql_init(NULL)) == NULL || mysql_optionsv(Racers[i], MYSQL_OPT_NONBLOCK, &StackSize))
+      {
+        break;
+      }
+      MADB_DbcSetConnectOptions(Connection, Dsn, Racers[i]);
+    }
+    if (i == List.Count)
+    {
+      Result= MADB_HostRace(&List, Racers, Dsn->UserName, Dsn->Password, Db, ClientFlags, Dsn->RaceDelay);
+    }
+
+    if (Result < 0)
+    {
+      for (i= 0; Racers != NULL && i < List.Count; ++i)
+      {
+        if (Racers[i] != NULL)
+        {
+          mysql_close(Racers[i]);
+        }
+      }
+      MADB_SetError(&Connection->Error, MADB_ERR_HY001, NULL, 0);
+    }
+    else
+    {
+      mysql_close(Connection->mariadb);
+      Connection->mariadb= Racers[Result];
+      Connected= mysql_errno(Connection->mariadb) == 0;
+    }
+    MADB_FREE(Racers);
   }
+  else
+  {
+    for (i= 0; i < List.Count; ++i)
+    {
+      unsigned long long Start= MADB_HostTime();
+
+      /* Options have to survive the failed attempt, if there is the next one */
+      if (mysql_real_connect(Connection->mariadb, List.Hosts[i].Name, Dsn->UserName, Dsn->Password, Db,
+                             List.Hosts[i].Port, NULL,
+                             ClientFlags | (i + 1 < List.Count ? CLIENT_REMEMBER_OPTIONS : 0)) != NULL)
+      {
+        MADB_HostSuccess(List.Hosts[i].Name, List.Hosts[i].Port, MADB_HostTime() - Start);
+        Connected= TRUE;
+        break;
+      }
+      if (!MADB_HostUnreachable(mysql_errno(Connection->mariadb)))
+      {
+        break;
+      }
+      MADB_HostFailure(List.Hosts[i].Name, List.Hosts[i].Port);
+    }
+  }
+
+  MADB_HostListFree(&List);
+  return Connected;
+}
+/* }}} */
+
+/* {{{ MADB_Dbc_ConnectDB
+       Mind that this function is used for establishing connection from the setup lib
+*/
+SQLRETURN MADB_DbcConnectDB(MADB_Dbc *Connection,
+    MADB_Dsn *Dsn)
+{
+  unsigned long client_flags;
+  SQLRETURN     ret;
+
+  if (!Connection || !Dsn)
+    return SQL_ERROR;
+
+  MADB_CLEAR_ERROR(&Connection->Error);
+
+  if (MADB_HostStrategy(Dsn->HostStrategy) < 0)
+  {
+    MADB_SetError(&Connection->Error, MADB_ERR_HY000, "Invalid HOST_STRATEGY", 0);
+    goto end;
+  }
+  /* Negative value is read as a huge unsigned one, and would make the cache unbounded */
+  if ((int)Dsn->ParseCacheSize < 0)
+  {
+    MADB_SetError(&Connection->Error, MADB_ERR_HY000, "Invalid PARSE_CACHE", 0);
+    goto end;
+  }
+
+  if (Connection->mariadb == NULL)
+  {
+    if (!(Connection->mariadb= mysql_init(NULL)))
+    {
+      MADB_SetError(&Connection->Error, MADB_ERR_HY001, NULL, 0);
+      goto end;
+    }
+  }
+
+  /* If a client character set was specified in DSN, we will always use it.
+     Otherwise for ANSI applications we will use the current character set,
+     for unicode connections we use utf8
+  */
+  {
+    const char* cs_name= NULL;
+
+    if (!MADB_IS_EMPTY(Dsn->CharacterSet))
+    {
+     cs_name= Dsn->CharacterSet;
+    }
+    else if (Connection->IsAnsi)
+    {
+      MARIADB_CHARSET_INFO *cs= mariadb_get_charset_by_name("auto");
+      cs_name= cs->csname;
+    }
+
+    // Use utf8mb3 by default if no specific charset was provided by the client.
+    if (InitClientCharset(&Connection->Charset, MADB_IS_EMPTY(cs_name) ? "utf8" : cs_name))
+    {
+      /* Memory allocation error */
+      MADB_SetError(&Connection->Error, MADB_ERR_HY001, "Charset is not supported", 0);
+      goto end;
+    }
+    if (iOdbc() && strcmp(Connection->Charset.cs_info->csname, "swe7") == 0)
+    {
+      MADB_SetError(&Connection->Error, MADB_ERR_HY001, "Charset SWE7 is not supported with iODBC", 0);
+      goto end;
 
-  if (!MADB_IS_EMPTY(Dsn->TlsPeerFp))
-  {
-    mysql_optionsv(Connection->mariadb, MARIADB_OPT_TLS_PEER_FP, (void*)Dsn->TlsPeerFp);
-  }
-  if (!MADB_IS_EMPTY(Dsn->TlsPeerFpList))
-  {
-    mysql_optionsv(Connection->mariadb, MARIADB_OPT_TLS_PEER_FP_LIST, (void*)Dsn->TlsPeerFpList);
+    }
+    if (!Connection->IsAnsi || iOdbc())
+    {
+      /* If application is not ansi, we should convert wchar into connection string */
+      Connection->ConnOrSrcCharset= &Connection->Charset;
+    }
   }
 
-  if (!MADB_IS_EMPTY(Dsn->TlsKeyPwd))
-  {
-    mysql_optionsv(Connection->mariadb, MARIADB_OPT_TLS_PASSPHRASE, (void*)Dsn->TlsKeyPwd);
-  }
+  Connection->Options= Dsn->Options;
+  client_flags= MADB_DbcSetConnectOptions(Connection, Dsn, Connection->mariadb);
 
   char *emailForSSO = Dsn->UserName;
   if (Dsn->IsBrowserAuth)
@@ -815,11 +1537,33 @@ SQLRETURN MADB_DbcConnectDB(MADB_Dbc *Connection,
     }
   }
 
-  my_bool connectionTried = FALSE;
+  /* Catalog set with SQL_ATTR_CURRENT_CATALOG before connect takes precedence, and is selected within the handshake */
+  const char *Catalog= !MADB_IS_EMPTY(Connection->CatalogName) ? Connection->CatalogName : Dsn->Catalog;
+
+  /* Read-only connection goes to the read hosts. If none of them is reachable - to the SERVER */
+  my_bool UseReadServer= Connection->AccessMode == SQL_MODE_READ_ONLY && !MADB_IS_EMPTY(Dsn->ReadServer) &&
+                         !Dsn->Socket && !Dsn->IsNamedPipe;
+  /* Without read hosts read-only mode can't be honored, and the application is told so once connected */
+  my_bool ModeChanged= Connection->AccessMode == SQL_MODE_READ_ONLY && !UseReadServer;
+  my_bool connectionTried = FALSE, Connected;
+
+  if (!UseReadServer)
+  {
+    Connection->AccessMode= SQL_MODE_READ_WRITE;
+  }
 real_connect:
-  if (!mysql_real_connect(Connection->mariadb,
-      Dsn->Socket ? "localhost" : Dsn->ServerName, Dsn->UserName, Dsn->Password,
-        Dsn->Catalog && Dsn->Catalog[0] ? Dsn->Catalog : NULL, Dsn->Port, Dsn->Socket, client_flags))
+  Connected= FALSE;
+  if (UseReadServer)
+  {
+    /* Options have to survive the failure for the connect to the SERVER */
+    Connected= MADB_DbcRealConnect(Connection, Dsn, Dsn->ReadServer, Catalog, client_flags | CLIENT_REMEMBER_OPTIONS);
+  }
+  if (!Connected && (!UseReadServer || (Connection->Error.ReturnValue != SQL_ERROR &&
+                                        MADB_HostUnreachable(mysql_errno(Connection->mariadb)))))
+  {
+    Connected= MADB_DbcRealConnect(Connection, Dsn, Dsn->ServerName, Catalog, client_flags);
+  }
+  if (!Connected)
   {
     // in case of Browser Auth we try to get credentials from the browser
     // without reading the keyring, and then retry connection
@@ -835,6 +1579,10 @@ real_connect:
         goto real_connect;
       }
     }
+    if (Connection->Error.ReturnValue == SQL_ERROR)
+    {
+      goto end;
+    }
     goto mysql_native_err;
   }
   
@@ -846,64 +1594,33 @@ real_connect:
       goto mysql_native_err;*/
   }
 
-  /* set default catalog */
-  if (Connection->CatalogName && Connection->CatalogName[0])
-  {
-    if (mysql_select_db(Connection->mariadb, Connection->CatalogName))
-      goto mysql_native_err;
-  }
-
-  /* Turn sql_auto_is_null behavior off.
-     For more details see: http://bugs.mysql.com/bug.php?id=47005 */
-  if (mysql_query(Connection->mariadb, "SET SESSION SQL_AUTO_IS_NULL=0"))
-    goto mysql_native_err;
-
-  /* set autocommit behavior */
-  if (mysql_autocommit(Connection->mariadb, (my_bool)Connection->AutoCommit))
-    goto mysql_native_err;
+  /* Init command might have changed the database. The server capability alone does not tell, if the change has been
+     reported, and the init command may have several statements */
+  Connection->CurrentDbUnknown= !MADB_IS_EMPTY(Dsn->InitCommand);
 
-  if (!Dsn->CompatMode) {
-    MYSQL_RES *result;
-    MYSQL_ROW row;
-    const char *StmtString= "SELECT @@memsql_version";
+  /* Two round trips altogether - one to set session up, and one to read what the driver needs to know about it */
+  if (!SQL_SUCCEEDED(MADB_DbcInitSession(Connection)))
+    goto end;
 
-    LOCK_MARIADB(Connection);
-    if (mysql_query(Connection->mariadb, StmtString))
-    {
-      UNLOCK_MARIADB(Connection);
-      return MADB_SetNativeError(&Connection->Error, SQL_HANDLE_DBC, Connection->mariadb);
-    }
-    result= mysql_store_result(Connection->mariadb);
-    UNLOCK_MARIADB(Connection);
-    if ((row = mysql_fetch_row(result)))
+  LOCK_MARIADB(Connection);
+  ret= MADB_DbcReadSessionInfo(Connection, !Dsn->CompatMode);
+  UNLOCK_MARIADB(Connection);
+  if (SQL_SUCCEEDED(ret))
+  {
+    if (ModeChanged)
     {
-      char* ss_version = (char*) row[0];
-      mysql_optionsv(Connection->mariadb, MYSQL_SS_VERSION, ss_version);
+      MADB_SetError(&Connection->Error, MADB_ERR_01S02, "Option value changed to default (SQL_ATTR_ACCESS_MODE)", 0);
     }
-    mysql_free_result(result);
+    goto end;
   }
-  SetDBCharsetnr(Connection);
-  /* Set isolation level */
-  if (Connection->IsolationLevel)
-    for (i=0; i < 4; i++)
-    {
-      if (MADB_IsolationLevel[i].SqlIsolation == Connection->IsolationLevel)
-      {
-        _snprintf(StmtStr, 128, "SET SESSION TRANSACTION ISOLATION LEVEL %s",
-                    MADB_IsolationLevel[i].StrIsolation);
-        if (mysql_query(Connection->mariadb, StmtStr))
-          goto mysql_native_err;
-        break;
-      }
-    }
-
-  goto end;
 
 mysql_native_err:
   MADB_SetNativeError(&Connection->Error, SQL_HANDLE_DBC, Connection->mariadb);
       
 end:
-  if (Connection->Error.ReturnValue == SQL_ERROR && Connection->mariadb)
+  /* Asynchronous connect runs on the handle's stack, and closes it itself */
+  if (Connection->Error.ReturnValue == SQL_ERROR && Connection->mariadb &&
+      Connection->AsyncConnect.Func == MADB_ASYNC_NONE)
   {
     mysql_close(Connection->mariadb);
     Connection->mariadb= NULL;
@@ -1075,12 +1792,20 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
     break;
 #ifdef SQL_ASYNC_DBC_FUNCTIONS
   case SQL_ASYNC_DBC_FUNCTIONS:
+#ifndef MADB_ASYNC_DISABLED
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_ASYNC_DBC_CAPABLE, StringLengthPtr);
+#else
     MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_ASYNC_DBC_NOT_CAPABLE, StringLengthPtr);
+#endif
     break;
 #endif
 #ifdef SQL_ASYNC_MODE
   case SQL_ASYNC_MODE:
+#ifndef MADB_ASYNC_DISABLED
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_AM_STATEMENT, StringLengthPtr);
+#else
     MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_AM_NONE, StringLengthPtr);
+#endif
     break;
 #endif
 #ifdef SQL_ASYNC_NOTIFICATION
@@ -1430,9 +2155,8 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
 #ifdef SQL_DRIVER_AWARE_POOLING_SUPPORTED
   case SQL_DRIVER_AWARE_POOLING_SUPPORTED:
     // SQL_DRIVER_AWARE_POOLING_SUPPORTED indicates if the driver support driver-aware pooling.
-    // SQL_DRIVER_AWARE_POOLING_NOT_CAPABLE indicates that the driver cannot support driver-aware pooling mechanism.
-    // TODO PLAT-5459 investigate if we can/need to support this
-    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_DRIVER_AWARE_POOLING_NOT_CAPABLE, StringLengthPtr);
+    // SQL_DRIVER_AWARE_POOLING_CAPABLE indicates that the driver can support driver-aware pooling mechanism.
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_DRIVER_AWARE_POOLING_CAPABLE, StringLengthPtr);
     break;
 #endif
     /* Handled by driver manager */
@@ -1453,7 +2177,7 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
   case SQL_DRIVER_ODBC_VER:
     // A character string with the version of ODBC that the driver supports.
     {
-      char *OdbcVersion = "03.51";
+      char *OdbcVersion = "03.80";
       /* DM requests this info before Dbc->Charset initialized. Thus checking if it is, and use utf8 by default
          The other way would be to use utf8 when Dbc initialized */
       SLen= (SQLSMALLINT)MADB_SetString(CHARSET_PTR(isWChar, Dbc),
@@ -1744,9 +2468,12 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
     break;
   case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
     // SQL_MAX_ASYNC_CONCURRENT_STATEMENTS  specifies the maximum number of active concurrent statements in asynchronous mode that the driver can support on a given connection.
-    // We are returning 0. It means that we don't have a specific limit or limit is unknown.
-    // TODO PLAT-5472
+    // There is one network connection, thus only one statement at a time may have asynchronous operation in progress.
+#ifndef MADB_ASYNC_DISABLED
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, 1, StringLengthPtr);
+#else
     MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, 0, StringLengthPtr);
+#endif
     break;
   case SQL_MAX_BINARY_LITERAL_LEN:
     // SQL_MAX_BINARY_LITERAL_LEN specifies the maximum length (number of hexadecimal characters, excluding the literal prefix and suffix returned by SQLGetTypeInfo)
@@ -2318,6 +3045,22 @@ SQLRETURN MADB_DriverConnect(MADB_Dbc *Dbc, SQLHWND WindowHandle, SQLCHAR *InCon
 
   MADB_CLEAR_ERROR(&Dbc->Error);
 
+  /* Asynchronous connecting in progress - resuming it with the DSN, it has been started with */
+  if (Dbc->AsyncConnect.Func == MADB_ASYNC_CONNECT)
+  {
+    Dsn= Dbc->AsyncConnect.Dsn;
+    ret= MADB_AsyncConnectDB(Dbc, Dsn);
+    if (ret == SQL_STILL_EXECUTING)
+    {
+      return ret;
+    }
+    if (SQL_SUCCEEDED(ret))
+    {
+      goto end;
+    }
+    goto error;
+  }
+
   Dsn= MADB_DSN_Init();
 
   if (!MADB_ReadConnString(Dsn, (char *)InConnectionString, StringLength1, ';'))
@@ -2349,7 +3092,13 @@ SQLRETURN MADB_DriverConnect(MADB_Dbc *Dbc, SQLHWND WindowHandle, SQLCHAR *InCon
   case SQL_DRIVER_COMPLETE:
   case SQL_DRIVER_NOPROMPT:
 
-    if (SQL_SUCCEEDED(MADB_DbcConnectDB(Dbc, Dsn)))
+    /* Only connecting without prompt can be asynchronous */
+    ret= DriverCompletion == SQL_DRIVER_NOPROMPT ? MADB_AsyncConnectDB(Dbc, Dsn) : MADB_DbcConnectDB(Dbc, Dsn);
+    if (ret == SQL_STILL_EXECUTING)
+    {
+      return ret;
+    }
+    if (SQL_SUCCEEDED(ret))
     {
       goto end;
     }
@@ -2484,6 +3233,393 @@ error:
 }
 /* }}} */
 
+/* {{{ MADB_DbcInfoTokenInit */
+MADB_DbcInfoToken *MADB_DbcInfoTokenInit(MADB_Env *Env)
+{
+  MADB_DbcInfoToken *Token;
+
+  MADB_CLEAR_ERROR(&Env->Error);
+
+  if ((Token= (MADB_DbcInfoToken *)MADB_CALLOC(sizeof(MADB_DbcInfoToken))) == NULL)
+  {
+    MADB_SetError(&Env->Error, MADB_ERR_HY001, NULL, 0);
+    return NULL;
+  }
+  MADB_PutErrorPrefix(NULL, &Token->Error);
+  Token->Environment= Env;
+  Token->AutoCommit=  SQL_AUTOCOMMIT_ON;
+
+  return Token;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenFree */
+SQLRETURN MADB_DbcInfoTokenFree(MADB_DbcInfoToken *Token)
+{
+  if (!Token)
+    return SQL_INVALID_HANDLE;
+
+  MADB_FREE(Token->ConnString);
+  MADB_FREE(Token->DsnName);
+  MADB_FREE(Token->UserName);
+  MADB_FREE(Token->Password);
+  MADB_FREE(Token->CatalogName);
+  MADB_DSN_Free(Token->Dsn);
+  MADB_FREE(Token);
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenSetStr - replaces string field value. Returns 1 if memory could not be allocated */
+static int MADB_DbcInfoTokenSetStr(char **Field, char *Value, SQLINTEGER Length)
+{
+  MADB_FREE(*Field);
+  if (Value == NULL)
+  {
+    return 0;
+  }
+  ADJUST_LENGTH(Value, Length);
+  return (*Field= MADB_STRNDUP(Value, Length)) == NULL;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenSetConnectInfo - SQLSetConnectInfo. Wide strings are converted by the caller */
+SQLRETURN MADB_DbcInfoTokenSetConnectInfo(MADB_DbcInfoToken *Token, char *ServerName, SQLSMALLINT NameLength1,
+                                          char *UserName, SQLSMALLINT NameLength2,
+                                          char *Authentication, SQLSMALLINT NameLength3)
+{
+  if (!Token)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Token->Error);
+  MADB_FREE(Token->ConnString);
+  MADB_DSN_Free(Token->Dsn);
+  Token->Dsn= NULL;
+
+  if (MADB_DbcInfoTokenSetStr(&Token->DsnName, ServerName, NameLength1) ||
+      MADB_DbcInfoTokenSetStr(&Token->UserName, UserName, NameLength2) ||
+      MADB_DbcInfoTokenSetStr(&Token->Password, Authentication, NameLength3))
+  {
+    return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenSetDriverConnectInfo - SQLSetDriverConnectInfo. Wide string is converted by the caller */
+SQLRETURN MADB_DbcInfoTokenSetDriverConnectInfo(MADB_DbcInfoToken *Token, char *InConnectionString,
+                                                SQLSMALLINT StringLength1)
+{
+  if (!Token)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Token->Error);
+  MADB_FREE(Token->DsnName);
+  MADB_FREE(Token->UserName);
+  MADB_FREE(Token->Password);
+  MADB_DSN_Free(Token->Dsn);
+  Token->Dsn= NULL;
+
+  if (InConnectionString == NULL)
+  {
+    return MADB_SetError(&Token->Error, MADB_ERR_HY009, NULL, 0);
+  }
+  if (MADB_DbcInfoTokenSetStr(&Token->ConnString, InConnectionString, StringLength1))
+  {
+    return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenSetAttr - SQLSetConnectAttrForDbcInfo. Only attributes, that make a difference for the pooled
+       connection reuse, are remembered. DM sets the rest on the connection handle */
+SQLRETURN MADB_DbcInfoTokenSetAttr(MADB_DbcInfoToken *Token, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
+                                   SQLINTEGER StringLength, my_bool isWChar)
+{
+  if (!Token)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Token->Error);
+
+  switch (Attribute) {
+  case SQL_ATTR_AUTOCOMMIT:
+    if ((SQLULEN)ValuePtr != SQL_AUTOCOMMIT_ON && (SQLULEN)ValuePtr != SQL_AUTOCOMMIT_OFF)
+    {
+      return MADB_SetError(&Token->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Token->AutoCommit= (SQLUINTEGER)(SQLULEN)ValuePtr;
+    break;
+  case SQL_ATTR_TXN_ISOLATION:
+    if (MADB_GetIsolationLevel((SQLLEN)ValuePtr) == NULL)
+    {
+      return MADB_SetError(&Token->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Token->TxnIsolation= (SQLINTEGER)(SQLLEN)ValuePtr;
+    break;
+  case SQL_ATTR_ACCESS_MODE:
+    if ((SQLULEN)ValuePtr != SQL_MODE_READ_WRITE && (SQLULEN)ValuePtr != SQL_MODE_READ_ONLY)
+    {
+      return MADB_SetError(&Token->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    Token->AccessMode= (SQLINTEGER)(SQLLEN)ValuePtr;
+    break;
+  case SQL_ATTR_CURRENT_CATALOG:
+    MADB_FREE(Token->CatalogName);
+    if (isWChar)
+    {
+      if (ValuePtr != NULL &&
+          (Token->CatalogName= MADB_ConvertFromWChar((SQLWCHAR *)ValuePtr, StringLength, NULL, &utf8, NULL)) == NULL)
+      {
+        return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+      }
+    }
+    else if (MADB_DbcInfoTokenSetStr(&Token->CatalogName, (char *)ValuePtr, StringLength))
+    {
+      return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+    }
+    break;
+  default:
+    break;
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_DbcInfoTokenReadDsn - DSN the token's connection info resolves to. It is parsed on first use, and stays with
+       the token until its connection info changes */
+static MADB_Dsn *MADB_DbcInfoTokenReadDsn(MADB_DbcInfoToken *Token)
+{
+  MADB_Dsn   *Dsn;
+  SQLSMALLINT Length= SQL_NTS;
+
+  if (Token->Dsn != NULL)
+  {
+    return Token->Dsn;
+  }
+  if ((Dsn= MADB_DSN_Init()) == NULL)
+  {
+    MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+    return NULL;
+  }
+  if (Token->ConnString != NULL)
+  {
+    if (!MADB_ReadConnString(Dsn, Token->ConnString, (int)strlen(Token->ConnString), ';'))
+    {
+      MADB_SetError(&Token->Error, MADB_ERR_HY000, "Error while parsing DSN", 0);
+      MADB_DSN_Free(Dsn);
+      return NULL;
+    }
+  }
+  else
+  {
+    MADB_DSN_SET_STR(Dsn, DSNName, Token->DsnName, Length);
+    MADB_ReadDSN(Dsn, NULL, TRUE);
+    Length= SQL_NTS;
+    MADB_DSN_SET_STR(Dsn, UserName, Token->UserName, Length);
+    Length= SQL_NTS;
+    MADB_DSN_SET_STR(Dsn, Password, Token->Password, Length);
+  }
+  Token->Dsn= Dsn;
+
+  return Dsn;
+}
+/* }}} */
+
+/* {{{ MADB_GetPoolID - SQLGetPoolID. Connections, that have the same DSN options, end up in the same pool, and can be
+       reused for each other requests after the reset. ID is the canonical connection string, owned by the environment.
+       Secrets are not the part of it - they are compared by MADB_RateConnection. Otherwise they would be kept in clear
+       text, and every rotation of the JWT would create new pool */
+SQLRETURN MADB_GetPoolID(MADB_DbcInfoToken *Token, POOLID *PoolId)
+{
+  MADB_Env  *Env;
+  MADB_Dsn  *Dsn;
+  MADB_List *Item;
+  char      *Key, *Password, *TlsKeyPwd, *Jwt;
+  SQLULEN    Length;
+  char      *Id= NULL;
+
+  if (!Token || !PoolId)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Token->Error);
+
+  if ((Dsn= MADB_DbcInfoTokenReadDsn(Token)) == NULL)
+  {
+    return Token->Error.ReturnValue;
+  }
+  Password=  Dsn->Password;
+  TlsKeyPwd= Dsn->TlsKeyPwd;
+  Jwt=       Dsn->JWT;
+  Dsn->Password=  NULL;
+  Dsn->TlsKeyPwd= NULL;
+  Dsn->JWT=       NULL;
+
+  Length= MADB_DsnToString(Dsn, NULL, 0);
+  if ((Key= (char *)MADB_ALLOC((size_t)Length + 1)) != NULL)
+  {
+    MADB_DsnToString(Dsn, Key, Length + 1);
+  }
+  Dsn->Password=  Password;
+  Dsn->TlsKeyPwd= TlsKeyPwd;
+  Dsn->JWT=       Jwt;
+
+  if (Key == NULL)
+  {
+    return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+  }
+
+  Env= Token->Environment;
+  EnterCriticalSection(&Env->cs);
+  for (Item= Env->PoolIds; Item != NULL; Item= Item->next)
+  {
+    if (strcmp((char *)Item->data, Key) == 0)
+    {
+      Id= (char *)Item->data;
+      break;
+    }
+  }
+  if (Id == NULL)
+  {
+    if ((Item= MADB_ListCons(Key, Env->PoolIds)) != NULL)
+    {
+      Env->PoolIds= Item;
+      Id= Key;
+      Key= NULL;
+    }
+  }
+  LeaveCriticalSection(&Env->cs);
+  MADB_FREE(Key);
+
+  if (Id == NULL)
+  {
+    return MADB_SetError(&Token->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  *PoolId= (POOLID)Id;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_CleanupConnectionPoolID - SQLCleanupConnectionPoolID. DM does not use the pool ID anymore */
+SQLRETURN MADB_CleanupConnectionPoolID(MADB_Env *Env, POOLID PoolId)
+{
+  MADB_List *Item;
+
+  if (!Env)
+    return SQL_INVALID_HANDLE;
+
+  EnterCriticalSection(&Env->cs);
+  for (Item= Env->PoolIds; Item != NULL; Item= Item->next)
+  {
+    if ((POOLID)Item->data == PoolId)
+    {
+      Env->PoolIds= MADB_ListDelete(Env->PoolIds, Item);
+      MADB_FREE(Item->data);
+      MADB_FREE(Item);
+      break;
+    }
+  }
+  LeaveCriticalSection(&Env->cs);
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_SameSecret - NULL and empty secrets are the same */
+static my_bool MADB_SameSecret(const char *Secret1, const char *Secret2)
+{
+  if (MADB_IS_EMPTY(Secret1) || MADB_IS_EMPTY(Secret2))
+  {
+    return MADB_IS_EMPTY(Secret1) && MADB_IS_EMPTY(Secret2);
+  }
+  return strcmp(Secret1, Secret2) == 0;
+}
+/* }}} */
+
+/* {{{ MADB_RateConnection - SQLRateConnection. Pool only has connections with the same DSN options, so any live one
+       can be used after the reset, if it has been established with the same secrets. The one, that is already in
+       the requested state, is the best match */
+SQLRETURN MADB_RateConnection(MADB_DbcInfoToken *Token, MADB_Dbc *Dbc, BOOL RequiredTransactionEnlistment,
+                              SQLUINTEGER *Rating)
+{
+  SQLUINTEGER Rate= 100;
+  MADB_Dsn   *Dsn;
+
+  if (!Token || !Dbc || !Rating)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Token->Error);
+
+  if ((Dsn= MADB_DbcInfoTokenReadDsn(Token)) == NULL)
+  {
+    return Token->Error.ReturnValue;
+  }
+  /* Distributed transactions are not supported */
+  if (RequiredTransactionEnlistment || !CheckConnection(Dbc) || Dbc->Dsn == NULL ||
+      !MADB_SameSecret(Dsn->Password, Dbc->Dsn->Password) || !MADB_SameSecret(Dsn->TlsKeyPwd, Dbc->Dsn->TlsKeyPwd) ||
+      !MADB_SameSecret(Dsn->JWT, Dbc->Dsn->JWT))
+  {
+    *Rating= 0;
+    return SQL_SUCCESS;
+  }
+  if (!MADB_IS_EMPTY(Token->CatalogName) &&
+      (Dbc->mariadb->db == NULL || strcmp(Token->CatalogName, Dbc->mariadb->db) != 0))
+  {
+    Rate-= 10;
+  }
+  if ((Token->AutoCommit != SQL_AUTOCOMMIT_OFF) != (Dbc->AutoCommit != SQL_AUTOCOMMIT_OFF))
+  {
+    Rate-= 5;
+  }
+  if (Token->TxnIsolation != Dbc->TxnIsolation)
+  {
+    Rate-= 5;
+  }
+  /* Switching the access mode means reconnect to other hosts */
+  if (Token->AccessMode != Dbc->AccessMode)
+  {
+    Rate-= 50;
+  }
+  *Rating= Rate;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_PoolConnect - SQLPoolConnect. Establishes new connection for the pool using the token's info */
+SQLRETURN MADB_PoolConnect(MADB_Dbc *Dbc, MADB_DbcInfoToken *Token, SQLCHAR *OutConnectionString,
+                           SQLULEN BufferLength, SQLSMALLINT *StringLength2Ptr)
+{
+  if (!Dbc || !Token)
+    return SQL_INVALID_HANDLE;
+
+  MADB_CLEAR_ERROR(&Dbc->Error);
+
+  Dbc->AutoCommit= Token->AutoCommit;
+  Dbc->TxnIsolation= Token->TxnIsolation;
+  Dbc->AccessMode= Token->AccessMode;
+  MADB_FREE(Dbc->CatalogName);
+  if (Token->CatalogName != NULL && (Dbc->CatalogName= MADB_STRDUP(Token->CatalogName)) == NULL)
+  {
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
+  }
+
+  if (Token->ConnString != NULL)
+  {
+    return Dbc->Methods->DriverConnect(Dbc, NULL, (SQLCHAR *)Token->ConnString, strlen(Token->ConnString),
+                                       OutConnectionString, BufferLength, StringLength2Ptr, SQL_DRIVER_NOPROMPT);
+  }
+  if (StringLength2Ptr)
+  {
+    *StringLength2Ptr= 0;
+  }
+  return SQLConnectCommon((SQLHDBC)Dbc, (SQLCHAR *)Token->DsnName, SQL_NTS, (SQLCHAR *)Token->UserName, SQL_NTS,
+                          (SQLCHAR *)Token->Password, SQL_NTS);
+}
+/* }}} */
+
 struct st_ma_connection_methods MADB_Dbc_Methods =
 { 
   MADB_DbcSetAttr,
@@ -52,10 +52,36 @@ struct st_ma_connection_methods
 
 my_bool CheckConnection(MADB_Dbc *Dbc);
 
+/* Application has changed autocommit mode or isolation level, and the server doesn't have it yet. Compared with what
+   the driver has applied, and not with the server status - autocommit, the application has changed with SET, is not
+   overridden */
+#define MADB_SESSION_STATE_PENDING(Dbc) ((Dbc)->mariadb != NULL &&\
+  (((Dbc)->AutoCommit != SQL_AUTOCOMMIT_OFF) != (Dbc)->SessionAutoCommit ||\
+   (Dbc)->TxnIsolation != (Dbc)->SessionTxnIsolation))
+SQLRETURN MADB_DbcApplySessionState(MADB_Dbc *Dbc);
+
 SQLRETURN MADB_DbcFree(MADB_Dbc *Connection);
 MADB_Dbc * MADB_DbcInit(MADB_Env *Env);
 SQLRETURN MADB_Dbc_GetCurrentDB(MADB_Dbc *Connection, SQLPOINTER CurrentDB, SQLINTEGER CurrentDBLength, 
                                 SQLSMALLINT *StringLengthPtr, my_bool isWChar);
+int MADB_DbcKillQuery(MADB_Dbc *Dbc);
+void MADB_KillConnsFree(MADB_Env *Env);
+
+MADB_DbcInfoToken *MADB_DbcInfoTokenInit(MADB_Env *Env);
+SQLRETURN MADB_DbcInfoTokenFree(MADB_DbcInfoToken *Token);
+SQLRETURN MADB_DbcInfoTokenSetConnectInfo(MADB_DbcInfoToken *Token, char *ServerName, SQLSMALLINT NameLength1,
+                                          char *UserName, SQLSMALLINT NameLength2,
+                                          char *Authentication, SQLSMALLINT NameLength3);
+SQLRETURN MADB_DbcInfoTokenSetDriverConnectInfo(MADB_DbcInfoToken *Token, char *InConnectionString,
+                                                SQLSMALLINT StringLength1);
+SQLRETURN MADB_DbcInfoTokenSetAttr(MADB_DbcInfoToken *Token, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
+                                   SQLINTEGER StringLength, my_bool isWChar);
+SQLRETURN MADB_GetPoolID(MADB_DbcInfoToken *Token, POOLID *PoolId);
+SQLRETURN MADB_CleanupConnectionPoolID(MADB_Env *Env, POOLID PoolId);
+SQLRETURN MADB_RateConnection(MADB_DbcInfoToken *Token, MADB_Dbc *Dbc, BOOL RequiredTransactionEnlistment,
+                              SQLUINTEGER *Rating);
+SQLRETURN MADB_PoolConnect(MADB_Dbc *Dbc, MADB_DbcInfoToken *Token, SQLCHAR *OutConnectionString,
+                           SQLULEN BufferLength, SQLSMALLINT *StringLength2Ptr);
 /* Has platform versions */
 char* MADB_GetDefaultPluginsDir(char* Buffer, size_t Size);
 
@@ -109,16 +109,12 @@ MADB_Desc *MADB_DescInit(MADB_Dbc *Dbc,enum enum_madb_desc_type DescType, my_boo
 }
 /* }}} */
 
-/* {{{ MADB_DescFree */
-SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
+/* {{{ MADB_DescFreeRecordsData - frees data, internal pointers of records point to */
+static void MADB_DescFreeRecordsData(MADB_Desc *Desc)
 {
   MADB_DescRecord *Record;
   unsigned int i;
 
-  if (!Desc)
-    return SQL_ERROR;
-
-  /* We need to free internal pointers first */
   for (i=0; i < Desc->Records.elements; i++)
   {
     Record= ((MADB_DescRecord *)Desc->Records.buffer) + i;
@@ -140,6 +136,19 @@ SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
       MADB_FREE(Record->TypeName);
     }
   }
+}
+/* }}} */
+
+/* {{{ MADB_DescFree */
+SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
+{
+  unsigned int i;
+
+  if (!Desc)
+    return SQL_ERROR;
+
+  /* We need to free internal pointers first */
+  MADB_DescFreeRecordsData(Desc);
   MADB_DeleteDynamic(&Desc->Records);
 
   Desc->Header.Count= 0;
@@ -171,6 +180,20 @@ SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
 }
 /* }}} */ 
 
+/* {{{ MADB_DescReset - brings the implicit descriptor to the state, it has right after MADB_DescInit. Records array
+       keeps its memory, so that the descriptor of the recycled statement does not need to allocate it again */
+void MADB_DescReset(MADB_Desc *Desc)
+{
+  MADB_DescFreeRecordsData(Desc);
+  Desc->Records.elements= 0;
+
+  memset(&Desc->Header, 0, sizeof(MADB_Header));
+  memset(&Desc->Fields, 0, sizeof(Desc->Fields));
+  Desc->Header.ArraySize= 1;
+  memset(&Desc->Error, 0, sizeof(MADB_Error));
+}
+/* }}} */
+
 /* {{{ MADB_SetIrdRecord */
 my_bool
 MADB_SetIrdRecord(MADB_Stmt *Stmt, MADB_DescRecord *Record, MYSQL_FIELD *Field)
@@ -45,9 +45,9 @@ MADB_Drv * MADB_DriverGet(char *DriverName)
       !SQLGetPrivateProfileString(DriverName, "Driver", "", Value, 2048, "ODBCINST.INI"))
      return NULL;
   Drv= MADB_DriverInit();
-  Drv->DriverName= _strdup(DriverName);
-  Drv->OdbcLibrary= _strdup(Value);
+  Drv->DriverName= MADB_STRDUP(DriverName);
+  Drv->OdbcLibrary= MADB_STRDUP(Value);
   if (SQLGetPrivateProfileString(DriverName, "Setup", "", Value, 2048, "ODBCINST.INI"))
-    Drv->SetupLibrary= _strdup(Value);
+    Drv->SetupLibrary= MADB_STRDUP(Value);
   return Drv;
 }
@@ -88,6 +88,14 @@ MADB_DsnKey DsnKeys[]=
   {"BROWSER_SSO",    offsetof(MADB_Dsn, IsBrowserAuth),     DSN_TYPE_BOOL  , 0, 0},
   {"JWT",            offsetof(MADB_Dsn, JWT),               DSN_TYPE_STRING, 0, 0},
   {"TEST_MODE",      offsetof(MADB_Dsn, TestMode),          DSN_TYPE_INT,    0, 0}, /* Use some mock functions for testing */
+  {"PARSE_CACHE",    offsetof(MADB_Dsn, ParseCacheSize),    DSN_TYPE_INT,    0, 0}, /* Number of parsed queries cached per connection */
+  {"PS_CACHE",       offsetof(MADB_Dsn, StmtCacheSize),     DSN_TYPE_INT,    0, 0}, /* Number of server-side prepared statements cached per connection */
+  {"DRAIN_KILL_SIZE", offsetof(MADB_Dsn, DrainKillSize),    DSN_TYPE_INT,    0, 0}, /* Bytes of unread result to skip before the query is killed on cursor close */
+  {"SERVER_INFO_TTL", offsetof(MADB_Dsn, ServerInfoTtl),  DSN_TYPE_INT,    0, 0}, /* Seconds the server version and database charset are shared between connections, 0 disables */
+  {"HOST_STRATEGY",  offsetof(MADB_Dsn, HostStrategy),      DSN_TYPE_STRING, 0, 0}, /* Order multiple hosts of SERVER are tried in: SEQUENTIAL, RANDOM, ROUNDROBIN, RACE or LATENCY */
+  {"RACE_DELAY",     offsetof(MADB_Dsn, RaceDelay),         DSN_TYPE_INT,    0, 0}, /* Milliseconds before the next host joins the RACE */
+  {"READ_SERVER",    offsetof(MADB_Dsn, ReadServer),        DSN_TYPE_STRING, 0, 0}, /* Hosts SQL_MODE_READ_ONLY connections go to, e.g. child aggregators. Same syntax as SERVER */
+  {"LARGE_PAGES",    offsetof(MADB_Dsn, LargePages),        DSN_TYPE_BOOL,   0, 0}, /* Buffered result sets are kept in big, huge page backed memory blocks */
   /* Aliases. Here offset is index of aliased key */
   {"SERVERNAME",     DSNKEY_SERVER_INDEX,                   DSN_TYPE_STRING, 0, 1},
   {"USER",           DSNKEY_UID_INDEX,                      DSN_TYPE_STRING, 0, 1},
@@ -127,6 +135,10 @@ void MADB_DSN_SetDefaults(MADB_Dsn *Dsn)
   Dsn->IsTcpIp= 1;
   Dsn->NoSsps = 1;
   Dsn->NoCache = 1;
+  Dsn->ParseCacheSize = MADB_PARSE_CACHE_DEFAULT_SIZE;
+  Dsn->StmtCacheSize = MADB_STMT_CACHE_DEFAULT_SIZE;
+  Dsn->ServerInfoTtl = MADB_SERVER_INFO_DEFAULT_TTL;
+  Dsn->RaceDelay = MADB_RACE_DEFAULT_DELAY;
 }
 /* }}} */
 
@@ -178,6 +190,8 @@ void MADB_DSN_Free(MADB_Dsn *Dsn)
   MADB_FREE(Dsn->JWT);
   MADB_FREE(Dsn->ServerKey);
   MADB_FREE(Dsn->TlsKeyPwd);
+  MADB_FREE(Dsn->HostStrategy);
+  MADB_FREE(Dsn->ReadServer);
   if (Dsn->FreeMe)
     MADB_FREE(Dsn); 
 }
@@ -654,18 +668,17 @@ BOOL MADB_ReadConnString(MADB_Dsn *Dsn, const char *String, int Length, char Del
 }
 /* }}} */
 
-/* {{{ MADB_DsnToString */
+/* {{{ MADB_DsnToString - writes as much of the connection string, as fits into OutString. Returns the length of the
+       complete string, which may be bigger than OutLength */
 SQLULEN MADB_DsnToString(MADB_Dsn *Dsn, char *OutString, SQLULEN OutLength)
 {
   int     i=           0;
   SQLULEN TotalLength= 0;
-  char    *p=          OutString;
   char    *Value=      NULL;
-  char    TmpStr[2048]= { '\0' };
   char    IntVal[12];
-  int     CpyLength;
+  my_bool Truncated=   OutString == NULL || OutLength == 0;
 
-  if (OutLength && OutString)
+  if (!Truncated)
     OutString[0]= '\0';
   
   while (DsnKeys[i].DsnKey)
@@ -713,17 +726,25 @@ SQLULEN MADB_DsnToString(MADB_Dsn *Dsn, char *OutString, SQLULEN OutLength)
     if (Value)
     {
       my_bool isSpecial= (strchr(Value, ' ') ||  strchr(Value, ';') || strchr(Value, '@'));
-      CpyLength= _snprintf(TmpStr + TotalLength, 2048 - TotalLength, "%s%s=%s%s%s", (TotalLength) ? ";" : "",
-                             DsnKeys[i].DsnKey, isSpecial ? "{" : "", Value, isSpecial ? "}" : "");
-      TotalLength+= CpyLength;
+      /* [;]KEY=[{]VALUE[}] */
+      SQLULEN ItemLength= (TotalLength ? 1 : 0) + strlen(DsnKeys[i].DsnKey) + 1 + strlen(Value) + (isSpecial ? 2 : 0);
+
+      if (!Truncated)
+      {
+        _snprintf(OutString + TotalLength, (size_t)(OutLength - TotalLength), "%s%s=%s%s%s", (TotalLength) ? ";" : "",
+                  DsnKeys[i].DsnKey, isSpecial ? "{" : "", Value, isSpecial ? "}" : "");
+        if (TotalLength + ItemLength >= OutLength)
+        {
+          /* _snprintf does not terminate the truncated string on Windows */
+          OutString[OutLength - 1]= '\0';
+          Truncated= TRUE;
+        }
+      }
+      TotalLength+= ItemLength;
     }
     ++i;
   }
 
-  if (OutLength && OutString)
-  {
-    strncpy_s(OutString, OutLength, TmpStr, TotalLength);
-  }
   return TotalLength;
 }
 /* }}} */
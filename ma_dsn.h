@@ -147,6 +147,14 @@ typedef struct st_madb_dsn
   my_bool IsBrowserAuth;
   char *JWT;
   int TestMode;
+  unsigned int ParseCacheSize;
+  unsigned int StmtCacheSize;
+  unsigned int DrainKillSize;
+  unsigned int ServerInfoTtl;
+  char *HostStrategy;
+  char *ReadServer;
+  unsigned int RaceDelay;
+  my_bool LargePages;
   /* --- Internal --- */
   int isPrompt;
   MADB_DsnKey *Keys;
@@ -193,7 +201,7 @@ BOOL        MADB_DSN_PossibleConnect    (MADB_Dsn *Dsn);
     if ((len) == SQL_NTS)\
       (len)=(SQLSMALLINT)strlen((value));\
     MADB_FREE((dsn)->item);\
-    (dsn)->item= (char *)calloc(len + 1, sizeof(char));\
+    (dsn)->item= (char *)MADB_CALLOC(len + 1);\
     memcpy((dsn)->item, (value),(len));\
   }
 
@@ -53,8 +53,11 @@ SQLRETURN MADB_EnvFree(MADB_Env *Env)
 {
   if (!Env)
     return SQL_ERROR;
+  MADB_ListFree(Env->PoolIds, TRUE);
+  MADB_QueryTimersFree(Env);
+  MADB_KillConnsFree(Env);
   DeleteCriticalSection(&Env->cs);
-  free(Env);
+  MADB_FREE(Env);
 
 #ifdef _WIN32
   WSACleanup();
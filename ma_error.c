@@ -345,6 +345,9 @@ SQLRETURN MADB_GetDiagField(SQLSMALLINT HandleType, SQLHANDLE Handle,
      Desc= (MADB_Desc *)Handle;
      Err= &Desc->Error;
      break;
+   case SQL_HANDLE_DBC_INFO_TOKEN:
+     Err= &((MADB_DbcInfoToken *)Handle)->Error;
+     break;
    default:
      return SQL_INVALID_HANDLE;
   }
@@ -153,12 +153,12 @@ SQLRETURN MADB_FakeRequest(MADB_Stmt *Stmt, const char * const *fields, const en
     return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, errMsg, 0);
   }
   int i, rc;
-  unsigned long *max_lengts = calloc(1, sizeof(unsigned long) * fieldsLength);
+  unsigned long *max_lengts = MADB_CALLOC(sizeof(unsigned long) * fieldsLength);
   if (constructData(&(Stmt->stmt->result), data, dataLength, fieldsLength, max_lengts))
   {
     ma_free_root(fields_ma_alloc_root, MYF(0));
     ma_free_root(alloc_root, MYF(0));
-    free(max_lengts);
+    MADB_FREE(max_lengts);
     return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to allocate memory for data", 0);
   }
   for(i = 0; i < fieldsLength; i++)
@@ -167,11 +167,11 @@ SQLRETURN MADB_FakeRequest(MADB_Stmt *Stmt, const char * const *fields, const en
     {
         ma_free_root(fields_ma_alloc_root, MYF(0));
         ma_free_root(alloc_root, MYF(0));
-        free(max_lengts);
+        MADB_FREE(max_lengts);
         return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to allocate memory for fields", 0);
     }
   }
-  free(max_lengts);
+  MADB_FREE(max_lengts);
   Stmt->stmt->state = MYSQL_STMT_USE_OR_STORE_CALLED;
   Stmt->stmt->result_cursor = Stmt->stmt->result.data;
   Stmt->State = MADB_SS_PREPARED;
@@ -16,6 +16,8 @@
    or write to the Free Software Foundation, Inc., 
    51 Franklin St., Fifth Floor, Boston, MA 02110, USA
 *************************************************************************************/
+#include "ma_global.h"
+#include "ma_sys.h"
 #include <ma_odbc.h>
 #include <mysql.h>
 #include <stdint.h>
@@ -65,6 +67,282 @@ MYSQL_STMT* MADB_NewStmtHandle(MADB_Stmt *Stmt)
   return stmt;
 }
 
+/*----------------- Statement's arena ------------------*/
+
+/* {{{ MADB_StmtArenaInit - blocks of the arena are taken by the client library with plain malloc, thus neither the
+       allocator hooks nor the connection's memory counters see them */
+void MADB_StmtArenaInit(MADB_Stmt *Stmt)
+{
+  ma_init_alloc_root(&Stmt->Arena, MADB_STMT_ARENA_BLOCK_SIZE, MADB_STMT_ARENA_BLOCK_SIZE);
+}
+/* }}} */
+
+/* {{{ MADB_StmtArenaReset - releases everything allocated from the arena, except its first block. Nothing, allocated
+       from the arena before, may be used after this */
+void MADB_StmtArenaReset(MADB_Stmt *Stmt)
+{
+  ma_free_root(&Stmt->Arena, MYF(MY_KEEP_PREALLOC));
+  Stmt->FetchBuffers=     NULL;
+  Stmt->FetchBufferCount= 0;
+  Stmt->SavedFlags.Buffer= NULL;
+  Stmt->SavedFlags.Size=   0;
+}
+/* }}} */
+
+/* {{{ MADB_StmtArenaFree */
+void MADB_StmtArenaFree(MADB_Stmt *Stmt)
+{
+  ma_free_root(&Stmt->Arena, MYF(0));
+  Stmt->FetchBuffers=     NULL;
+  Stmt->FetchBufferCount= 0;
+  Stmt->SavedFlags.Buffer= NULL;
+  Stmt->SavedFlags.Size=   0;
+}
+/* }}} */
+
+/* {{{ MADB_StmtArenaBuffer - returns zero-filled buffer of at least Size bytes. Memory of the Buffer is reused if it
+       is big enough, or new one is taken from the statement's arena otherwise. Returns NULL on OOM */
+char *MADB_StmtArenaBuffer(MADB_Stmt *Stmt, MADB_ArenaBuffer *Buffer, size_t Size)
+{
+  if (Buffer->Buffer == NULL || Buffer->Size < Size)
+  {
+    char *New= (char *)ma_alloc_root(&Stmt->Arena, Size);
+
+    if (New == NULL)
+    {
+      return NULL;
+    }
+    Buffer->Buffer= New;
+    Buffer->Size=   Size;
+  }
+  memset(Buffer->Buffer, 0, Size);
+
+  return Buffer->Buffer;
+}
+/* }}} */
+
+/* {{{ MADB_StmtFetchBuffer - conversion buffer for the result column. Buffers stay with their columns till the arena
+       reset, thus fetching of the rows does not allocate anything, once they are big enough */
+char *MADB_StmtFetchBuffer(MADB_Stmt *Stmt, unsigned int Column, size_t Size)
+{
+  if (Column >= Stmt->FetchBufferCount)
+  {
+    unsigned int      Count= MAX(Column + 1, mysql_stmt_field_count(Stmt->stmt));
+    MADB_ArenaBuffer *Buffers= (MADB_ArenaBuffer *)ma_alloc_root(&Stmt->Arena, Count * sizeof(MADB_ArenaBuffer));
+
+    if (Buffers == NULL)
+    {
+      return NULL;
+    }
+    memset(Buffers, 0, Count * sizeof(MADB_ArenaBuffer));
+    if (Stmt->FetchBuffers != NULL)
+    {
+      memcpy(Buffers, Stmt->FetchBuffers, Stmt->FetchBufferCount * sizeof(MADB_ArenaBuffer));
+    }
+    Stmt->FetchBuffers=     Buffers;
+    Stmt->FetchBufferCount= Count;
+  }
+
+  return MADB_StmtArenaBuffer(Stmt, &Stmt->FetchBuffers[Column], Size);
+}
+/* }}} */
+
+/*----------------- Server-side prepared statements cache ------------------*/
+
+typedef struct
+{
+  MADB_List   ListItem;
+  char       *Query;
+  char       *Schema;
+  MYSQL_STMT *stmt;
+} MADB_STMT_CACHE_ENTRY;
+
+static my_bool MADB_SchemaEquals(const char *Schema1, const char *Schema2)
+{
+  if (Schema1 == NULL || Schema2 == NULL)
+  {
+    return Schema1 == Schema2;
+  }
+  return strcmp(Schema1, Schema2) == 0;
+}
+
+static void MADB_StmtCacheFreeEntry(MADB_STMT_CACHE_ENTRY *Entry)
+{
+  mysql_stmt_close(Entry->stmt);
+  MADB_FREE(Entry->Query);
+  MADB_FREE(Entry->Schema);
+  MADB_FREE(Entry);
+}
+
+static MADB_List* MADB_StmtCacheFind(MADB_Dbc *Dbc, const char *Query)
+{
+  MADB_List *Item;
+  MADB_STMT_CACHE_ENTRY *Entry;
+
+  /* mysql->db is stale after the schema change, that the server has not reported, and statements, prepared in the
+     previous schema, would match */
+  if (Dbc->CurrentDbUnknown)
+  {
+    return NULL;
+  }
+  for (Item= Dbc->StmtCache; Item != NULL; Item= Item->next)
+  {
+    Entry= (MADB_STMT_CACHE_ENTRY *)Item->data;
+
+    if (strcmp(Entry->Query, Query) == 0 && MADB_SchemaEquals(Entry->Schema, Dbc->mariadb->db))
+    {
+      return Item;
+    }
+  }
+  return NULL;
+}
+
+/* {{{ MADB_StmtCacheHas - Caller has to hold the connection lock */
+my_bool MADB_StmtCacheHas(MADB_Dbc *Dbc, const char *Query)
+{
+  return MADB_StmtCacheFind(Dbc, Query) != NULL;
+}
+/* }}} */
+
+/* {{{ MADB_StmtCacheGet
+   Returns the cached server-side prepared statement for the query in the current schema,
+   and removes it from the cache. NULL if there is none. Caller has to hold the connection lock */
+MYSQL_STMT* MADB_StmtCacheGet(MADB_Dbc *Dbc, const char *Query)
+{
+  MADB_List *Item= MADB_StmtCacheFind(Dbc, Query);
+  MADB_STMT_CACHE_ENTRY *Entry;
+  MYSQL_STMT *stmt;
+
+  if (Item == NULL)
+  {
+    return NULL;
+  }
+
+  Entry= (MADB_STMT_CACHE_ENTRY *)Item->data;
+  Dbc->StmtCache= MADB_ListDelete(Dbc->StmtCache, Item);
+  --Dbc->StmtCacheCount;
+
+  stmt= Entry->stmt;
+  Entry->stmt= NULL;
+  MADB_FREE(Entry->Query);
+  MADB_FREE(Entry->Schema);
+  MADB_FREE(Entry);
+
+  /* Connection was lost(and possibly restored) since the statement was cached */
+  if (stmt->mysql == NULL)
+  {
+    mysql_stmt_close(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+/* }}} */
+
+/* {{{ MADB_StmtCachePut
+   Puts the handle of the prepared on the server statement to the connection's cache. Returns TRUE if the handle
+   was taken by the cache, and FALSE if caller still owns it. Caller has to hold the connection lock */
+static my_bool MADB_StmtCachePut(MADB_Dbc *Dbc, const char *Query, MYSQL_STMT *stmt)
+{
+  MADB_STMT_CACHE_ENTRY *Entry;
+  MADB_List *Last;
+  unsigned long i;
+  my_bool LongDataSent= FALSE;
+
+  if (Dbc->Dsn == NULL || Dbc->Dsn->StmtCacheSize == 0 || Query == NULL || Dbc->mariadb == NULL ||
+      Dbc->CurrentDbUnknown || stmt->mysql == NULL || !stmt->prepared_on_server || stmt->stmt_id == (unsigned long)-1 ||
+      stmt->state < MYSQL_STMT_PREPARED || mysql_more_results(Dbc->mariadb))
+  {
+    return FALSE;
+  }
+
+  for (i= 0; i < stmt->param_count && stmt->params != NULL; ++i)
+  {
+    LongDataSent= LongDataSent || stmt->params[i].long_data_used;
+  }
+  /* Pending data of the abandoned SQLPutData sequence would be used by the server on next execution */
+  if (LongDataSent && mysql_stmt_reset(stmt))
+  {
+    return FALSE;
+  }
+
+  if ((Entry= (MADB_STMT_CACHE_ENTRY *)MADB_CALLOC(sizeof(MADB_STMT_CACHE_ENTRY))) == NULL ||
+      (Entry->Query= MADB_STRDUP(Query)) == NULL ||
+      (Dbc->mariadb->db != NULL && (Entry->Schema= MADB_STRDUP(Dbc->mariadb->db)) == NULL))
+  {
+    if (Entry != NULL)
+    {
+      MADB_FREE(Entry->Query);
+      MADB_FREE(Entry);
+    }
+    return FALSE;
+  }
+
+  /* Client side only - results are discarded, and the handle is made looking like just prepared one. Bindings point
+     to the buffers of the ODBC statement, that may not exist when the handle is reused */
+  mysql_stmt_free_result(stmt);
+  if (stmt->params != NULL)
+  {
+    memset(stmt->params, 0, stmt->param_count * sizeof(MYSQL_BIND));
+  }
+  if (stmt->bind != NULL)
+  {
+    memset(stmt->bind, 0, stmt->field_count * sizeof(MYSQL_BIND));
+  }
+  stmt->bind_param_done= stmt->bind_result_done= 0;
+  Entry->stmt= stmt;
+
+  while (Dbc->StmtCacheCount >= Dbc->Dsn->StmtCacheSize)
+  {
+    for (Last= Dbc->StmtCache; Last->next != NULL; Last= Last->next);
+    Dbc->StmtCache= MADB_ListDelete(Dbc->StmtCache, Last);
+    MADB_StmtCacheFreeEntry((MADB_STMT_CACHE_ENTRY *)Last->data);
+    --Dbc->StmtCacheCount;
+  }
+
+  Entry->ListItem.data= (void *)Entry;
+  Dbc->StmtCache= MADB_ListAdd(Dbc->StmtCache, &Entry->ListItem);
+  ++Dbc->StmtCacheCount;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_StmtCacheFree - closes all cached statements. Has to be called before the connection is closed */
+void MADB_StmtCacheFree(MADB_Dbc *Dbc)
+{
+  MADB_List *Item, *Next;
+
+  for (Item= Dbc->StmtCache; Item != NULL; Item= Next)
+  {
+    Next= Item->next;
+    MADB_StmtCacheFreeEntry((MADB_STMT_CACHE_ENTRY *)Item->data);
+  }
+  Dbc->StmtCache= NULL;
+  Dbc->StmtCacheCount= 0;
+}
+/* }}} */
+
+/* {{{ MADB_StmtReleaseHandle
+   Releases Stmt->stmt - server-side prepared statement goes to the connection's cache if possible, closed otherwise */
+void MADB_StmtReleaseHandle(MADB_Stmt *Stmt)
+{
+  if (Stmt->stmt == NULL)
+  {
+    return;
+  }
+  MADB_StmtDrainResult(Stmt, Stmt->stmt);
+  if (MADB_SSPS_ENABLED(Stmt) && !QUERY_IS_MULTISTMT(Stmt->Query) &&
+      MADB_StmtCachePut(Stmt->Connection, STMT_STRING(Stmt), Stmt->stmt))
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "-->cached %0x", Stmt->stmt);
+    Stmt->stmt= NULL;
+    return;
+  }
+  MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
+  MADB_STMT_CLOSE_STMT(Stmt);
+}
+/* }}} */
+
 /* Required, but not sufficient condition */
 BOOL QueryIsPossiblyMultistmt(MADB_QUERY *Query)
 {
@@ -220,42 +498,14 @@ end:
   return Count;
 }
 
-int SetDBCharsetnr(MADB_Dbc *Connection)
+/* {{{ SetDBCharsetnr - sets character set of the current database by its collation name */
+void SetDBCharsetnr(MADB_Dbc *Connection, const char *collation)
 {
-  MYSQL_RES *res;
-  MYSQL_ROW row;
-  char *collation;
-  const char *query = "SELECT @@collation_database";
+  const MARIADB_CHARSET_INFO *cs_info = collation != NULL ? mysql_find_charset_by_collation(collation) : NULL;
 
-  LOCK_MARIADB(Connection);
-  if (mysql_query(Connection->mariadb, query))
-  {
-    UNLOCK_MARIADB(Connection);
-    Connection->DBCharsetnr = 0;
-    return MADB_SetNativeError(&Connection->Error, SQL_HANDLE_DBC, Connection->mariadb);
-  }
-  res = mysql_store_result(Connection->mariadb);
-  UNLOCK_MARIADB(Connection);
-  if ((row = mysql_fetch_row(res)))
-  {
-    collation = (char*)row[0];
-  }
-  else
-  {
-    mysql_free_result(res);
-    Connection->DBCharsetnr = 0;
-    return 1;
-  }
-  const MARIADB_CHARSET_INFO *cs_info = mysql_find_charset_by_collation(collation);
-  mysql_free_result(res);
-  if (!cs_info)
-  {
-    Connection->DBCharsetnr = 0;
-    return 1;
-  }
-  Connection->DBCharsetnr = cs_info->nr;
-  return 0;
+  Connection->DBCharsetnr = cs_info != NULL ? cs_info->nr : 0;
 }
+/* }}} */
 
 
 /* {{{ MADB_CheckODBCType */
@@ -398,9 +648,9 @@ MYSQL_RES *MADB_GetDefaultColumnValues(MADB_Stmt *Stmt, MYSQL_FIELD *fields)
   
   MADB_InitDynamicString(&DynStr, "SELECT COLUMN_NAME, COLUMN_DEFAULT FROM INFORMATION_SCHEMA.COLUMNS WHERE TABLE_SCHEMA='", 512, 512);
   if (MADB_DynstrAppend(&DynStr, fields[0].db) ||
-      MADB_DynstrAppend(&DynStr, "' AND TABLE_NAME='") ||
+      MADB_DYNAPPENDCONST(&DynStr, "' AND TABLE_NAME='") ||
       MADB_DynstrAppend(&DynStr, fields[0].org_table) ||
-      MADB_DynstrAppend(&DynStr, "' AND COLUMN_NAME IN ("))
+      MADB_DYNAPPENDCONST(&DynStr, "' AND COLUMN_NAME IN ("))
     goto error;
 
   for (i=0; i < mysql_stmt_field_count(Stmt->stmt); i++)
@@ -413,12 +663,12 @@ MYSQL_RES *MADB_GetDefaultColumnValues(MADB_Stmt *Stmt, MYSQL_FIELD *fields)
     }
     if (MADB_DynstrAppend(&DynStr, i > 0 ? ",'" : "'") ||
       MADB_DynstrAppend(&DynStr, fields[i].org_name) ||
-      MADB_DynstrAppend(&DynStr, "'"))
+      MADB_DYNAPPENDCONST(&DynStr, "'"))
     {
       goto error;
     }
   }
-  if (MADB_DynstrAppend(&DynStr, ") AND COLUMN_DEFAULT IS NOT NULL"))
+  if (MADB_DYNAPPENDCONST(&DynStr, ") AND COLUMN_DEFAULT IS NOT NULL"))
     goto error;
 
   LOCK_MARIADB(Stmt->Connection);
@@ -442,7 +692,7 @@ char *MADB_GetDefaultColumnValue(MYSQL_RES *res, const char *Column)
   while ((row= mysql_fetch_row(res)))
   {
     if (_stricmp(row[0], Column) == 0)
-     return _strdup(row[1]);
+     return MADB_STRDUP(row[1]);
   }
   return NULL;
 }
@@ -1265,7 +1515,7 @@ SQLRETURN MADB_DaeStmt(MADB_Stmt *Stmt, SQLUSMALLINT Operation)
   case SQL_ADD:
     if (MADB_InitDynamicString(&DynStmt, "INSERT INTO ", 1024, 1024) ||
         MADB_DynStrAppendQuoted(&DynStmt, CatalogName) ||
-        MADB_DynstrAppend(&DynStmt, ".") ||
+        MADB_DYNAPPENDCONST(&DynStmt, ".") ||
         MADB_DynStrAppendQuoted(&DynStmt, TableName)||
         MADB_DynStrUpdateSet(Stmt, &DynStmt))
     {
@@ -1277,7 +1527,7 @@ SQLRETURN MADB_DaeStmt(MADB_Stmt *Stmt, SQLUSMALLINT Operation)
   case SQL_DELETE:
     if (MADB_InitDynamicString(&DynStmt, "DELETE FROM ", 1024, 1024) ||
         MADB_DynStrAppendQuoted(&DynStmt, CatalogName) ||
-        MADB_DynstrAppend(&DynStmt, ".") ||
+        MADB_DYNAPPENDCONST(&DynStmt, ".") ||
         MADB_DynStrAppendQuoted(&DynStmt, TableName) ||
         MADB_DynStrGetWhere(Stmt, &DynStmt, TableName, FALSE))
     {
@@ -1289,7 +1539,7 @@ SQLRETURN MADB_DaeStmt(MADB_Stmt *Stmt, SQLUSMALLINT Operation)
   case SQL_UPDATE:
     if (MADB_InitDynamicString(&DynStmt, "UPDATE ", 1024, 1024) ||
         MADB_DynStrAppendQuoted(&DynStmt, CatalogName) ||
-        MADB_DynstrAppend(&DynStmt, ".") ||
+        MADB_DYNAPPENDCONST(&DynStmt, ".") ||
         MADB_DynStrAppendQuoted(&DynStmt, TableName)||
         MADB_DynStrUpdateSet(Stmt, &DynStmt)||
         MADB_DynStrGetWhere(Stmt, &DynStmt, TableName, FALSE))
@@ -1516,19 +1766,19 @@ FieldDescrList *ProcessShowColumns(MYSQL_RES *res)
   int nRows = mysql_num_rows(res);
 
   MYSQL_ROW columnsRow;
-  FieldDescrList *fieldsResult = (FieldDescrList*)malloc(sizeof(FieldDescrList));
-  fieldsResult->list = (FieldDescr*)malloc(sizeof(FieldDescr) * nRows);
+  FieldDescrList *fieldsResult = (FieldDescrList*)MADB_ALLOC(sizeof(FieldDescrList));
+  fieldsResult->list = (FieldDescr*)MADB_ALLOC(sizeof(FieldDescr) * nRows);
   fieldsResult->n_fields = nRows;
 
   int rowNum = 0;
 
   while ((columnsRow = mysql_fetch_row(res)))
   {
-    (fieldsResult->list)[rowNum].FieldName = strdup(columnsRow[SHOW_COLUMNS_NAME_IDX]);
-    (fieldsResult->list)[rowNum].FieldTypeS2 = strdup(columnsRow[SHOW_COLUMNS_TYPE_IDX]);
+    (fieldsResult->list)[rowNum].FieldName = MADB_STRDUP(columnsRow[SHOW_COLUMNS_NAME_IDX]);
+    (fieldsResult->list)[rowNum].FieldTypeS2 = MADB_STRDUP(columnsRow[SHOW_COLUMNS_TYPE_IDX]);
     if (columnsRow[SHOW_COLUMNS_DEFAULT_VALUE_IDX] && *columnsRow[SHOW_COLUMNS_DEFAULT_VALUE_IDX])
     {
-      (fieldsResult->list)[rowNum].DefaultValue = strdup(columnsRow[SHOW_COLUMNS_DEFAULT_VALUE_IDX]);
+      (fieldsResult->list)[rowNum].DefaultValue = MADB_STRDUP(columnsRow[SHOW_COLUMNS_DEFAULT_VALUE_IDX]);
     }
     else
     {
@@ -1570,12 +1820,12 @@ void FreeFieldDescrList(FieldDescrList *allFields)
   int i;
   for (i = 0; i < allFields->n_fields; ++i)
   {
-    free(allFields->list[i].FieldName);
-    free(allFields->list[i].FieldTypeS2);
-    free(allFields->list[i].DefaultValue);
+    MADB_FREE(allFields->list[i].FieldName);
+    MADB_FREE(allFields->list[i].FieldTypeS2);
+    MADB_FREE(allFields->list[i].DefaultValue);
   }
-  free(allFields->list);
-  free(allFields);
+  MADB_FREE(allFields->list);
+  MADB_FREE(allFields);
 }
 
 /**
@@ -1601,15 +1851,15 @@ MYSQL_RES *S2_ShowKeysInTable(MADB_Stmt  *stmt,
 
 	if (catalog && *catalog)
 	{
-    MADB_DynstrAppend(&query, "`");
+    MADB_DYNAPPENDCONST(&query, "`");
     MADB_DynstrAppendMem(&query, catalog, catalog_length);
-    MADB_DynstrAppend(&query, "`");
-    MADB_DynstrAppend(&query, ".");
+    MADB_DYNAPPENDCONST(&query, "`");
+    MADB_DYNAPPENDCONST(&query, ".");
 	}
 
-  MADB_DynstrAppend(&query, "`");
+  MADB_DYNAPPENDCONST(&query, "`");
   MADB_DynstrAppendMem(&query, table, table_length);
-  MADB_DynstrAppend(&query, "`");
+  MADB_DYNAPPENDCONST(&query, "`");
 
   LOCK_MARIADB(stmt->Connection);
   if (mysql_real_query(stmt->Connection->mariadb, query.str, query.length))
@@ -1636,17 +1886,17 @@ MYSQL_RES *S2_ListFields(MADB_Stmt  *stmt,
 
 	if (catalog && *catalog)
 	{
-    MADB_DynstrAppend(&query, "`");
+    MADB_DYNAPPENDCONST(&query, "`");
     MADB_DynstrAppendMem(&query, catalog, catalog_length);
-    MADB_DynstrAppend(&query, "`");
-    MADB_DynstrAppend(&query, ".");
+    MADB_DYNAPPENDCONST(&query, "`");
+    MADB_DYNAPPENDCONST(&query, ".");
 	}
 
-  MADB_DynstrAppend(&query, "`");
+  MADB_DYNAPPENDCONST(&query, "`");
   MADB_DynstrAppendMem(&query, table, table_length);
-  MADB_DynstrAppend(&query, "`");
+  MADB_DYNAPPENDCONST(&query, "`");
 
-  MADB_DynstrAppend(&query, " LIMIT 0");
+  MADB_DYNAPPENDCONST(&query, " LIMIT 0");
 
   LOCK_MARIADB(stmt->Connection);
   if (mysql_real_query(stmt->Connection->mariadb, query.str, query.length))
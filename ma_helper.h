@@ -21,6 +21,15 @@
 
 void CloseMultiStatements(MADB_Stmt *Stmt);
 MYSQL_STMT* MADB_NewStmtHandle(MADB_Stmt *Stmt);
+void  MADB_StmtArenaInit(MADB_Stmt *Stmt);
+void  MADB_StmtArenaReset(MADB_Stmt *Stmt);
+void  MADB_StmtArenaFree(MADB_Stmt *Stmt);
+char *MADB_StmtArenaBuffer(MADB_Stmt *Stmt, MADB_ArenaBuffer *Buffer, size_t Size);
+char *MADB_StmtFetchBuffer(MADB_Stmt *Stmt, unsigned int Column, size_t Size);
+MYSQL_STMT* MADB_StmtCacheGet(MADB_Dbc *Dbc, const char *Query);
+my_bool MADB_StmtCacheHas(MADB_Dbc *Dbc, const char *Query);
+void MADB_StmtCacheFree(MADB_Dbc *Dbc);
+void MADB_StmtReleaseHandle(MADB_Stmt *Stmt);
 BOOL QueryIsPossiblyMultistmt(MADB_QUERY *Query);
 int  SqlRtrim(char *StmtStr, int Length);
 unsigned int GetMultiStatements(MADB_Stmt *Stmt, BOOL ExecDirect);
@@ -74,7 +83,7 @@ BOOL          MADB_IsIntType    (SQLSMALLINT ConciseType);
 /* For multistatement picks stmt handler pointed by stored index, and sets it as "current" stmt handler */
 void          MADB_InstallStmt  (MADB_Stmt *Stmt, MYSQL_STMT *stmt);
 
-int SetDBCharsetnr(MADB_Dbc *Connection);
+void SetDBCharsetnr(MADB_Dbc *Connection, const char *collation);
 
 /* for dummy binding */
 extern my_bool DummyError;
@@ -140,14 +149,18 @@ void FreeFieldDescrList(FieldDescrList *allFields);
 
 #define BUFFER_CHAR_LEN(blen,wchar) (wchar) ? (blen) / sizeof(SQLWCHAR) : (blen)
 
+/* Driver's memory goes via the allocator hooks(ma_allocator.h). Nothing, allocated with these, may be freed with plain
+   free(), and vice versa */
 #define MADB_FREE(a) do { \
-  free((a));\
+  MADB_Free((a));\
   (a)= NULL; \
 } while(0)
 
-#define MADB_ALLOC(a) malloc((a))
-#define MADB_CALLOC(a) calloc((a) > 0 ? (a) : 1, sizeof(char))
-#define MADB_REALLOC(a,b) realloc((a),(b))
+#define MADB_ALLOC(a) MADB_Malloc((a))
+#define MADB_CALLOC(a) MADB_Calloc((a) > 0 ? (a) : 1)
+#define MADB_REALLOC(a,b) MADB_Realloc((a),(b))
+#define MADB_STRDUP(a) MADB_Strndup((a), strlen(a))
+#define MADB_STRNDUP(a,b) MADB_Strndup((a),(b))
 
 #ifdef WIN32
 #define MADB_ALLOCA(sz) _alloca((size_t) (sz))
@@ -159,9 +172,9 @@ void FreeFieldDescrList(FieldDescrList *allFields);
 #define MADB_RESET(ptr, newptr) do {\
   char *local_new_ptr= (newptr);\
   if (local_new_ptr != ptr) {\
-    free((char*)(ptr));\
+    MADB_Free((char*)(ptr));\
     if (local_new_ptr != NULL)\
-      (ptr)= _strdup(local_new_ptr);\
+      (ptr)= MADB_STRDUP(local_new_ptr);\
     else\
       (ptr)= NULL;\
   }\
@@ -0,0 +1,612 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+#include <errmsg.h>
+
+#ifdef _WIN32
+# define MADB_POLLFD     WSAPOLLFD
+# define MADB_POLL       WSAPoll
+# define MADB_SHUT_RDWR  SD_BOTH
+#else
+# include <poll.h>
+# include <sys/socket.h>
+# define MADB_POLLFD     struct pollfd
+# define MADB_POLL       poll
+# define MADB_SHUT_RDWR  SHUT_RDWR
+#endif
+
+typedef struct st_madb_racer
+{
+  int                Status;   /* Events the racer waits for, 0 if it has finished or has not started */
+  unsigned long long Deadline; /* When the MYSQL_WAIT_TIMEOUT expires */
+  unsigned int       Pfd;      /* Index of its socket in the poll array */
+  unsigned long long Started;  /* us, for the host's latency */
+} MADB_Racer;
+
+static const char *MADB_HostStrategyName[]= {"SEQUENTIAL", "RANDOM", "ROUNDROBIN", "RACE", "LATENCY"};
+
+/* Shared by all connections of the process. Races on these only affect the order, in which hosts are tried */
+static unsigned int MADB_RoundRobinCounter= 0;
+static unsigned int MADB_RandomState= 0;
+
+#define MADB_HOST_LATENCY_WEIGHT 0.25 /* Weight of the new sample in the moving average */
+
+typedef struct st_madb_host_stats
+{
+  char               Name[128];
+  unsigned int       Port;
+  double             Latency;    /* us, 0 - no samples yet */
+  unsigned int       Failures;   /* In a row */
+  time_t             AvoidUntil;
+  unsigned long long LastUsed;
+} MADB_HostStats;
+
+/* Static initialization - same as for the server info cache */
+#ifdef _WIN32
+static SRWLOCK HostStatsLock= SRWLOCK_INIT;
+# define LOCK_HOST_STATS()   AcquireSRWLockExclusive(&HostStatsLock)
+# define UNLOCK_HOST_STATS() ReleaseSRWLockExclusive(&HostStatsLock)
+#else
+static pthread_mutex_t HostStatsLock= PTHREAD_MUTEX_INITIALIZER;
+# define LOCK_HOST_STATS()   pthread_mutex_lock(&HostStatsLock)
+# define UNLOCK_HOST_STATS() pthread_mutex_unlock(&HostStatsLock)
+#endif
+
+static MADB_HostStats     HostStats[MADB_HOST_STATS_MAX_ENTRIES];
+static unsigned int       HostStatsCount= 0;
+static unsigned long long HostStatsTick= 0;
+
+/* {{{ MADB_HostStrategy - returns strategy with the given name, or -1 if the name is unknown. Empty name means
+       SEQUENTIAL */
+int MADB_HostStrategy(const char *Name)
+{
+  int i;
+
+  if (MADB_IS_EMPTY(Name))
+  {
+    return MADB_HOSTS_SEQUENTIAL;
+  }
+  for (i= 0; i < (int)(sizeof(MADB_HostStrategyName)/sizeof(MADB_HostStrategyName[0])); ++i)
+  {
+    if (_stricmp(Name, MADB_HostStrategyName[i]) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+/* }}} */
+
+/* {{{ MADB_HostListInit - splits comma separated list of hosts. Host w/out port gets DefaultPort. IPv6 address with
+       port has to be enclosed in square brackets. Returns FALSE if the list has no hosts, or on OOM */
+my_bool MADB_HostListInit(MADB_HostList *List, const char *Servers, unsigned int DefaultPort)
+{
+  const char  *Ptr;
+  char        *Next, *Entry, *Colon;
+  unsigned int Count= 1;
+
+  memset(List, 0, sizeof(MADB_HostList));
+
+  if (Servers == NULL)
+  {
+    return FALSE;
+  }
+  for (Ptr= Servers; *Ptr != '\0'; ++Ptr)
+  {
+    if (*Ptr == ',')
+    {
+      ++Count;
+    }
+  }
+
+  if ((List->Buffer= MADB_STRDUP(Servers)) == NULL ||
+      (List->Hosts= (MADB_Host *)MADB_CALLOC(Count * sizeof(MADB_Host))) == NULL)
+  {
+    MADB_HostListFree(List);
+    return FALSE;
+  }
+
+  Next= List->Buffer;
+  while (Next != NULL)
+  {
+    Entry= Next;
+    if ((Next= strchr(Next, ',')) != NULL)
+    {
+      *Next++= '\0';
+    }
+    Entry= trim(Entry);
+    if (*Entry == '\0')
+    {
+      continue;
+    }
+
+    Colon= NULL;
+    if (*Entry == '[')
+    {
+      char *Bracket= strchr(Entry, ']');
+
+      if (Bracket != NULL)
+      {
+        *Bracket= '\0';
+        ++Entry;
+        if (Bracket[1] == ':')
+        {
+          Colon= Bracket + 1;
+        }
+      }
+    }
+    /* More than one colon w/out brackets is the IPv6 address w/out port */
+    else if ((Colon= strchr(Entry, ':')) != NULL && strchr(Colon + 1, ':') != NULL)
+    {
+      Colon= NULL;
+    }
+
+    List->Hosts[List->Count].Port= DefaultPort;
+    if (Colon != NULL)
+    {
+      *Colon= '\0';
+      List->Hosts[List->Count].Port= (unsigned int)strtoul(Colon + 1, NULL, 10);
+    }
+    List->Hosts[List->Count].Name= Entry;
+    ++List->Count;
+  }
+
+  if (List->Count == 0)
+  {
+    MADB_HostListFree(List);
+    return FALSE;
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_HostRandom - xorshift, to not disturb the sequence of application's rand() */
+static unsigned int MADB_HostRandom()
+{
+  unsigned int x= MADB_RandomState;
+
+  if (x == 0)
+  {
+    x= (unsigned int)time(NULL) ^ (unsigned int)(size_t)&x;
+    if (x == 0)
+    {
+      x= 1;
+    }
+  }
+  x^= x << 13;
+  x^= x >> 17;
+  x^= x << 5;
+  MADB_RandomState= x;
+
+  return x;
+}
+/* }}} */
+
+/* {{{ MADB_HostTime - monotonic time in microseconds */
+unsigned long long MADB_HostTime()
+{
+#ifdef _WIN32
+  LARGE_INTEGER Frequency, Now;
+
+  QueryPerformanceFrequency(&Frequency);
+  QueryPerformanceCounter(&Now);
+  return (unsigned long long)(Now.QuadPart / Frequency.QuadPart * 1000000 +
+                              Now.QuadPart % Frequency.QuadPart * 1000000 / Frequency.QuadPart);
+#else
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (unsigned long long)Now.tv_sec * 1000000 + Now.tv_nsec / 1000;
+#endif
+}
+/* }}} */
+
+/* {{{ MADB_HostStatsFind - returns statistics entry of the host. If there is none, and Create is TRUE, the entry is
+       created, replacing the least recently used one, if there is no room. Caller has to hold the lock */
+static MADB_HostStats *MADB_HostStatsFind(const char *Name, unsigned int Port, my_bool Create)
+{
+  MADB_HostStats *Stats= NULL;
+  unsigned int    i;
+
+  if (Name == NULL || strlen(Name) >= sizeof(HostStats[0].Name))
+  {
+    return NULL;
+  }
+  for (i= 0; i < HostStatsCount; ++i)
+  {
+    if (HostStats[i].Port == Port && strcmp(HostStats[i].Name, Name) == 0)
+    {
+      Stats= &HostStats[i];
+      break;
+    }
+  }
+
+  if (Stats == NULL)
+  {
+    if (!Create)
+    {
+      return NULL;
+    }
+    if (HostStatsCount < MADB_HOST_STATS_MAX_ENTRIES)
+    {
+      Stats= &HostStats[HostStatsCount++];
+    }
+    else
+    {
+      Stats= &HostStats[0];
+      for (i= 1; i < HostStatsCount; ++i)
+      {
+        if (HostStats[i].LastUsed < Stats->LastUsed)
+        {
+          Stats= &HostStats[i];
+        }
+      }
+    }
+    memset(Stats, 0, sizeof(MADB_HostStats));
+    strcpy(Stats->Name, Name);
+    Stats->Port= Port;
+  }
+  Stats->LastUsed= ++HostStatsTick;
+
+  return Stats;
+}
+/* }}} */
+
+/* {{{ MADB_HostSuccess - records Latency(us) of the successful connect or ping of the host */
+void MADB_HostSuccess(const char *Name, unsigned int Port, unsigned long long Latency)
+{
+  MADB_HostStats *Stats;
+
+  LOCK_HOST_STATS();
+  if ((Stats= MADB_HostStatsFind(Name, Port, TRUE)) != NULL)
+  {
+    if (Stats->Latency == 0)
+    {
+      Stats->Latency= (double)Latency;
+    }
+    else
+    {
+      Stats->Latency+= MADB_HOST_LATENCY_WEIGHT * ((double)Latency - Stats->Latency);
+    }
+    Stats->Failures=   0;
+    Stats->AvoidUntil= 0;
+  }
+  UNLOCK_HOST_STATS();
+}
+/* }}} */
+
+/* {{{ MADB_HostFailure - records failure to reach the host. After MADB_HOST_MAX_FAILURES in a row the host is avoided
+       for MADB_HOST_AVOID_TIME. Once that is over, the host is tried again, and the single failure is enough to
+       avoid it again */
+void MADB_HostFailure(const char *Name, unsigned int Port)
+{
+  MADB_HostStats *Stats;
+
+  LOCK_HOST_STATS();
+  if ((Stats= MADB_HostStatsFind(Name, Port, TRUE)) != NULL && ++Stats->Failures >= MADB_HOST_MAX_FAILURES)
+  {
+    Stats->AvoidUntil= time(NULL) + MADB_HOST_AVOID_TIME;
+  }
+  UNLOCK_HOST_STATS();
+}
+/* }}} */
+
+/* {{{ MADB_HostListOrder - reorders hosts in the order they should be tried with the Strategy */
+void MADB_HostListOrder(MADB_HostList *List, int Strategy)
+{
+  MADB_HostStats *Stats;
+  MADB_Host       Tmp;
+  unsigned int    i, j;
+  time_t          Now= time(NULL);
+
+  if (List->Count < 2)
+  {
+    return;
+  }
+
+  LOCK_HOST_STATS();
+  for (i= 0; i < List->Count; ++i)
+  {
+    if ((Stats= MADB_HostStatsFind(List->Hosts[i].Name, List->Hosts[i].Port, FALSE)) != NULL)
+    {
+      List->Hosts[i].Latency= Stats->Latency;
+      List->Hosts[i].Avoid=   Stats->AvoidUntil > Now;
+    }
+  }
+  UNLOCK_HOST_STATS();
+
+  switch (Strategy)
+  {
+  case MADB_HOSTS_RANDOM:
+    for (i= List->Count - 1; i > 0; --i)
+    {
+      j= MADB_HostRandom() % (i + 1);
+      Tmp= List->Hosts[i];
+      List->Hosts[i]= List->Hosts[j];
+      List->Hosts[j]= Tmp;
+    }
+    break;
+  case MADB_HOSTS_ROUNDROBIN:
+  {
+#ifdef _WIN32
+    unsigned int Shift= (unsigned int)InterlockedIncrement((LONG volatile *)&MADB_RoundRobinCounter) - 1;
+#else
+    unsigned int Shift= __sync_fetch_and_add(&MADB_RoundRobinCounter, 1);
+#endif
+    Shift%= List->Count;
+    /* Rotating by one position Shift times is good enough for the lists of few hosts */
+    while (Shift-- > 0)
+    {
+      Tmp= List->Hosts[0];
+      memmove(List->Hosts, List->Hosts + 1, (List->Count - 1) * sizeof(MADB_Host));
+      List->Hosts[List->Count - 1]= Tmp;
+    }
+    break;
+  }
+  case MADB_HOSTS_LATENCY:
+    /* Weighted shuffle - chance of the host to be next is inversely proportional to its latency. Host w/out samples
+       gets the highest chance, so its latency gets known */
+    for (i= 0; i < List->Count - 1; ++i)
+    {
+      double Total= 0, Point;
+
+      for (j= i; j < List->Count; ++j)
+      {
+        Total+= 1.0 / (List->Hosts[j].Latency + MADB_HOST_LATENCY_FLOOR);
+      }
+      Point= Total * MADB_HostRandom() / 4294967296.0;
+      for (j= i; j < List->Count - 1; ++j)
+      {
+        if ((Point-= 1.0 / (List->Hosts[j].Latency + MADB_HOST_LATENCY_FLOOR)) < 0)
+        {
+          break;
+        }
+      }
+      Tmp= List->Hosts[i];
+      List->Hosts[i]= List->Hosts[j];
+      List->Hosts[j]= Tmp;
+    }
+    break;
+  default:
+    /* SEQUENTIAL and RACE go in the order hosts are listed */
+    break;
+  }
+
+  /* Avoided hosts go last, in the order they've got */
+  for (i= 0; i < List->Count; ++i)
+  {
+    if (!List->Hosts[i].Avoid)
+    {
+      continue;
+    }
+    for (j= i + 1; j < List->Count && List->Hosts[j].Avoid; ++j);
+    if (j == List->Count)
+    {
+      break;
+    }
+    Tmp= List->Hosts[j];
+    memmove(List->Hosts + i + 1, List->Hosts + i, (j - i) * sizeof(MADB_Host));
+    List->Hosts[i]= Tmp;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_HostListFree */
+void MADB_HostListFree(MADB_HostList *List)
+{
+  MADB_FREE(List->Hosts);
+  MADB_FREE(List->Buffer);
+  List->Count= 0;
+}
+/* }}} */
+
+/* {{{ MADB_HostUnreachable - TRUE if connect Error means that the next host should be tried. Errors like access denied
+       would be the same with other hosts of the cluster, and are returned to the application right away */
+my_bool MADB_HostUnreachable(unsigned int Error)
+{
+  switch (Error)
+  {
+  case CR_CONNECTION_ERROR:
+  case CR_CONN_HOST_ERROR:
+  case CR_UNKNOWN_HOST:
+  case CR_SERVER_GONE_ERROR:
+  case CR_SERVER_LOST:
+  case 1040: /* ER_CON_COUNT_ERROR */
+  case 1053: /* ER_SERVER_SHUTDOWN */
+    return TRUE;
+  }
+  return FALSE;
+}
+/* }}} */
+
+/* {{{ MADB_RacerStep - processes the Status returned by mysql_real_connect_start/cont for the i-th racer. Returns TRUE
+       if the race is over - racer has connected, or has got the error, that other hosts would return as well */
+static my_bool MADB_RacerStep(MADB_HostList *List, MYSQL **Racers, MADB_Racer *Racer, unsigned int i, MYSQL *Ret,
+                              unsigned int *Running, int *Result, unsigned long long *NextStart)
+{
+  if (Racer[i].Status != 0)
+  {
+    if (Racer[i].Status & MYSQL_WAIT_TIMEOUT)
+    {
+      Racer[i].Deadline= MADB_AsyncTime() + mysql_get_timeout_value_ms(Racers[i]);
+    }
+    return FALSE;
+  }
+
+  --*Running;
+  *Result= (int)i;
+  if (Ret != NULL)
+  {
+    MADB_HostSuccess(List->Hosts[i].Name, List->Hosts[i].Port, MADB_HostTime() - Racer[i].Started);
+    return TRUE;
+  }
+  if (!MADB_HostUnreachable(mysql_errno(Racers[i])))
+  {
+    return TRUE;
+  }
+  MADB_HostFailure(List->Hosts[i].Name, List->Hosts[i].Port);
+  /* Next host joins the race right away */
+  *NextStart= 0;
+  return FALSE;
+}
+/* }}} */
+
+/* {{{ MADB_HostRace - connects to all hosts of the List concurrently, starting the connect to the next host every Delay
+       ms, or as soon as one of the hosts has failed. Racers have to be initialized with MYSQL_OPT_NONBLOCK, one per host.
+       Returns index of the racer, that has connected first. If all have failed - index of the last failed one, with
+       its error. Other racers are closed. Returns -1 on OOM, and then racers are left intact */
+int MADB_HostRace(MADB_HostList *List, MYSQL **Racers, const char *User, const char *Password, const char *Db,
+                  unsigned long ClientFlags, unsigned int Delay)
+{
+  MADB_Racer        *Racer= (MADB_Racer *)MADB_CALLOC(List->Count * sizeof(MADB_Racer));
+  MADB_POLLFD       *Pfd=   (MADB_POLLFD *)MADB_CALLOC(List->Count * sizeof(MADB_POLLFD));
+  MYSQL             *Ret;
+  unsigned long long Now, NextStart= 0;
+  unsigned int       i, n, Events, Started= 0, Running= 0;
+  int                Result= -1, Timeout;
+  my_bool            Over= FALSE;
+
+  if (Racer == NULL || Pfd == NULL)
+  {
+    MADB_FREE(Racer);
+    MADB_FREE(Pfd);
+    return -1;
+  }
+
+  while (!Over)
+  {
+    Now= MADB_AsyncTime();
+    if (Started < List->Count && (Running == 0 || Now >= NextStart))
+    {
+      i= Started++;
+      ++Running;
+      NextStart= Now + Delay;
+      Racer[i].Started= MADB_HostTime();
+      Racer[i].Status= mysql_real_connect_start(&Ret, Racers[i], List->Hosts[i].Name, User, Password, Db,
+                                                List->Hosts[i].Port, NULL, ClientFlags);
+      Over= MADB_RacerStep(List, Racers, Racer, i, Ret, &Running, &Result, &NextStart);
+      continue;
+    }
+    /* All hosts have been tried, and all have failed */
+    if (Running == 0)
+    {
+      break;
+    }
+
+    Timeout= Started < List->Count ? (int)(NextStart - Now) : -1;
+    for (i= 0, n= 0; i < Started; ++i)
+    {
+      if (Racer[i].Status == 0)
+      {
+        continue;
+      }
+      Pfd[n].fd=      mysql_get_socket(Racers[i]);
+      Pfd[n].events=  0;
+      Pfd[n].revents= 0;
+      if (Racer[i].Status & MYSQL_WAIT_READ)
+        Pfd[n].events|= POLLIN;
+      if (Racer[i].Status & MYSQL_WAIT_WRITE)
+        Pfd[n].events|= POLLOUT;
+#ifndef _WIN32
+      if (Racer[i].Status & MYSQL_WAIT_EXCEPT)
+        Pfd[n].events|= POLLPRI;
+#endif
+      if (Racer[i].Status & MYSQL_WAIT_TIMEOUT)
+      {
+        int Left= Racer[i].Deadline > Now ? (int)(Racer[i].Deadline - Now) : 0;
+
+        if (Timeout < 0 || Left < Timeout)
+        {
+          Timeout= Left;
+        }
+      }
+      Racer[i].Pfd= n++;
+    }
+
+    if (MADB_POLL(Pfd, n, Timeout) < 0)
+    {
+      /* Interrupted. Racers, that have expired, are still resumed below */
+      for (i= 0; i < n; ++i)
+      {
+        Pfd[i].revents= 0;
+      }
+    }
+
+    Now= MADB_AsyncTime();
+    for (i= 0; i < Started && !Over; ++i)
+    {
+      if (Racer[i].Status == 0)
+      {
+        continue;
+      }
+      Events= 0;
+      n= Racer[i].Pfd;
+      if (Pfd[n].revents & POLLIN)
+        Events|= MYSQL_WAIT_READ;
+      if (Pfd[n].revents & POLLOUT)
+        Events|= MYSQL_WAIT_WRITE;
+#ifndef _WIN32
+      if (Pfd[n].revents & POLLPRI)
+        Events|= MYSQL_WAIT_EXCEPT;
+#endif
+      /* Let the racer find out about the failed connect */
+      if (Pfd[n].revents & (POLLERR | POLLHUP | POLLNVAL))
+        Events|= Racer[i].Status & (MYSQL_WAIT_READ | MYSQL_WAIT_WRITE | MYSQL_WAIT_EXCEPT);
+      if (Events == 0 && (Racer[i].Status & MYSQL_WAIT_TIMEOUT) && Now >= Racer[i].Deadline)
+        Events= MYSQL_WAIT_TIMEOUT;
+
+      if (Events != 0)
+      {
+        Racer[i].Status= mysql_real_connect_cont(&Ret, Racers[i], Events);
+        Over= MADB_RacerStep(List, Racers, Racer, i, Ret, &Running, &Result, &NextStart);
+      }
+    }
+  }
+
+  for (i= 0; i < List->Count; ++i)
+  {
+    if ((int)i == Result)
+    {
+      continue;
+    }
+    /* The unfinished connect can't be closed, while it is suspended. With its socket shut down, every resumed wait
+       fails at once, and the connect unwinds and cleans up after itself */
+    if (Racer[i].Status != 0)
+    {
+      my_socket Socket= mysql_get_socket(Racers[i]);
+
+      if (Socket != MARIADB_INVALID_SOCKET)
+      {
+        shutdown(Socket, MADB_SHUT_RDWR);
+      }
+      while (Racer[i].Status != 0)
+      {
+        Racer[i].Status= mysql_real_connect_cont(&Ret, Racers[i], Racer[i].Status | MYSQL_WAIT_TIMEOUT);
+      }
+    }
+    mysql_close(Racers[i]);
+    Racers[i]= NULL;
+  }
+
+  MADB_FREE(Racer);
+  MADB_FREE(Pfd);
+
+  return Result;
+}
+/* }}} */
@@ -0,0 +1,63 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#ifndef _ma_hosts_h_
+#define _ma_hosts_h_
+
+/* SERVER may be comma separated list of hosts, each optionally with its port - "host1:3307,host2,[::1]:3308".
+   HOST_STRATEGY defines the order they are tried in */
+enum enum_madb_host_strategy { MADB_HOSTS_SEQUENTIAL= 0, MADB_HOSTS_RANDOM, MADB_HOSTS_ROUNDROBIN, MADB_HOSTS_RACE,
+                               MADB_HOSTS_LATENCY };
+
+#define MADB_RACE_DEFAULT_DELAY 250 /* ms before the next host is tried in the RACE strategy */
+
+/* Process-wide statistics of hosts. Connect and ping latencies are averaged per host, and LATENCY strategy prefers
+   faster hosts. Host, that has failed MADB_HOST_MAX_FAILURES times in a row, is tried after all others for the next
+   MADB_HOST_AVOID_TIME seconds, whatever the strategy is */
+#define MADB_HOST_STATS_MAX_ENTRIES 64
+#define MADB_HOST_MAX_FAILURES      3
+#define MADB_HOST_AVOID_TIME        30
+#define MADB_HOST_LATENCY_FLOOR     100 /* us, added to the average, so the fastest host doesn't take all connections */
+
+typedef struct st_madb_host
+{
+  char        *Name;
+  unsigned int Port;
+  my_bool      Avoid;      /* Circuit is open */
+  double       Latency;    /* us, average. 0 if unknown */
+} MADB_Host;
+
+typedef struct st_madb_host_list
+{
+  MADB_Host   *Hosts;
+  unsigned int Count;
+  char        *Buffer;    /* Host names point into it */
+} MADB_HostList;
+
+int     MADB_HostStrategy(const char *Name);
+my_bool MADB_HostListInit(MADB_HostList *List, const char *Servers, unsigned int DefaultPort);
+void    MADB_HostListOrder(MADB_HostList *List, int Strategy);
+void    MADB_HostListFree(MADB_HostList *List);
+my_bool MADB_HostUnreachable(unsigned int Error);
+unsigned long long MADB_HostTime();
+void    MADB_HostSuccess(const char *Name, unsigned int Port, unsigned long long Latency);
+void    MADB_HostFailure(const char *Name, unsigned int Port);
+int     MADB_HostRace(MADB_HostList *List, MYSQL **Racers, const char *User, const char *Password, const char *Db,
+                      unsigned long ClientFlags, unsigned int Delay);
+
+#endif /* _ma_hosts_h_ */
@@ -72,8 +72,8 @@ void MADB_ListFree(MADB_List *root, unsigned int free_data)
   {
     next=root->next;
     if (free_data)
-      free(root->data);
-    free(root);
+      MADB_Free(root->data);
+    MADB_Free(root);
     root=next;
   }
 }
@@ -81,7 +81,7 @@ void MADB_ListFree(MADB_List *root, unsigned int free_data)
 
 MADB_List *MADB_ListCons(void *data, MADB_List *list)
 {
-  MADB_List *new_charset=(MADB_List*) malloc(sizeof(MADB_List));
+  MADB_List *new_charset=(MADB_List*) MADB_ALLOC(sizeof(MADB_List));
   if (!new_charset)
     return 0;
   new_charset->data=data;
@@ -132,20 +132,39 @@ int MADB_ListWalk(MADB_List *list, MADB_ListWalkAction action, char * argument)
   By monty.
 */
 
+/* The string grows geometrically - at least doubles with each reallocation, and alloc_increment is only the minimal
+   step. Thus building a string of any length with appends takes amortized linear time. init_alloc is the estimate of
+   the final length, and if it is good, the string is not reallocated at all */
+static my_bool MADB_DynstrGrow(MADB_DynString *str, size_t needed)
+{
+  size_t new_length;
+  char  *new_ptr;
+
+  if (needed <= str->max_length)
+    return FALSE;
+  new_length= MAX(str->max_length << 1, needed);
+  new_length= ((new_length + str->alloc_increment - 1) / str->alloc_increment) * str->alloc_increment;
+  if (!(new_ptr= (char*) MADB_REALLOC(str->str, new_length)))
+    return TRUE;
+  str->str= new_ptr;
+  str->max_length= new_length;
+  return FALSE;
+}
+
 my_bool MADB_InitDynamicString(MADB_DynString *str, const char *init_str,
 			    size_t init_alloc, size_t alloc_increment)
 {
-  unsigned int length;
+  size_t length;
 
   if (!alloc_increment)
     alloc_increment=128;
   length=1;
-  if (init_str && (length= (unsigned int) strlen(init_str)+1) < init_alloc)
+  if (init_str && (length= strlen(init_str)+1) > init_alloc)
     init_alloc=((length+alloc_increment-1)/alloc_increment)*alloc_increment;
   if (!init_alloc)
     init_alloc=alloc_increment;
 
-  if (!(str->str=(char*) malloc(init_alloc)))
+  if (!(str->str=(char*) MADB_ALLOC(init_alloc)))
     return(TRUE);
   str->length=length-1;
   if (init_str)
@@ -157,17 +176,10 @@ my_bool MADB_InitDynamicString(MADB_DynString *str, const char *init_str,
 
 my_bool MADB_DynstrSet(MADB_DynString *str, const char *init_str)
 {
-  unsigned int length;
+  size_t length;
 
-  if (init_str && (length= (unsigned int) strlen(init_str)+1) > str->max_length)
-  {
-    str->max_length=((length+str->alloc_increment-1)/str->alloc_increment)*
-      str->alloc_increment;
-    if (!str->max_length)
-      str->max_length=str->alloc_increment;
-    if (!(str->str=(char*) realloc(str->str,str->max_length)))
-      return(TRUE);
-  }
+  if (init_str && MADB_DynstrGrow(str, (length= strlen(init_str)+1)))
+    return(TRUE);
   if (init_str)
   {
     str->length=length-1;
@@ -179,17 +191,11 @@ my_bool MADB_DynstrSet(MADB_DynString *str, const char *init_str)
 }
 
 
+/* Reserves the space for additional_size more bytes, e.g. for the estimated size of what is going to be appended */
 my_bool MADB_DynstrRealloc(MADB_DynString *str, size_t additional_size)
 {
   if (!additional_size) return(FALSE);
-  if (str->length + additional_size > str->max_length)
-  {
-    str->max_length=((str->length + additional_size+str->alloc_increment-1)/
-		     str->alloc_increment)*str->alloc_increment;
-    if (!(str->str=(char*) realloc(str->str,str->max_length)))
-      return(TRUE);
-  }
-  return(FALSE);
+  return MADB_DynstrGrow(str, str->length + additional_size);
 }
 
 
@@ -202,17 +208,8 @@ my_bool MADB_DynstrAppend(MADB_DynString *str, const char *append)
 my_bool MADB_DynstrAppendMem(MADB_DynString *str, const char *append,
 			  size_t length)
 {
-  char *new_ptr;
-  if (str->length+length >= str->max_length)
-  {
-    size_t new_length=(str->length+length+str->alloc_increment)/
-      str->alloc_increment;
-    new_length*=str->alloc_increment;
-    if (!(new_ptr=(char*) realloc(str->str,new_length)))
-      return TRUE;
-    str->str=new_ptr;
-    str->max_length=new_length;
-  }
+  if (MADB_DynstrGrow(str, str->length + length + 1))
+    return TRUE;
   memcpy(str->str + str->length,append,length);
   str->length+=length;
   str->str[str->length]=0;			/* Safety for C programs */
@@ -224,7 +221,7 @@ void MADB_DynstrFree(MADB_DynString *str)
 {
   if (str->str)
   {
-    free(str->str);
+    MADB_Free(str->str);
     str->str=0;
   }
 }
@@ -265,7 +262,7 @@ my_bool MADB_InitDynamicArray(MADB_DynArray *array, unsigned int element_size,
   array->max_element=init_alloc;
   array->alloc_increment=alloc_increment;
   array->size_of_element=element_size;
-  if (!(array->buffer=(char*) malloc(element_size*init_alloc)))
+  if (!(array->buffer=(char*) MADB_ALLOC(element_size*init_alloc)))
   {
     array->max_element=0;
     return(TRUE);
@@ -299,7 +296,7 @@ unsigned char *MADB_AllocDynamic(MADB_DynArray *array)
   if (array->elements == array->max_element)
   {
     char *new_ptr;
-    if (!(new_ptr=(char*) realloc(array->buffer,(array->max_element+
+    if (!(new_ptr=(char*) MADB_REALLOC(array->buffer,(array->max_element+
 			          array->alloc_increment)*
 				   array->size_of_element)))
       return 0;
@@ -330,7 +327,7 @@ my_bool MADB_SetDynamic(MADB_DynArray *array, void * element, unsigned int idx)
       char *new_ptr;
       size=(idx+array->alloc_increment)/array->alloc_increment;
       size*= array->alloc_increment;
-      if (!(new_ptr=(char*) realloc(array->buffer,size*
+      if (!(new_ptr=(char*) MADB_REALLOC(array->buffer,size*
 			            array->size_of_element)))
 	return TRUE;
       array->buffer=new_ptr;
@@ -362,7 +359,7 @@ void MADB_DeleteDynamic(MADB_DynArray *array)
 {
   if (array->buffer)
   {
-    free(array->buffer);
+    MADB_Free(array->buffer);
     array->buffer=0;
     array->elements=array->max_element=0;
   }
@@ -384,7 +381,7 @@ void MADB_FreezeSizeDynamic(MADB_DynArray *array)
 
   if (array->buffer && array->max_element != elements)
   {
-    array->buffer=(char*) realloc(array->buffer,
+    array->buffer=(char*) MADB_REALLOC(array->buffer,
 			          elements*array->size_of_element);
     array->max_element=elements;
   }
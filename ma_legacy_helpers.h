@@ -61,6 +61,8 @@ my_bool MADB_DynstrRealloc(MADB_DynString *str, size_t additional_size);
 my_bool MADB_DynstrAppend(MADB_DynString *str, const char *append);
 my_bool MADB_DynstrAppendMem(MADB_DynString *str, const char *append,
 			  size_t length);
+/* Appends string literal w/out strlen */
+#define MADB_DYNAPPENDCONST(DYNSTR, CONSTSTR) MADB_DynstrAppendMem((DYNSTR), (CONSTSTR), sizeof(CONSTSTR) - 1)
 void MADB_DynstrFree(MADB_DynString *str);
 char *MADB_DynstrMake(register char *dst, register const char *src, size_t length);
 
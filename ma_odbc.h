@@ -34,10 +34,34 @@
 #include <mysql.h>
 
 #include <ma_legacy_helpers.h>
+#include <ma_allocator.h>
 
 #include <sql.h>
 #include <sqlext.h>
 #include <odbcinst.h>
+#ifdef HAVE_SQLSPI_H
+# include <sqlspi.h>
+#endif
+
+/* Driver-aware connection pooling SPI(ODBC 3.81) for driver managers, that do not ship sqlspi.h */
+#ifndef SQL_HANDLE_DBC_INFO_TOKEN
+# define SQL_HANDLE_DBC_INFO_TOKEN 6
+typedef SQLHANDLE SQLHDBC_INFO_TOKEN;
+typedef SQLULEN   POOLID;
+typedef SQLULEN   TRANSID;
+#endif
+#ifndef SQL_ATTR_DBC_INFO_TOKEN
+# define SQL_ATTR_DBC_INFO_TOKEN 118
+#endif
+#ifndef SQL_ATTR_RESET_CONNECTION
+# define SQL_ATTR_RESET_CONNECTION 116
+# define SQL_RESET_CONNECTION_YES  1UL
+#endif
+#ifndef SQL_DRIVER_AWARE_POOLING_SUPPORTED
+# define SQL_DRIVER_AWARE_POOLING_SUPPORTED   10024
+# define SQL_DRIVER_AWARE_POOLING_NOT_CAPABLE 0x00000000L
+# define SQL_DRIVER_AWARE_POOLING_CAPABLE     0x00000001L
+#endif
 
 #include <errmsg.h>
 #include <string.h>
@@ -240,6 +264,8 @@ typedef struct
   SQLSMALLINT BookmarkType;
   SQLULEN	MetadataId;
   SQLULEN SimulateCursor;
+  SQLULEN Timeout;
+  SQLULEN AsyncEnable;
 } MADB_StmtOptions;
 
 /* TODO: To check is it 0 or 1 based? not quite clear from its usage */
@@ -249,6 +275,7 @@ typedef struct
   SQLLEN           Position;
   SQLLEN           RowsetSize;
   MYSQL_ROW_OFFSET Next;
+  SQLULEN          Streamed; /* Rows fetched so far from the unbuffered result */
 } MADB_Cursor;
 
 enum MADB_DaeType {MADB_DAE_NORMAL=0, MADB_DAE_ADD=1, MADB_DAE_UPDATE=2, MADB_DAE_DELETE=3};
@@ -276,11 +303,19 @@ typedef struct
 
 } MADB_ShortTypeInfo;
 
-/* Stmt struct needs definitions from my_parse.h */
+/* Stmt struct needs definitions from my_parse.h and ma_async.h */
 #include <ma_parse.h>
+#include <ma_async.h>
 
 #define STMT_STRING(STMT) (STMT)->Query.Original
 
+/* Buffer allocated from the statement's arena. It is reused while big enough, and is gone with the arena reset */
+typedef struct
+{
+  char   *Buffer;
+  size_t  Size;
+} MADB_ArenaBuffer;
+
 struct st_ma_odbc_stmt
 {
   MADB_Dbc                  *Connection;
@@ -318,12 +353,18 @@ struct st_ma_odbc_stmt
   int                       PutParam;
   my_bool                   RebindParams;
   my_bool                   bind_done;
+  char                      *PendingPrepare; /* Query text, that has to be prepared together with its execution */
   long long                 AffectedRows;
   unsigned long             *CharOffset;
   unsigned long             *Lengths;
   char                      *TableName;
   char                      *CatalogName;
   MADB_ShortTypeInfo        *ColsTypeFixArr;
+  MADB_AsyncOp              Async;
+  MA_MEM_ROOT               Arena;            /* Execution-scoped allocations, reset on execution and closing cursor */
+  MADB_ArenaBuffer          *FetchBuffers;    /* Conversion buffers of the result columns, allocated from Arena */
+  unsigned int              FetchBufferCount;
+  MADB_ArenaBuffer          SavedFlags;       /* Bind flags saved while the cursor is moved, allocated from Arena */
   /* Application Descriptors */
   MADB_Desc *Apd;
   MADB_Desc *Ard;
@@ -344,6 +385,9 @@ typedef struct st_ma_odbc_environment {
   SQLWCHAR *TraceFile;
   SQLINTEGER OdbcVersion;
   SQLINTEGER OutputNTS;
+  MADB_List *PoolIds;            /* Pool IDs given out by SQLGetPoolID - canonical connection strings */
+  MADB_List *KillConns;          /* Idle control connections for KILL QUERY */
+  struct st_madb_query_timers *QueryTimers;
 } MADB_Env;
 
 
@@ -375,11 +419,14 @@ struct st_ma_odbc_connection
   MADB_List ListItem;
   MADB_List *Stmts;
   MADB_List *Descrs;
+  MADB_List *FreeStmts;          /* Dropped statement objects for reuse. Guarded by ListsCs */
+  unsigned int FreeStmtsCount;
   /* Attributes */
   SQLINTEGER AccessMode;
   my_bool IsAnsi;
   SQLINTEGER IsolationLevel;     /* tx_isolation */
   SQLULEN AsyncEnable;
+  SQLUINTEGER AsyncDbcFunctions;
   SQLUINTEGER AutoIpd;
   SQLUINTEGER AutoCommit;
   SQLUINTEGER ConnectionDead;
@@ -395,10 +442,38 @@ struct st_ma_odbc_connection
   SQLUINTEGER Trace;
   char *TraceFile;
   SQLINTEGER TxnIsolation;
+  SQLINTEGER SessionTxnIsolation;  /* Isolation level set in the session, 0 if server default */
+  my_bool SessionAutoCommit;     /* Autocommit mode the driver has last set in the session */
   SQLINTEGER CursorCount;
   char ServerCapabilities;
+  MADB_List *ParseCache;         /* Parsed queries, most recently used first. Guarded by ListsCs */
+  unsigned int ParseCacheCount;
+  MADB_List *StmtCache;          /* Server-side prepared statements not used by any handle, most recently used first */
+  unsigned int StmtCacheCount;
+  my_bool CurrentDbUnknown;      /* Statement, that could change current database, was executed w/out the server tracking it */
+  MADB_Stmt *AsyncStmt;          /* Statement, asynchronous operation of which is in progress */
+  MADB_AsyncOp AsyncConnect;     /* Asynchronous SQLConnect/SQLDriverConnect in progress */
+  MADB_AllocCounters MemCounters; /* Allocations made on behalf of the connection, if MADB_ATTR_MEMORY_ACCOUNTING is on */
 };
 
+/* Connection request of the driver-aware pooling - connection info and attributes, the pooled connection has
+   to be established with, or reset to */
+typedef struct st_ma_odbc_dbc_info_token
+{
+  MADB_Error   Error;
+  MADB_Env    *Environment;
+  char        *ConnString;       /* SQLSetDriverConnectInfo */
+  char        *DsnName;          /* SQLSetConnectInfo */
+  char        *UserName;
+  char        *Password;
+  /* Attributes set with SQLSetConnectAttrForDbcInfo */
+  SQLUINTEGER  AutoCommit;
+  SQLINTEGER   TxnIsolation;
+  SQLINTEGER   AccessMode;
+  char        *CatalogName;
+  MADB_Dsn    *Dsn;              /* Connection info parsed once for SQLGetPoolID and SQLRateConnection */
+} MADB_DbcInfoToken;
+
 typedef BOOL (__stdcall *PromptDSN)(HWND hwnd, MADB_Dsn *Dsn);
 
 typedef struct
@@ -474,6 +549,9 @@ case SQL_TYPE_DATE
 #include <ma_type_helper.h>
 #include <ma_typeconv.h>
 #include <ma_fake_request.h>
+#include <ma_server_info.h>
+#include <ma_query_timer.h>
+#include <ma_hosts.h>
 #include <plugins/browser_auth.h>
 
 /* SQLFunction calls inside MariaDB Connector/ODBC needs to be mapped,
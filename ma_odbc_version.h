@@ -0,0 +1,19 @@
+/*
+ *
+ */
+
+#ifndef _ma_odbc_version_h_
+#define _ma_odbc_version_h_
+
+#define MARIADB_ODBC_VERSION_MAJOR 1
+#define MARIADB_ODBC_VERSION_MINOR 0
+#define MARIADB_ODBC_VERSION_PATCH 8
+
+#define MARIADB_ODBC_VERSION "01.00.0008"
+
+#define MARIADB_ODBC_ERR_PREFIX "[ss-1.0.8]"
+
+#define ODBCVER 0x0351
+
+#define MADB_DEFAULT_PLUGINS_SUBDIR "plugin"
+#endif /* _ma_odbc_version_h_ */
@@ -21,6 +21,7 @@
 #include <ma_odbc.h>
 #include "escape_sequences/parser.h"
 #include "escape_sequences/lexical_analyzer.h"
+#include "escape_sequences/ast.h"
 
 
 /* Minimal query length when we tried to avoid full parsing */
@@ -75,8 +76,17 @@ char* SkipQuotedString_Noescapes(char **CurPtr, const char *End, char Quote)
   return *CurPtr;
 }
 
-// MADB_UnescapeQuery replaces all escaped sequences in the SQL query
+/* Scanner and AST arena shared by all escape blocks of one query. The scanner is
+   created on the first escape and then only gets a new input buffer for every block */
+typedef struct
+{
+  yyscan_t Scanner;
+  struct ASTArena Arena;
+} MADB_EscapeParser;
+
+// UnescapeQuery replaces all escaped sequences in the SQL query
 // https://docs.microsoft.com/en-us/sql/odbc/reference/develop-app/escape-sequences-in-odbc?view=sql-server-ver15
+// Parser is the scanner and arena reused for every escape block.
 // error is a pointer to the MADB_Error object where the error will be saved if it will occur.
 // This function recursively iterates over the source string.
 // res is a dynamic string where the resulting query is saved.
@@ -84,9 +94,11 @@ char* SkipQuotedString_Noescapes(char **CurPtr, const char *End, char Quote)
 // srcEnd is a pointer to the end of the source string.
 // openCurlyBrackets is a number of currently opened curly brackets from the start of the source string to the src.
 //
-SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *res, char **src, char **srcEnd, int openCurlyBrackets)
+static SQLRETURN UnescapeQuery(MADB_EscapeParser *Parser, MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *res,
+                               char **src, char **srcEnd, int openCurlyBrackets)
 {
-  if (MADB_InitDynamicString(res, "", *srcEnd - *src, 256))
+  /* The top level result takes the whole query, and escape blocks are short usually */
+  if (MADB_InitDynamicString(res, "", openCurlyBrackets == 0 ? *srcEnd - *src + 1 : MIN(*srcEnd - *src + 1, 256), 256))
   {
     return MADB_SetError(error,  MADB_ERR_HY001, "Failed to allocate memory for the query string", 0);
   }
@@ -96,18 +108,17 @@ SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *r
     MADB_DynString subquery;
 
     char *quotedString;
-    yyscan_t scanner;
     size_t stringLength;
     switch(**src)
     {
       case '{':
         (*src)++;
-        if (MADB_UnescapeQuery(Dbc, error, &subquery, src, srcEnd, openCurlyBrackets + 1))
+        if (UnescapeQuery(Parser, Dbc, error, &subquery, src, srcEnd, openCurlyBrackets + 1))
         {
           MADB_DynstrFree(res);
           return error->ReturnValue;
         }
-        if (MADB_DynstrAppend(res, subquery.str))
+        if (MADB_DynstrAppendMem(res, subquery.str, subquery.length))
         {
           MADB_DynstrFree(res);
           MADB_DynstrFree(&subquery);
@@ -123,31 +134,29 @@ SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *r
         }
 
         (*src)++;
-        if (yylex_init(&scanner) != 0)
+        if (Parser->Scanner == NULL && yylex_init_extra(&Parser->Arena, &Parser->Scanner) != 0)
         {
+          Parser->Scanner = NULL;
           MADB_DynstrFree(res);
           return MADB_SetError(error,  MADB_ERR_HY001, "Failed to allocate memory for the query string", 0);
         }
-        YY_BUFFER_STATE buf = yy_scan_string(res->str, scanner);
+        YY_BUFFER_STATE buf = yy_scan_string(res->str, Parser->Scanner);
         MADB_DynstrFree(res);
         if (buf == NULL)
         {
-          yylex_destroy(scanner);
           return MADB_SetError(error,  MADB_ERR_HY001, "Failed to allocate memory for the query string", 0);
         }
 
-        if (yyparse(scanner, error, Dbc, res) != 0)
+        int parseResult = yyparse(Parser->Scanner, error, Dbc, res);
+        yy_delete_buffer(buf, Parser->Scanner);
+        /* The block is already rendered to res, nodes of its AST are not needed anymore */
+        resetArena(&Parser->Arena);
+        if (parseResult != 0)
         {
           MADB_DynstrFree(res);
-          yy_delete_buffer(buf, scanner);
-          yylex_destroy(scanner);
           return error->ReturnValue;
-        } else
-        {
-          yy_delete_buffer(buf, scanner);
-          yylex_destroy(scanner);
-          return 0;
         }
+        return 0;
       case '"':
       case '\'':
       case '`':
@@ -178,12 +187,18 @@ SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *r
         (*src) += stringLength;
         break;
       default:
-        if (MADB_DynstrAppendMem(res, *src, 1))
+        /* appending the whole run of characters up to the next quote or curly bracket */
+        stringLength = 1;
+        while (*src + stringLength < *srcEnd && strchr("{}\"'`", (*src)[stringLength]) == NULL)
+        {
+          stringLength++;
+        }
+        if (MADB_DynstrAppendMem(res, *src, stringLength))
         {
           MADB_DynstrFree(res);
           return MADB_SetError(error,  MADB_ERR_HY001, "Failed to allocate memory for the query string", 0);
         }
-        (*src)++;
+        (*src) += stringLength;
         break;
     }
   }
@@ -197,6 +212,29 @@ SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *r
   return 0;
 }
 
+// MADB_UnescapeQuery replaces all escaped sequences in the SQL query.
+// One scanner and one AST arena are used for all escape blocks of the query,
+// they are released when the whole query is processed.
+//
+SQLRETURN MADB_UnescapeQuery(MADB_Dbc *Dbc, MADB_Error *error, MADB_DynString *res, char **src, char **srcEnd, int openCurlyBrackets)
+{
+  MADB_EscapeParser Parser;
+  SQLRETURN ret;
+
+  Parser.Scanner = NULL;
+  initArena(&Parser.Arena);
+
+  ret = UnescapeQuery(&Parser, Dbc, error, res, src, srcEnd, openCurlyBrackets);
+
+  if (Parser.Scanner != NULL)
+  {
+    yylex_destroy(Parser.Scanner);
+  }
+  freeArena(&Parser.Arena);
+
+  return ret;
+}
+
 int MADB_ResetParser(MADB_Stmt *Stmt, char *OriginalQuery, SQLINTEGER OriginalLength)
 {
   MADB_DeleteQuery(&Stmt->Query);
@@ -273,12 +311,236 @@ int MADB_ParseQuery(MADB_QUERY * Query)
   Query->RefinedLength-= Query->RefinedText - Query->allocated;
 
   /* Making copy of "original" string, with minimal changes required to be able to execute */
-  Query->Original= strndup(Query->RefinedText, Query->RefinedLength);
+  Query->Original= MADB_STRNDUP(Query->RefinedText, Query->RefinedLength);
   SkipSpacesAndComments(&Query->RefinedText, &Query->RefinedLength, FALSE);
 
   return ParseQuery(Query);
 }
 
+/*----------------- Parsed queries cache ------------------*/
+
+typedef struct
+{
+  MADB_List     ListItem;
+  unsigned long Hash;
+  char         *Text;
+  size_t        Length;
+  MADB_QUERY    Query;
+  unsigned int  Readers;  /* Number of MADB_ParseCacheGet copying the entry outside the lock */
+  my_bool       Evicted;  /* The entry is not in the cache anymore, and the last reader has to free it */
+} MADB_PARSE_CACHE_ENTRY;
+
+static unsigned long MADB_HashQuery(const char *Text, size_t Length)
+{
+  /* FNV-1a */
+  unsigned long Hash= 2166136261UL;
+  const char *end= Text + Length;
+
+  while (Text < end)
+  {
+    Hash^= (unsigned char)*Text++;
+    Hash*= 16777619UL;
+  }
+  return Hash;
+}
+
+static my_bool MADB_CopyDynamic(MADB_DynArray *Dst, MADB_DynArray *Src)
+{
+  if (MADB_InitDynamicArray(Dst, Src->size_of_element, Src->elements, Src->alloc_increment) ||
+      (Src->elements > 0 && Dst->buffer == NULL))
+  {
+    return TRUE;
+  }
+  if (Src->elements > 0)
+  {
+    memcpy(Dst->buffer, Src->buffer, (size_t)Src->elements * Src->size_of_element);
+  }
+  Dst->elements= Src->elements;
+  return FALSE;
+}
+
+/* {{{ MADB_CopyQuery
+   Makes Dst an independent copy of the parsed query Src. Only the refined text is copied, thus
+   in the copy "allocated" and "RefinedText" are the same. Tokens and parameter positions are
+   offsets from RefinedText, but subqueries have to be moved to the new buffer */
+int MADB_CopyQuery(MADB_QUERY *Dst, MADB_QUERY *Src)
+{
+  unsigned int i;
+  SINGLE_QUERY SubQuery;
+
+  memset(Dst, 0, sizeof(MADB_QUERY));
+
+  /* Refined text may contain '\0' in place of statements separators, thus no strndup here */
+  if ((Dst->allocated= (char*)MADB_ALLOC(Src->RefinedLength + 1)) == NULL)
+  {
+    return 1;
+  }
+  memcpy(Dst->allocated, Src->RefinedText, Src->RefinedLength);
+  Dst->allocated[Src->RefinedLength]= '\0';
+  Dst->RefinedText=   Dst->allocated;
+  Dst->RefinedLength= Src->RefinedLength;
+  Dst->HasParameters= Src->HasParameters;
+  Dst->ReturnsResult= Src->ReturnsResult;
+  Dst->QueryType=     Src->QueryType;
+  Dst->BatchAllowed=  Src->BatchAllowed;
+  Dst->ChangesSchema= Src->ChangesSchema;
+
+  if ((Src->Original != NULL && (Dst->Original= MADB_STRDUP(Src->Original)) == NULL) ||
+      MADB_CopyDynamic(&Dst->Tokens, &Src->Tokens) ||
+      MADB_CopyDynamic(&Dst->ParamPositions, &Src->ParamPositions) ||
+      MADB_CopyDynamic(&Dst->SubQuery, &Src->SubQuery))
+  {
+    MADB_DeleteQuery(Dst);
+    return 1;
+  }
+
+  for (i= 0; i < Dst->SubQuery.elements; ++i)
+  {
+    MADB_GetDynamic(&Dst->SubQuery, (char *)&SubQuery, i);
+    SubQuery.QueryText= Dst->RefinedText + (SubQuery.QueryText - Src->RefinedText);
+    MADB_SetDynamic(&Dst->SubQuery, (char *)&SubQuery, i);
+  }
+
+  return 0;
+}
+/* }}} */
+
+static void MADB_ParseCacheFreeEntry(MADB_PARSE_CACHE_ENTRY *Entry)
+{
+  MADB_DeleteQuery(&Entry->Query);
+  MADB_FREE(Entry->Text);
+  MADB_FREE(Entry);
+}
+
+/* {{{ MADB_ParseCacheGet
+   Looks up the parse result for the statement text. On hit, the entry becomes the most recently used one,
+   and Query gets its own copy of the result. The cache is guarded by the lists lock, and not by the connection
+   lock, so that statements of the connection could be parsed while another one is talking to the server.
+   The copy is made after releasing the lock - the entry is pinned meanwhile, so that eviction doesn't free it */
+my_bool MADB_ParseCacheGet(MADB_Dbc *Dbc, const char *Text, size_t Length, MADB_QUERY *Query)
+{
+  MADB_List *Item;
+  MADB_PARSE_CACHE_ENTRY *Entry= NULL;
+  unsigned long Hash;
+  my_bool Found, Release;
+
+  if (Length > MADB_PARSE_CACHE_MAX_QUERY_LEN)
+  {
+    return FALSE;
+  }
+
+  Hash= MADB_HashQuery(Text, Length);
+
+  EnterCriticalSection(&Dbc->ListsCs);
+  for (Item= Dbc->ParseCache; Item != NULL; Item= Item->next)
+  {
+    Entry= (MADB_PARSE_CACHE_ENTRY *)Item->data;
+
+    if (Entry->Hash == Hash && Entry->Length == Length && memcmp(Entry->Text, Text, Length) == 0)
+    {
+      ++Entry->Readers;
+      if (Item != Dbc->ParseCache)
+      {
+        Dbc->ParseCache= MADB_ListDelete(Dbc->ParseCache, Item);
+        Dbc->ParseCache= MADB_ListAdd(Dbc->ParseCache, Item);
+      }
+      break;
+    }
+  }
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  if (Item == NULL)
+  {
+    return FALSE;
+  }
+
+  Found= !MADB_CopyQuery(Query, &Entry->Query);
+
+  EnterCriticalSection(&Dbc->ListsCs);
+  Release= --Entry->Readers == 0 && Entry->Evicted;
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  if (Release)
+  {
+    MADB_ParseCacheFreeEntry(Entry);
+  }
+  return Found;
+}
+/* }}} */
+
+/* {{{ MADB_ParseCachePut
+   Stores the copy of the parse result of the statement text. If the cache is full, the least recently used
+   entry is evicted. Failures are not reported - the query simply won't be cached.
+   Copying is done before taking the lists lock, evicted entries are freed after releasing it, or by their last
+   reader, if some MADB_ParseCacheGet is copying them */
+void MADB_ParseCachePut(MADB_Dbc *Dbc, const char *Text, size_t Length, MADB_QUERY *Query)
+{
+  MADB_PARSE_CACHE_ENTRY *Entry;
+  MADB_List *Last, *Evicted= NULL;
+
+  if (Dbc->Dsn == NULL || Dbc->Dsn->ParseCacheSize == 0 || Length > MADB_PARSE_CACHE_MAX_QUERY_LEN)
+  {
+    return;
+  }
+
+  if ((Entry= (MADB_PARSE_CACHE_ENTRY *)MADB_CALLOC(sizeof(MADB_PARSE_CACHE_ENTRY))) == NULL)
+  {
+    return;
+  }
+  if ((Entry->Text= (char*)MADB_ALLOC(Length + 1)) == NULL || MADB_CopyQuery(&Entry->Query, Query))
+  {
+    MADB_FREE(Entry->Text);
+    MADB_FREE(Entry);
+    return;
+  }
+  memcpy(Entry->Text, Text, Length);
+  Entry->Text[Length]= '\0';
+  Entry->Length= Length;
+  Entry->Hash= MADB_HashQuery(Text, Length);
+
+  EnterCriticalSection(&Dbc->ListsCs);
+  while (Dbc->ParseCacheCount >= (unsigned int)Dbc->Dsn->ParseCacheSize)
+  {
+    for (Last= Dbc->ParseCache; Last->next != NULL; Last= Last->next);
+    Dbc->ParseCache= MADB_ListDelete(Dbc->ParseCache, Last);
+    --Dbc->ParseCacheCount;
+    if (((MADB_PARSE_CACHE_ENTRY *)Last->data)->Readers > 0)
+    {
+      ((MADB_PARSE_CACHE_ENTRY *)Last->data)->Evicted= TRUE;
+      continue;
+    }
+    Evicted= MADB_ListAdd(Evicted, Last);
+  }
+
+  Entry->ListItem.data= (void *)Entry;
+  Dbc->ParseCache= MADB_ListAdd(Dbc->ParseCache, &Entry->ListItem);
+  ++Dbc->ParseCacheCount;
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  while (Evicted != NULL)
+  {
+    Last= Evicted;
+    Evicted= MADB_ListDelete(Evicted, Last);
+    MADB_ParseCacheFreeEntry((MADB_PARSE_CACHE_ENTRY *)Last->data);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_ParseCacheFree */
+void MADB_ParseCacheFree(MADB_Dbc *Dbc)
+{
+  MADB_List *Item, *Next;
+
+  for (Item= Dbc->ParseCache; Item != NULL; Item= Next)
+  {
+    Next= Item->next;
+    MADB_ParseCacheFreeEntry((MADB_PARSE_CACHE_ENTRY *)Item->data);
+  }
+  Dbc->ParseCache= NULL;
+  Dbc->ParseCacheCount= 0;
+}
+/* }}} */
+
 /*----------------- Tokens stuff ------------------*/
 
 char *MADB_Token(MADB_QUERY *Query, unsigned int Idx)
@@ -349,6 +611,107 @@ char * MADB_ParseCursorName(MADB_QUERY *Query, unsigned int *Offset)
 }
 
 
+/* Keywords, after which(or instead of which) a LIMIT clause cannot be simply appended to a SELECT */
+static const char *LimitConflictingKeywords[]= {"LIMIT", "OFFSET", "FETCH", "UNION", "INTERSECT", "EXCEPT", "MINUS",
+                                                "INTO", "FOR", "LOCK", "PROCEDURE", "OPTION", NULL};
+
+/* {{{ MADB_IsSimpleSelect - checks if the query is a single SELECT, that a LIMIT clause can be appended to as is.
+       The check is conservative - any of LimitConflictingKeywords at any nesting level, a comment or a statement
+       delimiter make the query not simple */
+my_bool MADB_IsSimpleSelect(MADB_QUERY *Query)
+{
+  char *p= Query->RefinedText, *End= Query->RefinedText + Query->RefinedLength, Quote;
+  unsigned int i;
+
+  if (Query->QueryType != MADB_QUERY_SELECT || QUERY_IS_MULTISTMT(*Query) || p == NULL)
+  {
+    return FALSE;
+  }
+
+  while (p < End)
+  {
+    switch (*p)
+    {
+    case '"':
+    case '\'':
+      Quote= *p++;
+      SkipQuotedString(&p, End, Quote);
+      break;
+    case '`':
+      ++p;
+      SkipQuotedString_Noescapes(&p, End, '`');
+      break;
+    case ';':
+    case '#':
+    case '\0':
+      return FALSE;
+    case '-':
+    case '/':
+      if (p + 1 < End && p[1] == (*p == '-' ? '-' : '*'))
+      {
+        return FALSE;
+      }
+      break;
+    default:
+      if (isalpha((unsigned char)*p) && (p == Query->RefinedText || !(isalnum((unsigned char)p[-1]) || p[-1] == '_' || p[-1] == '$')))
+      {
+        for (i= 0; LimitConflictingKeywords[i] != NULL; ++i)
+        {
+          size_t Length= strlen(LimitConflictingKeywords[i]);
+
+          if (p + Length <= End && _strnicmp(p, LimitConflictingKeywords[i], Length) == 0 &&
+              (p + Length == End || !(isalnum((unsigned char)p[Length]) || p[Length] == '_' || p[Length] == '$')))
+          {
+            return FALSE;
+          }
+        }
+      }
+    }
+    ++p;
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_AppendLimit - appends LIMIT clause to the query, which has to be checked with MADB_IsSimpleSelect before.
+       Tokens and parameter positions stay valid, since they are offsets and the clause goes to the end */
+int MADB_AppendLimit(MADB_QUERY *Query, SQLULEN Limit)
+{
+  char        *Text;
+  size_t       Length;
+  unsigned int i;
+  SINGLE_QUERY SubQuery;
+
+  if ((Text= (char*)MADB_ALLOC(Query->RefinedLength + 32)) == NULL)
+  {
+    return 1;
+  }
+  memcpy(Text, Query->RefinedText, Query->RefinedLength);
+  Length= Query->RefinedLength + _snprintf(Text + Query->RefinedLength, 32, " LIMIT %llu", (unsigned long long)Limit);
+
+  for (i= 0; i < Query->SubQuery.elements; ++i)
+  {
+    MADB_GetDynamic(&Query->SubQuery, (char *)&SubQuery, i);
+    SubQuery.QueryText= Text + (SubQuery.QueryText - Query->RefinedText);
+    MADB_SetDynamic(&Query->SubQuery, (char *)&SubQuery, i);
+  }
+
+  MADB_FREE(Query->allocated);
+  Query->allocated= Query->RefinedText= Text;
+  Query->RefinedLength= Length;
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_IsKeyword - checks if the text starts with the keyword as the whole word, and not as a prefix of identifier */
+static my_bool MADB_IsKeyword(const char *Text, const char *Keyword, size_t Length)
+{
+  return _strnicmp(Text, Keyword, Length) == 0 &&
+         !(isalnum((unsigned char)Text[Length]) || Text[Length] == '_' || Text[Length] == '$');
+}
+/* }}} */
+
 enum enum_madb_query_type MADB_GetQueryType(const char *Token1, const char *Token2)
 {
   /* We need for the case when MS Access adds parenthesis around query - see ODBC-57*/
@@ -428,6 +791,16 @@ enum enum_madb_query_type MADB_GetQueryType(const char *Token1, const char *Toke
   {
     return MADB_QUERY_DESCRIBE;
   }
+  /* Statements, changing current database, must not be confused with ones, that start with the same letters */
+  if (MADB_IsKeyword(Token1, "USE", 3))
+  {
+    return MADB_QUERY_USE;
+  }
+  if (MADB_IsKeyword(Token1, "DROP", 4) &&
+      (MADB_IsKeyword(Token2, "DATABASE", 8) || MADB_IsKeyword(Token2, "SCHEMA", 6)))
+  {
+    return MADB_QUERY_DROP_SCHEMA;
+  }
   if (_strnicmp(Token1, "BEGIN", 5) == 0 && _strnicmp(Token2, "NOT", 3) == 0)
   {
     return MADB_NOT_ATOMIC_BLOCK;
@@ -503,6 +876,7 @@ int ParseQuery(MADB_QUERY *Query)
         StmtType= MADB_GetQueryType(MADB_Token(Query, Query->Tokens.elements - 2), p);
 
         Query->ReturnsResult= Query->ReturnsResult || !QUERY_DOESNT_RETURN_RESULT(StmtType);
+        Query->ChangesSchema= Query->ChangesSchema || StmtType == MADB_QUERY_USE || StmtType == MADB_QUERY_DROP_SCHEMA;
         MADB_AddSubQuery(Query, CurQuery, StmtType);
 
         /* If we on first statement, setting QueryType*/
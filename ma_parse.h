@@ -32,6 +32,8 @@ enum enum_madb_query_type { MADB_QUERY_NO_RESULT= 0, /* Default type for the que
                             MADB_QUERY_CREATE_DEFINER,
                             MADB_QUERY_SET,
                             MADB_QUERY_SET_NAMES,
+                            MADB_QUERY_USE,
+                            MADB_QUERY_DROP_SCHEMA,
                             MADB_QUERY_SELECT_INTO,
                             MADB_QUERY_SELECT,
                             MADB_QUERY_SHOW,
@@ -65,6 +67,7 @@ typedef struct {
   enum enum_madb_query_type QueryType;
 
   my_bool       BatchAllowed;
+  my_bool       ChangesSchema; /* Some of queries may change the current database */
 
 } MADB_QUERY;
 
@@ -78,12 +81,24 @@ void MADB_AddSubQuery(MADB_QUERY *Query, char *SubQueryText, enum enum_madb_quer
 
 void MADB_DeleteQuery(MADB_QUERY *Query);
 int  MADB_ParseQuery(MADB_QUERY *Query);
+int  MADB_CopyQuery(MADB_QUERY *Dst, MADB_QUERY *Src);
+
+/* Per-connection cache of parse results. Longer queries are not cached - they are unlikely to be repeated
+   as is, and would take too much memory */
+#define MADB_PARSE_CACHE_MAX_QUERY_LEN 16384
+#define MADB_PARSE_CACHE_DEFAULT_SIZE  64
+
+my_bool MADB_ParseCacheGet(MADB_Dbc *Dbc, const char *Text, size_t Length, MADB_QUERY *Query);
+void    MADB_ParseCachePut(MADB_Dbc *Dbc, const char *Text, size_t Length, MADB_QUERY *Query);
+void    MADB_ParseCacheFree(MADB_Dbc *Dbc);
 
 #define QUERY_DOESNT_RETURN_RESULT(query_type) ((query_type) < MADB_QUERY_SELECT)
 
 char *       MADB_ParseCursorName(MADB_QUERY *Query, unsigned int *Offset);
 unsigned int MADB_FindToken(MADB_QUERY *Query, char *Compare);
 my_bool      MADB_CompareToken(MADB_QUERY *Query, unsigned int Idx, char *Compare, size_t Length, unsigned int *Offset);
+my_bool      MADB_IsSimpleSelect(MADB_QUERY *Query);
+int          MADB_AppendLimit(MADB_QUERY *Query, SQLULEN Limit);
 
 enum enum_madb_query_type MADB_GetQueryType(const char *Token1, const char *Token2);
 
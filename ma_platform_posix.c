@@ -288,7 +288,7 @@ int MADB_ConvertAnsi2Unicode(Client_Charset *cc, const char *AnsiString, SQLLEN
 
   if (RequiredLength > UnicodeLength)
   {
-    Tmp= (SQLWCHAR *)malloc(RequiredLength * sizeof(SQLWCHAR));
+    Tmp= (SQLWCHAR *)MADB_ALLOC(RequiredLength * sizeof(SQLWCHAR));
   }
   else
   {
@@ -323,7 +323,7 @@ int MADB_ConvertAnsi2Unicode(Client_Charset *cc, const char *AnsiString, SQLLEN
   }
 end:
   if (Tmp != UnicodeString)
-    free(Tmp);
+    MADB_FREE(Tmp);
   return rc;
 }
 /* }}} */
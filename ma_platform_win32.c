@@ -205,7 +205,7 @@ int MADB_ConvertAnsi2Unicode(Client_Charset *cc, const char *AnsiString, SQLLEN
     return 0;
 
   if (RequiredLength > UnicodeLength)
-    Tmp= (SQLWCHAR *)malloc(RequiredLength * sizeof(SQLWCHAR));
+    Tmp= (SQLWCHAR *)MADB_ALLOC(RequiredLength * sizeof(SQLWCHAR));
   
   RequiredLength= MultiByteToWideChar(cc->CodePage, 0, AnsiString, IsNull ? -1 : (int)AnsiLength, Tmp, (int)RequiredLength);
   if (RequiredLength < 1)
@@ -226,7 +226,7 @@ int MADB_ConvertAnsi2Unicode(Client_Charset *cc, const char *AnsiString, SQLLEN
   }
 end:
   if (Tmp != UnicodeString)
-    free(Tmp);
+    MADB_FREE(Tmp);
   return rc;
 }
 
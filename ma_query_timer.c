@@ -0,0 +1,347 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+#ifdef _WIN32
+
+/* {{{ MADB_QueryTimerCallback */
+static VOID CALLBACK MADB_QueryTimerCallback(PVOID Param, BOOLEAN TimerOrWaitFired)
+{
+  MADB_QueryTimer *Timer= (MADB_QueryTimer *)Param;
+
+  Timer->State= MADB_TIMER_FIRING;
+  MADB_DbcKillQuery(Timer->Dbc);
+  Timer->State= MADB_TIMER_FIRED;
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerStart - arms the timer for the query, that is about to be sent over the connection. If timer can't
+       be armed, query runs w/out timeout */
+void MADB_QueryTimerStart(MADB_QueryTimer *Timer, MADB_Dbc *Dbc, SQLULEN Seconds)
+{
+  Timer->Dbc=   Dbc;
+  Timer->State= MADB_TIMER_ARMED;
+  if (!CreateTimerQueueTimer(&Timer->Handle, NULL, MADB_QueryTimerCallback, Timer, (DWORD)(Seconds * 1000), 0,
+                             WT_EXECUTEONLYONCE | WT_EXECUTELONGFUNCTION))
+  {
+    Timer->State= MADB_TIMER_IDLE;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerStop - disarms the timer, waiting for the KILL, if it is being sent. Returns TRUE if timer has
+       expired */
+my_bool MADB_QueryTimerStop(MADB_QueryTimer *Timer)
+{
+  my_bool Fired;
+
+  if (Timer->State == MADB_TIMER_IDLE)
+  {
+    return FALSE;
+  }
+  DeleteTimerQueueTimer(NULL, Timer->Handle, INVALID_HANDLE_VALUE);
+  Fired= Timer->State == MADB_TIMER_FIRED;
+  Timer->State= MADB_TIMER_IDLE;
+
+  return Fired;
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimersFree */
+void MADB_QueryTimersFree(MADB_Env *Env)
+{
+  MADB_FREE(Env->QueryTimers);
+}
+/* }}} */
+
+#else
+
+/* Deadlines are measured on the monotonic clock, so that changes of the system time don't fire timers early or late.
+   macOS has no pthread_condattr_setclock, and the condition there can only wait on the realtime clock */
+#ifdef __APPLE__
+# define MADB_TIMER_CLOCK CLOCK_REALTIME
+#else
+# define MADB_TIMER_CLOCK CLOCK_MONOTONIC
+#endif
+
+/* KILL of one expired timer, sent from its own thread. Threads are joinable - the timer thread joins finished ones,
+   and MADB_QueryTimersFree the rest, thus none outlives the environment */
+typedef struct st_madb_query_kill
+{
+  MADB_List         ListItem;
+  pthread_t         Thread;
+  MADB_QueryTimers *Timers;
+  MADB_QueryTimer  *Timer;
+} MADB_QueryKill;
+
+/* {{{ MADB_QueryTimerKill - sends the KILL for the expired timer, and marks it fired. KILL opens a new connection to
+       the server, thus it may take up to the connect timeout. Kill is NULL, if it is sent by the timer thread itself */
+static void MADB_QueryTimerKill(MADB_QueryTimers *Timers, MADB_QueryTimer *Timer, MADB_QueryKill *Kill)
+{
+  MADB_DbcKillQuery(Timer->Dbc);
+
+  pthread_mutex_lock(&Timers->Lock);
+  Timer->State= MADB_TIMER_FIRED;
+  if (Kill != NULL)
+  {
+    Timers->Kills=    MADB_ListDelete(Timers->Kills, &Kill->ListItem);
+    Timers->Finished= MADB_ListAdd(Timers->Finished, &Kill->ListItem);
+    /* for the timer thread to join it */
+    pthread_cond_signal(&Timers->Wakeup);
+  }
+  pthread_cond_broadcast(&Timers->Fired);
+  pthread_mutex_unlock(&Timers->Lock);
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerKillThread - runs the KILL of one expired timer, so that a slow KILL doesn't delay others */
+static void *MADB_QueryTimerKillThread(void *Arg)
+{
+  MADB_QueryKill *Kill= (MADB_QueryKill *)Arg;
+
+  mysql_thread_init();
+  MADB_QueryTimerKill(Kill->Timers, Kill->Timer, Kill);
+  mysql_thread_end();
+
+  return NULL;
+}
+/* }}} */
+
+/* {{{ MADB_QueryKillsJoin - joins threads of the finished KILLs, and frees them */
+static void MADB_QueryKillsJoin(MADB_List *Finished)
+{
+  MADB_QueryKill *Kill;
+
+  while (Finished != NULL)
+  {
+    Kill= (MADB_QueryKill *)Finished->data;
+    Finished= MADB_ListDelete(Finished, Finished);
+    pthread_join(Kill->Thread, NULL);
+    MADB_FREE(Kill);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerThread - kills queries of expired timers. Every KILL is sent by its own thread, or inline, if the
+       thread can't be started. The timer stays in FIRING state meanwhile, and can't be stopped until KILL is done -
+       thus KILL can't hit the next query */
+static void *MADB_QueryTimerThread(void *Arg)
+{
+  MADB_QueryTimers *Timers= (MADB_QueryTimers *)Arg;
+  MADB_QueryTimer  *Timer, *Nearest;
+  MADB_QueryKill   *Kill;
+  MADB_List        *Item;
+  struct timespec   Now;
+
+  mysql_thread_init();
+  pthread_mutex_lock(&Timers->Lock);
+  while (!Timers->Shutdown)
+  {
+    if (Timers->Finished != NULL)
+    {
+      Item= Timers->Finished;
+      Timers->Finished= NULL;
+      pthread_mutex_unlock(&Timers->Lock);
+      MADB_QueryKillsJoin(Item);
+      pthread_mutex_lock(&Timers->Lock);
+      continue;
+    }
+
+    Nearest= NULL;
+    for (Item= Timers->Armed; Item != NULL; Item= Item->next)
+    {
+      Timer= (MADB_QueryTimer *)Item->data;
+      if (Nearest == NULL || Timer->Deadline.tv_sec < Nearest->Deadline.tv_sec ||
+          (Timer->Deadline.tv_sec == Nearest->Deadline.tv_sec && Timer->Deadline.tv_nsec < Nearest->Deadline.tv_nsec))
+      {
+        Nearest= Timer;
+      }
+    }
+
+    if (Nearest == NULL)
+    {
+      pthread_cond_wait(&Timers->Wakeup, &Timers->Lock);
+      continue;
+    }
+    clock_gettime(MADB_TIMER_CLOCK, &Now);
+    if (Now.tv_sec < Nearest->Deadline.tv_sec ||
+        (Now.tv_sec == Nearest->Deadline.tv_sec && Now.tv_nsec < Nearest->Deadline.tv_nsec))
+    {
+      pthread_cond_timedwait(&Timers->Wakeup, &Timers->Lock, &Nearest->Deadline);
+      continue;
+    }
+
+    Timers->Armed= MADB_ListDelete(Timers->Armed, &Nearest->ListItem);
+    Nearest->State= MADB_TIMER_FIRING;
+    if ((Kill= (MADB_QueryKill *)MADB_CALLOC(sizeof(MADB_QueryKill))) != NULL)
+    {
+      Kill->Timers=        Timers;
+      Kill->Timer=         Nearest;
+      Kill->ListItem.data= (void *)Kill;
+      Timers->Kills= MADB_ListAdd(Timers->Kills, &Kill->ListItem);
+    }
+    pthread_mutex_unlock(&Timers->Lock);
+
+    if (Kill != NULL && pthread_create(&Kill->Thread, NULL, MADB_QueryTimerKillThread, Kill) != 0)
+    {
+      pthread_mutex_lock(&Timers->Lock);
+      Timers->Kills= MADB_ListDelete(Timers->Kills, &Kill->ListItem);
+      pthread_mutex_unlock(&Timers->Lock);
+      MADB_FREE(Kill);
+    }
+    if (Kill == NULL)
+    {
+      MADB_QueryTimerKill(Timers, Nearest, NULL);
+    }
+
+    pthread_mutex_lock(&Timers->Lock);
+  }
+  pthread_mutex_unlock(&Timers->Lock);
+  mysql_thread_end();
+
+  return NULL;
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerStart - arms the timer for the query, that is about to be sent over the connection. If timer can't
+       be armed, query runs w/out timeout */
+void MADB_QueryTimerStart(MADB_QueryTimer *Timer, MADB_Dbc *Dbc, SQLULEN Seconds)
+{
+  MADB_Env         *Env= Dbc->Environment;
+  MADB_QueryTimers *Timers;
+
+  Timer->Dbc=   Dbc;
+  Timer->State= MADB_TIMER_IDLE;
+
+  if (Env == NULL)
+  {
+    return;
+  }
+  EnterCriticalSection(&Env->cs);
+  if (Env->QueryTimers == NULL && (Env->QueryTimers= (MADB_QueryTimers *)MADB_CALLOC(sizeof(MADB_QueryTimers))) != NULL)
+  {
+    pthread_mutex_init(&Env->QueryTimers->Lock, NULL);
+#ifdef __APPLE__
+    pthread_cond_init(&Env->QueryTimers->Wakeup, NULL);
+#else
+    {
+      pthread_condattr_t Attr;
+
+      pthread_condattr_init(&Attr);
+      pthread_condattr_setclock(&Attr, MADB_TIMER_CLOCK);
+      pthread_cond_init(&Env->QueryTimers->Wakeup, &Attr);
+      pthread_condattr_destroy(&Attr);
+    }
+#endif
+    pthread_cond_init(&Env->QueryTimers->Fired, NULL);
+  }
+  Timers= Env->QueryTimers;
+  LeaveCriticalSection(&Env->cs);
+
+  if (Timers == NULL)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&Timers->Lock);
+  if (!Timers->Started)
+  {
+    if (pthread_create(&Timers->Thread, NULL, MADB_QueryTimerThread, Timers))
+    {
+      pthread_mutex_unlock(&Timers->Lock);
+      return;
+    }
+    Timers->Started= TRUE;
+  }
+  clock_gettime(MADB_TIMER_CLOCK, &Timer->Deadline);
+  Timer->Deadline.tv_sec+= (time_t)Seconds;
+  Timer->ListItem.data= (void *)Timer;
+  Timers->Armed= MADB_ListAdd(Timers->Armed, &Timer->ListItem);
+  Timer->State= MADB_TIMER_ARMED;
+  pthread_cond_signal(&Timers->Wakeup);
+  pthread_mutex_unlock(&Timers->Lock);
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimerStop - disarms the timer, waiting for the KILL, if it is being sent. Returns TRUE if timer has
+       expired */
+my_bool MADB_QueryTimerStop(MADB_QueryTimer *Timer)
+{
+  MADB_QueryTimers *Timers;
+  my_bool           Fired;
+
+  if (Timer->State == MADB_TIMER_IDLE)
+  {
+    return FALSE;
+  }
+  Timers= Timer->Dbc->Environment->QueryTimers;
+
+  pthread_mutex_lock(&Timers->Lock);
+  while (Timer->State == MADB_TIMER_FIRING)
+  {
+    pthread_cond_wait(&Timers->Fired, &Timers->Lock);
+  }
+  if (Timer->State == MADB_TIMER_ARMED)
+  {
+    Timers->Armed= MADB_ListDelete(Timers->Armed, &Timer->ListItem);
+  }
+  Fired= Timer->State == MADB_TIMER_FIRED;
+  Timer->State= MADB_TIMER_IDLE;
+  pthread_mutex_unlock(&Timers->Lock);
+
+  return Fired;
+}
+/* }}} */
+
+/* {{{ MADB_QueryTimersFree - stops timer thread of the environment, and joins threads of KILLs */
+void MADB_QueryTimersFree(MADB_Env *Env)
+{
+  MADB_QueryTimers *Timers= Env->QueryTimers;
+
+  if (Timers == NULL)
+  {
+    return;
+  }
+  pthread_mutex_lock(&Timers->Lock);
+  Timers->Shutdown= TRUE;
+  pthread_cond_signal(&Timers->Wakeup);
+  pthread_mutex_unlock(&Timers->Lock);
+
+  if (Timers->Started)
+  {
+    pthread_join(Timers->Thread, NULL);
+  }
+
+  /* Timer thread doesn't start new ones anymore */
+  pthread_mutex_lock(&Timers->Lock);
+  while (Timers->Kills != NULL)
+  {
+    pthread_cond_wait(&Timers->Fired, &Timers->Lock);
+  }
+  pthread_mutex_unlock(&Timers->Lock);
+  MADB_QueryKillsJoin(Timers->Finished);
+  Timers->Finished= NULL;
+  pthread_cond_destroy(&Timers->Fired);
+  pthread_cond_destroy(&Timers->Wakeup);
+  pthread_mutex_destroy(&Timers->Lock);
+  MADB_FREE(Env->QueryTimers);
+}
+/* }}} */
+
+#endif
@@ -0,0 +1,62 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#ifndef _ma_query_timer_h_
+#define _ma_query_timer_h_
+
+/* Enforcement of SQL_ATTR_QUERY_TIMEOUT. When the timer expires, the query running on the connection is killed
+   with MADB_DbcKillQuery */
+enum enum_madb_timer_state { MADB_TIMER_IDLE= 0, MADB_TIMER_ARMED, MADB_TIMER_FIRING, MADB_TIMER_FIRED };
+
+typedef struct st_madb_query_timer
+{
+  MADB_Dbc            *Dbc;
+  volatile int         State;
+#ifdef _WIN32
+  HANDLE               Handle;
+#else
+  MADB_List            ListItem;
+  struct timespec      Deadline;
+#endif
+} MADB_QueryTimer;
+
+/* Timers of the environment's connections. On Windows they are served by the system timer queue, elsewhere by one
+   thread, started on first use and stopped when the environment is freed. KILLs of expired timers are sent from
+   separate threads, that are joined by the timer thread, or when the environment is freed */
+typedef struct st_madb_query_timers
+{
+#ifndef _WIN32
+  pthread_mutex_t      Lock;
+  pthread_cond_t       Wakeup;    /* Timer thread waits on it for the nearest deadline */
+  pthread_cond_t       Fired;     /* Stopping thread waits on it for the KILL in progress */
+  MADB_List           *Kills;     /* Threads of KILLs in progress */
+  MADB_List           *Finished;  /* Threads of finished KILLs, not joined yet */
+  pthread_t            Thread;
+  my_bool              Started;
+  my_bool              Shutdown;
+  MADB_List           *Armed;
+#else
+  int                  Unused;
+#endif
+} MADB_QueryTimers;
+
+void    MADB_QueryTimerStart(MADB_QueryTimer *Timer, MADB_Dbc *Dbc, SQLULEN Seconds);
+my_bool MADB_QueryTimerStop(MADB_QueryTimer *Timer);
+void    MADB_QueryTimersFree(MADB_Env *Env);
+
+#endif /* _ma_query_timer_h_ */
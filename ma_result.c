@@ -38,6 +38,7 @@ void MADB_StmtResetResultStructures(MADB_Stmt *Stmt)
   }
 
   Stmt->LastRowFetched= 0;
+  Stmt->Cursor.Streamed= 0;
   MADB_STMT_RESET_CURSOR(Stmt);
 }
 /* }}} */
@@ -52,7 +53,7 @@ SQLRETURN MoveNext(MADB_Stmt *Stmt, unsigned long long Offset)
     unsigned int i;
     char        *SavedFlag;
 
-    SavedFlag= (char*)MADB_CALLOC(mysql_stmt_field_count(Stmt->stmt));
+    SavedFlag= MADB_StmtArenaBuffer(Stmt, &Stmt->SavedFlags, mysql_stmt_field_count(Stmt->stmt));
 
     if (SavedFlag == NULL)
     {
@@ -79,8 +80,6 @@ SQLRETURN MoveNext(MADB_Stmt *Stmt, unsigned long long Offset)
     {
       Stmt->stmt->bind[i].flags &= (~MADB_BIND_DUMMY | SavedFlag[i]);
     }
-
-    MADB_FREE(SavedFlag);
   }
   return result;
 }
@@ -102,22 +101,37 @@ SQLRETURN MADB_StmtDataSeek(MADB_Stmt *Stmt, my_ulonglong FetchOffset)
 }
 /* }}} */
 
-/* {{{  */
-void QuickDropAllPendingResults(MYSQL* Mariadb)
+/* {{{ MADB_KillOnDrain */
+static void MADB_KillOnDrain(MYSQL *Mariadb, void *Dbc)
+{
+  MADB_DbcKillQuery((MADB_Dbc *)Dbc);
+}
+/* }}} */
+
+/* {{{ MADB_DrainResult - reads off the rest of the current unbuffered text protocol result. The rows are not stored,
+       and if more than DRAIN_KILL_SIZE bytes had to be skipped, the query is killed */
+void MADB_DrainResult(MADB_Dbc *Dbc, MYSQL *Mariadb)
+{
+  mariadb_skip_result(Mariadb, Dbc->Dsn ? Dbc->Dsn->DrainKillSize : 0, MADB_KillOnDrain, Dbc);
+}
+/* }}} */
+
+/* {{{ MADB_StmtDrainResult - same as MADB_DrainResult for the binary protocol */
+void MADB_StmtDrainResult(MADB_Stmt *Stmt, MYSQL_STMT *stmt)
+{
+  mariadb_stmt_skip_result(stmt, Stmt->Connection->Dsn ? Stmt->Connection->Dsn->DrainKillSize : 0, MADB_KillOnDrain,
+                           Stmt->Connection);
+}
+/* }}} */
+
+/* {{{ QuickDropAllPendingResults */
+void QuickDropAllPendingResults(MADB_Dbc *Dbc, MYSQL* Mariadb)
 {
   int Next= 0;
   do {
-    if (Next == 0)
+    if (Next == 0 && mysql_field_count(Mariadb) > 0)
     {
-      if (mysql_field_count(Mariadb) > 0)
-      {
-        MYSQL_RES *Res= mysql_store_result(Mariadb);
-
-        if (Res)
-        {
-          mysql_free_result(Res);
-        }
-      }
+      MADB_DrainResult(Dbc, Mariadb);
     }
   } while ((Next= mysql_next_result(Mariadb)) != -1);
 }
@@ -132,6 +146,7 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
   {
     return MADB_SetError(&Stmt->Error, MADB_ERR_08S01, NULL, 0);
   }
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   /* We can't have it in MADB_StmtResetResultStructures, as it breaks dyn_cursor functionality.
      Thus we free-ing bind structs on move to new result only */
@@ -174,11 +189,7 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
       }
       else if (mysql_field_count(Stmt->Connection->mariadb) != 0)
       {
-        MYSQL_RES *Res= mysql_store_result(Stmt->Connection->mariadb);
-        if (Res != NULL)
-        {
-          mysql_free_result(Res);
-        }
+        MADB_DrainResult(Stmt->Connection, Stmt->Connection->mariadb);
         ret= MADB_SetError(&Stmt->Error, MADB_ERR_01000, "Internal error - unexpected text result received", 0);
       }
       else
@@ -192,12 +203,15 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
 
   if (MADB_SSPS_DISABLED(Stmt))
   {
+      LOCK_MARIADB(Stmt->Connection);
+      // Unbuffered result has to be read off before the next one. Only then the server status tells if there is one.
+      MADB_DrainResult(Stmt->Connection, Stmt->stmt->mysql);
       if (!mysql_more_results(Stmt->stmt->mysql))
       {
+          UNLOCK_MARIADB(Stmt->Connection);
           return SQL_NO_DATA;
       }
 
-      LOCK_MARIADB(Stmt->Connection);
       if (mysql_next_result(Stmt->stmt->mysql))
       {
           ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY000, mysql_error(Stmt->stmt->mysql), 0);
@@ -234,6 +248,7 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
       return ret;
   }
 
+  MADB_StmtDrainResult(Stmt, Stmt->stmt);
   if (mysql_stmt_more_results(Stmt->stmt))
   {
     mysql_stmt_free_result(Stmt->stmt);
@@ -275,7 +290,10 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
     {
       if (!NO_CACHE(Stmt))
       {
-        mysql_stmt_store_result(Stmt->stmt);
+        if (mysql_stmt_store_result(Stmt->stmt) == 0)
+        {
+          MADB_LimitStoredResult(Stmt, Stmt->stmt);
+        }
         mysql_stmt_data_seek(Stmt->stmt, 0);
       }
     }
@@ -308,3 +326,39 @@ SQLULEN MADB_RowsToFetch(MADB_Cursor *Cursor, unsigned long long RowsInResultst)
 }
 /* }}} */
 
+/* {{{ MADB_StreamedRowsToFetch - number of rows to fetch from the unbuffered result, respecting SQL_ATTR_MAX_ROWS */
+SQLULEN MADB_StreamedRowsToFetch(MADB_Stmt *Stmt)
+{
+  SQLULEN MaxRows= (SQLULEN)Stmt->Options.MaxRows;
+
+  if (MaxRows == 0)
+  {
+    return Stmt->Cursor.RowsetSize;
+  }
+  if (Stmt->Cursor.Streamed >= MaxRows)
+  {
+    return 0;
+  }
+  return MIN((SQLULEN)Stmt->Cursor.RowsetSize, MaxRows - Stmt->Cursor.Streamed);
+}
+/* }}} */
+
+/* {{{ MADB_LimitStoredResult - cuts the buffered result down to SQL_ATTR_MAX_ROWS rows. Rows beyond the limit stay in the
+       result's memory root and are released together with it, thus this costs only walking the list up to the limit */
+void MADB_LimitStoredResult(MADB_Stmt *Stmt, MYSQL_STMT *stmt)
+{
+  unsigned long long MaxRows= (unsigned long long)Stmt->Options.MaxRows, i;
+  MYSQL_ROWS        *Row= stmt->result.data;
+
+  if (MaxRows == 0 || stmt->result.rows <= MaxRows || Row == NULL)
+  {
+    return;
+  }
+  for (i= 1; i < MaxRows && Row->next != NULL; ++i)
+  {
+    Row= Row->next;
+  }
+  Row->next= NULL;
+  stmt->result.rows= MaxRows;
+}
+/* }}} */
@@ -24,6 +24,11 @@ void MADB_StmtResetResultStructures(MADB_Stmt *Stmt);
 SQLRETURN MoveNext(MADB_Stmt *Stmt, unsigned long long Offset);
 SQLRETURN MADB_StmtDataSeek   (MADB_Stmt *Stmt, my_ulonglong FetchOffset);
 SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt);
+void      MADB_DrainResult(MADB_Dbc *Dbc, MYSQL *Mariadb);
+void      MADB_StmtDrainResult(MADB_Stmt *Stmt, MYSQL_STMT *stmt);
+void      QuickDropAllPendingResults(MADB_Dbc *Dbc, MYSQL* Mariadb);
 SQLULEN   MADB_RowsToFetch(MADB_Cursor *Cursor, unsigned long long RowsInResultst);
+SQLULEN   MADB_StreamedRowsToFetch(MADB_Stmt *Stmt);
+void      MADB_LimitStoredResult(MADB_Stmt *Stmt, MYSQL_STMT *stmt);
 
  #endif /* _ma_result_h_ */
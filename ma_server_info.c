@@ -0,0 +1,179 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+/* Entries are keyed by host, port, user and the database, the connection has been established in - the database
+   character set depends on the latter */
+typedef struct st_madb_server_info
+{
+  MADB_List          ListItem;
+  char              *Key;
+  unsigned long long Expires;        /* ms of MADB_AsyncTime - monotonic, unaffected by the system time changes */
+  my_bool            HasVersion;
+  char              *SsVersion;      /* @@memsql_version, NULL if the server didn't tell */
+  unsigned int       DBCharsetnr;
+} MADB_SERVER_INFO;
+
+/* Static initialization - the cache may be used before any handle of the driver is allocated */
+#ifdef _WIN32
+static SRWLOCK ServerInfoLock= SRWLOCK_INIT;
+# define LOCK_SERVER_INFO()   AcquireSRWLockExclusive(&ServerInfoLock)
+# define UNLOCK_SERVER_INFO() ReleaseSRWLockExclusive(&ServerInfoLock)
+#else
+static pthread_mutex_t ServerInfoLock= PTHREAD_MUTEX_INITIALIZER;
+# define LOCK_SERVER_INFO()   pthread_mutex_lock(&ServerInfoLock)
+# define UNLOCK_SERVER_INFO() pthread_mutex_unlock(&ServerInfoLock)
+#endif
+
+static MADB_List   *ServerInfo= NULL;   /* Most recently stored first */
+static unsigned int ServerInfoCount= 0;
+
+/* {{{ MADB_ServerInfoKey - mysql->db is not used, as it may be stale. Returns FALSE, if the current database is not
+       known, e.g. the init command could change it, and the cache can't be used */
+static my_bool MADB_ServerInfoKey(MADB_Dbc *Dbc, char *Key, size_t KeyLength)
+{
+  MYSQL      *Mariadb= Dbc->mariadb;
+  const char *Catalog= MADB_IS_EMPTY(Dbc->CatalogName) ? Dbc->Dsn->Catalog : Dbc->CatalogName;
+
+  if (Dbc->CurrentDbUnknown)
+  {
+    return FALSE;
+  }
+  _snprintf(Key, KeyLength, "%s:%u:%s:%s", Mariadb->host ? Mariadb->host : "", Mariadb->port,
+            Mariadb->user ? Mariadb->user : "", Catalog ? Catalog : "");
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_ServerInfoFree */
+static void MADB_ServerInfoFree(MADB_SERVER_INFO *Info)
+{
+  MADB_FREE(Info->Key);
+  MADB_FREE(Info->SsVersion);
+  MADB_FREE(Info);
+}
+/* }}} */
+
+/* {{{ MADB_ServerInfoFind - returns the entry for the key, freeing expired entries on the way. Caller has to hold
+       the cache lock */
+static MADB_SERVER_INFO *MADB_ServerInfoFind(const char *Key, unsigned long long Now)
+{
+  MADB_List *Item, *Next;
+  MADB_SERVER_INFO *Info, *Found= NULL;
+
+  for (Item= ServerInfo; Item != NULL; Item= Next)
+  {
+    Next= Item->next;
+    Info= (MADB_SERVER_INFO *)Item->data;
+
+    if (Info->Expires <= Now)
+    {
+      ServerInfo= MADB_ListDelete(ServerInfo, Item);
+      --ServerInfoCount;
+      MADB_ServerInfoFree(Info);
+    }
+    else if (Found == NULL && strcmp(Info->Key, Key) == 0)
+    {
+      Found= Info;
+    }
+  }
+  return Found;
+}
+/* }}} */
+
+/* {{{ MADB_ServerInfoGet - fills the connection's server info from the cache. Returns FALSE if there is no fresh entry,
+       and discovery queries have to be run */
+my_bool MADB_ServerInfoGet(MADB_Dbc *Dbc, my_bool NeedVersion)
+{
+  MADB_SERVER_INFO *Info;
+  char Key[512];
+  my_bool Found= FALSE;
+
+  if (Dbc->Dsn == NULL || Dbc->Dsn->ServerInfoTtl == 0 || !MADB_ServerInfoKey(Dbc, Key, sizeof(Key)))
+  {
+    return FALSE;
+  }
+
+  LOCK_SERVER_INFO();
+  if ((Info= MADB_ServerInfoFind(Key, MADB_AsyncTime())) != NULL && (Info->HasVersion || !NeedVersion))
+  {
+    Dbc->DBCharsetnr= Info->DBCharsetnr;
+    if (NeedVersion && Info->SsVersion != NULL)
+    {
+      mysql_optionsv(Dbc->mariadb, MYSQL_SS_VERSION, Info->SsVersion);
+    }
+    Found= TRUE;
+  }
+  UNLOCK_SERVER_INFO();
+
+  return Found;
+}
+/* }}} */
+
+/* {{{ MADB_ServerInfoPut - stores the server info the connection has just discovered */
+void MADB_ServerInfoPut(MADB_Dbc *Dbc, my_bool HasVersion)
+{
+  MADB_SERVER_INFO *Info;
+  MADB_List *Last;
+  const char *SsVersion= HasVersion ? Dbc->mariadb->ss_version : NULL;
+  char Key[512];
+  unsigned long long Now= MADB_AsyncTime();
+
+  if (Dbc->Dsn == NULL || Dbc->Dsn->ServerInfoTtl == 0 || !MADB_ServerInfoKey(Dbc, Key, sizeof(Key)))
+  {
+    return;
+  }
+
+  LOCK_SERVER_INFO();
+  if ((Info= MADB_ServerInfoFind(Key, Now)) != NULL)
+  {
+    ServerInfo= MADB_ListDelete(ServerInfo, &Info->ListItem);
+    --ServerInfoCount;
+    MADB_ServerInfoFree(Info);
+  }
+
+  if ((Info= (MADB_SERVER_INFO *)MADB_CALLOC(sizeof(MADB_SERVER_INFO))) == NULL ||
+      (Info->Key= MADB_STRDUP(Key)) == NULL ||
+      (SsVersion != NULL && (Info->SsVersion= MADB_STRDUP(SsVersion)) == NULL))
+  {
+    if (Info != NULL)
+    {
+      MADB_ServerInfoFree(Info);
+    }
+    UNLOCK_SERVER_INFO();
+    return;
+  }
+  Info->Expires=     Now + (unsigned long long)Dbc->Dsn->ServerInfoTtl * 1000;
+  Info->HasVersion=  HasVersion;
+  Info->DBCharsetnr= Dbc->DBCharsetnr;
+
+  while (ServerInfoCount >= MADB_SERVER_INFO_MAX_ENTRIES)
+  {
+    for (Last= ServerInfo; Last->next != NULL; Last= Last->next);
+    ServerInfo= MADB_ListDelete(ServerInfo, Last);
+    --ServerInfoCount;
+    MADB_ServerInfoFree((MADB_SERVER_INFO *)Last->data);
+  }
+
+  Info->ListItem.data= (void *)Info;
+  ServerInfo= MADB_ListAdd(ServerInfo, &Info->ListItem);
+  ++ServerInfoCount;
+  UNLOCK_SERVER_INFO();
+}
+/* }}} */
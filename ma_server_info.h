@@ -0,0 +1,29 @@
+/*************************************************************************************
+  Copyright (c) 2021 SingleStore, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public
+  License along with this library; if not see <http://www.gnu.org/licenses>
+  or write to the Free Software Foundation, Inc.,
+  51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#ifndef _ma_server_info_h_
+#define _ma_server_info_h_
+
+/* Process-wide cache of the facts about the server, that connections would otherwise query right after connect */
+#define MADB_SERVER_INFO_DEFAULT_TTL 60   /* seconds */
+#define MADB_SERVER_INFO_MAX_ENTRIES 64
+
+my_bool MADB_ServerInfoGet(MADB_Dbc *Dbc, my_bool NeedVersion);
+void    MADB_ServerInfoPut(MADB_Dbc *Dbc, my_bool HasVersion);
+
+#endif /* _ma_server_info_h_ */
@@ -23,13 +23,95 @@
 
 struct st_ma_stmt_methods MADB_StmtMethods; /* declared at the end of file */
 
+/* {{{ MADB_StmtRecycle - puts the dropped statement object with its implicit descriptors to the connection's free
+       list, so that next MADB_StmtInit does not need to allocate them. Returns FALSE if the list is full, and the
+       caller has to free the object */
+static BOOL MADB_StmtRecycle(MADB_Stmt *Stmt)
+{
+  MADB_Dbc  *Dbc= Stmt->Connection;
+  MADB_Desc *IApd= Stmt->IApd, *IArd= Stmt->IArd, *IIpd= Stmt->IIpd, *IIrd= Stmt->IIrd;
+  MA_MEM_ROOT Arena;
+  BOOL       Recycled= FALSE;
+
+  MADB_DescReset(IApd);
+  MADB_DescReset(IArd);
+  MADB_DescReset(IIpd);
+  MADB_DescReset(IIrd);
+  MADB_StmtArenaReset(Stmt);
+  Arena= Stmt->Arena;
+
+  memset(Stmt, 0, sizeof(MADB_Stmt));
+  Stmt->IApd= IApd;
+  Stmt->IArd= IArd;
+  Stmt->IIpd= IIpd;
+  Stmt->IIrd= IIrd;
+  Stmt->Arena= Arena;
+  Stmt->ListItem.data= (void *)Stmt;
+
+  EnterCriticalSection(&Dbc->ListsCs);
+  if (Dbc->FreeStmtsCount < MADB_STMT_FREE_LIST_SIZE)
+  {
+    Dbc->FreeStmts= MADB_ListAdd(Dbc->FreeStmts, &Stmt->ListItem);
+    ++Dbc->FreeStmtsCount;
+    Recycled= TRUE;
+  }
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  return Recycled;
+}
+/* }}} */
+
+/* {{{ MADB_StmtFreeListClear - frees statement objects kept for reuse by the connection */
+void MADB_StmtFreeListClear(MADB_Dbc *Dbc)
+{
+  MADB_Stmt *Stmt;
+
+  while (Dbc->FreeStmts != NULL)
+  {
+    Stmt= (MADB_Stmt *)Dbc->FreeStmts->data;
+    Dbc->FreeStmts= MADB_ListDelete(Dbc->FreeStmts, Dbc->FreeStmts);
+
+    MADB_DescFree(Stmt->IApd, FALSE);
+    MADB_DescFree(Stmt->IArd, FALSE);
+    MADB_DescFree(Stmt->IIpd, FALSE);
+    MADB_DescFree(Stmt->IIrd, FALSE);
+    MADB_StmtArenaFree(Stmt);
+    MADB_FREE(Stmt);
+  }
+  Dbc->FreeStmtsCount= 0;
+}
+/* }}} */
+
 /* {{{ MADB_StmtInit */
 SQLRETURN MADB_StmtInit(MADB_Dbc *Connection, SQLHANDLE *pHStmt)
 {
   MADB_Stmt *Stmt= NULL;
 
-  if (!(Stmt = (MADB_Stmt *)MADB_CALLOC(sizeof(MADB_Stmt))))
-    goto error;
+  /* Statement object of previously dropped handle already has its descriptors allocated */
+  EnterCriticalSection(&Connection->ListsCs);
+  if (Connection->FreeStmts != NULL)
+  {
+    Stmt= (MADB_Stmt *)Connection->FreeStmts->data;
+    Connection->FreeStmts= MADB_ListDelete(Connection->FreeStmts, Connection->FreeStmts);
+    --Connection->FreeStmtsCount;
+  }
+  LeaveCriticalSection(&Connection->ListsCs);
+
+  if (Stmt != NULL)
+  {
+    MADB_PutErrorPrefix(Connection, &Stmt->IApd->Error);
+    MADB_PutErrorPrefix(Connection, &Stmt->IArd->Error);
+    MADB_PutErrorPrefix(Connection, &Stmt->IIpd->Error);
+    MADB_PutErrorPrefix(Connection, &Stmt->IIrd->Error);
+  }
+  else if (!(Stmt = (MADB_Stmt *)MADB_CALLOC(sizeof(MADB_Stmt))))
+  {
+    return SQL_ERROR;
+  }
+  else
+  {
+    MADB_StmtArenaInit(Stmt);
+  }
  
   MADB_PutErrorPrefix(Connection, &Stmt->Error);
   *pHStmt= Stmt;
@@ -38,10 +120,10 @@ SQLRETURN MADB_StmtInit(MADB_Dbc *Connection, SQLHANDLE *pHStmt)
   LOCK_MARIADB(Connection);
 
   if (!(Stmt->stmt= MADB_NewStmtHandle(Stmt)) ||
-    !(Stmt->IApd= MADB_DescInit(Connection, MADB_DESC_APD, FALSE)) ||
-    !(Stmt->IArd= MADB_DescInit(Connection, MADB_DESC_ARD, FALSE)) ||
-    !(Stmt->IIpd= MADB_DescInit(Connection, MADB_DESC_IPD, FALSE)) ||
-    !(Stmt->IIrd= MADB_DescInit(Connection, MADB_DESC_IRD, FALSE)))
+    (Stmt->IApd == NULL && !(Stmt->IApd= MADB_DescInit(Connection, MADB_DESC_APD, FALSE))) ||
+    (Stmt->IArd == NULL && !(Stmt->IArd= MADB_DescInit(Connection, MADB_DESC_ARD, FALSE))) ||
+    (Stmt->IIpd == NULL && !(Stmt->IIpd= MADB_DescInit(Connection, MADB_DESC_IPD, FALSE))) ||
+    (Stmt->IIrd == NULL && !(Stmt->IIrd= MADB_DescInit(Connection, MADB_DESC_IRD, FALSE))))
   {
     UNLOCK_MARIADB(Stmt->Connection);
     goto error;
@@ -54,6 +136,7 @@ SQLRETURN MADB_StmtInit(MADB_Dbc *Connection, SQLHANDLE *pHStmt)
   Stmt->Options.CursorType= SQL_CURSOR_FORWARD_ONLY;
   Stmt->Options.UseBookmarks= SQL_UB_OFF;
   Stmt->Options.MetadataId= Connection->MetadataId;
+  Stmt->Options.AsyncEnable= Connection->AsyncEnable;
 
   Stmt->Apd= Stmt->IApd;
   Stmt->Ard= Stmt->IArd;
@@ -70,14 +153,15 @@ SQLRETURN MADB_StmtInit(MADB_Dbc *Connection, SQLHANDLE *pHStmt)
   return SQL_SUCCESS;
 
 error:
-  if (Stmt && Stmt->stmt)
+  if (Stmt->stmt)
   {
     MADB_STMT_CLOSE_STMT(Stmt);
   }
-  MADB_DescFree(Stmt->IApd, TRUE);
-  MADB_DescFree(Stmt->IArd, TRUE);
-  MADB_DescFree(Stmt->IIpd, TRUE);
-  MADB_DescFree(Stmt->IIrd, TRUE);
+  MADB_DescFree(Stmt->IApd, FALSE);
+  MADB_DescFree(Stmt->IArd, FALSE);
+  MADB_DescFree(Stmt->IIpd, FALSE);
+  MADB_DescFree(Stmt->IIrd, FALSE);
+  MADB_StmtArenaFree(Stmt);
   MADB_FREE(Stmt);
   return SQL_ERROR;
 }
@@ -117,6 +201,7 @@ SQLRETURN MADB_ExecuteQuery(MADB_Stmt * Stmt, char *StatementText, SQLINTEGER Te
 SQLRETURN MADB_StmtBulkOperations(MADB_Stmt *Stmt, SQLSMALLINT Operation)
 {
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
   switch(Operation)
   {
   case SQL_ADD:
@@ -181,16 +266,22 @@ void MADB_CspsFreeResult(MADB_Stmt *Stmt, MYSQL_RES** CspsResult, MYSQL_STMT *st
                 stmt->result_cursor = NULL;
                 stmt->field_count = 0;
                 stmt->fields = NULL;
+            }
 
-                while(mysql_more_results(stmt->mysql))
-                {
-                    mysql_next_result(stmt->mysql);
-                }
+            // Rows of the unbuffered result that were not fetched are skipped without being stored.
+            if ((*CspsResult)->handle != NULL)
+            {
+                MADB_DrainResult(Stmt->Connection, (*CspsResult)->handle);
             }
 
             // Free the result and set the ptr to NULL so it does not get released twice.
             mysql_free_result(*CspsResult);
             *CspsResult = NULL;
+
+            if (stmt)
+            {
+                QuickDropAllPendingResults(Stmt->Connection, stmt->mysql);
+            }
         }
     }
 }
@@ -219,7 +310,9 @@ void MADB_CspsCopyResult(MADB_Stmt *Stmt, MYSQL_RES* CspsResult, MYSQL_STMT *stm
                 stmt->result.fields = CspsResult->data->fields;
                 stmt->result.rows = CspsResult->data->rows;
                 stmt->result_cursor = CspsResult->data_cursor;
+                MADB_LimitStoredResult(Stmt, stmt);
             }
+            Stmt->Cursor.Streamed= 0;
         }
     }
 }
@@ -240,6 +333,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
       if (Stmt->State > MADB_SS_PREPARED && !QUERY_IS_MULTISTMT(Stmt->Query))
       {
         MADB_CspsFreeResult(Stmt, &Stmt->CspsResult, Stmt->stmt);
+        MADB_StmtDrainResult(Stmt, Stmt->stmt);
         MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_free_result(%0x)", Stmt->stmt);
         mysql_stmt_free_result(Stmt->stmt);
         LOCK_MARIADB(Stmt->Connection);
@@ -268,6 +362,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
       MADB_FREE(Stmt->result);
       MADB_FREE(Stmt->CharOffset);
       MADB_FREE(Stmt->Lengths);
+      MADB_StmtArenaReset(Stmt);
 
       RESET_STMT_STATE(Stmt);
       RESET_DAE_STATUS(Stmt);
@@ -295,28 +390,19 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
     MADB_FREE(Stmt->TableName);
     ResetMetadata(&Stmt->metadata, NULL);
 
-    /* For explicit descriptors we only remove reference to the stmt*/
+    /* For explicit descriptors we only remove reference to the stmt. Implicit ones are freed, or reset for the reuse,
+       together with the statement object */
     if (Stmt->Apd->AppType)
     {
       EnterCriticalSection(&Stmt->Connection->ListsCs);
       RemoveStmtRefFromDesc(Stmt->Apd, Stmt, TRUE);
       LeaveCriticalSection(&Stmt->Connection->ListsCs);
-      MADB_DescFree(Stmt->IApd, FALSE);
-    }
-    else
-    {
-      MADB_DescFree( Stmt->Apd, FALSE);
     }
     if (Stmt->Ard->AppType)
     {
       EnterCriticalSection(&Stmt->Connection->ListsCs);
       RemoveStmtRefFromDesc(Stmt->Ard, Stmt, TRUE);
       LeaveCriticalSection(&Stmt->Connection->ListsCs);
-      MADB_DescFree(Stmt->IArd, FALSE);
-    }
-    else
-    {
-      MADB_DescFree(Stmt->Ard, FALSE);
     }
 
     if (MADB_SSPS_DISABLED(Stmt))
@@ -324,8 +410,6 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
         // Release the memory allocated for the DAE params.
         MADB_CspsFreeDAE(Stmt);
     }
-    MADB_DescFree(Stmt->Ipd, FALSE);
-    MADB_DescFree(Stmt->Ird, FALSE);
 
     MADB_FREE(Stmt->CharOffset);
     MADB_FREE(Stmt->Lengths);
@@ -363,8 +447,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
     else if (Stmt->stmt != NULL)
     {
       MADB_CspsFreeResult(Stmt, &Stmt->CspsResult, Stmt->stmt);
-      MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
-      MADB_STMT_CLOSE_STMT(Stmt);
+      MADB_StmtReleaseHandle(Stmt);
     }
     /* Query has to be deleted after multistmt handles are closed, since the depends on info in the Query */
     MADB_DeleteQuery(&Stmt->Query);
@@ -372,8 +455,24 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
     EnterCriticalSection(&Stmt->Connection->ListsCs);
     Stmt->Connection->Stmts= MADB_ListDelete(Stmt->Connection->Stmts, &Stmt->ListItem);
     LeaveCriticalSection(&Stmt->Connection->ListsCs);
-    
-    MADB_FREE(Stmt);
+
+    /* Connection must not keep pointer to the freed, or recycled, statement */
+    if (Stmt->Connection->AsyncStmt == Stmt)
+    {
+      Stmt->Connection->AsyncStmt= NULL;
+    }
+    Stmt->Async.Func= MADB_ASYNC_NONE;
+    MADB_FREE(Stmt->Async.StatementText);
+
+    if (!MADB_StmtRecycle(Stmt))
+    {
+      MADB_DescFree(Stmt->IApd, FALSE);
+      MADB_DescFree(Stmt->IArd, FALSE);
+      MADB_DescFree(Stmt->IIpd, FALSE);
+      MADB_DescFree(Stmt->IIrd, FALSE);
+      MADB_StmtArenaFree(Stmt);
+      MADB_FREE(Stmt);
+    }
   } /* End of switch (Option) */
   return SQL_SUCCESS;
 }
@@ -407,7 +506,18 @@ SQLRETURN MADB_StmtExecDirect(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER T
     ExecDirect= FALSE;
   }
 
-  return Stmt->Methods->Execute(Stmt, ExecDirect);
+  ret= Stmt->Methods->Execute(Stmt, ExecDirect);
+
+  /* If the statement was not prepared before execution, preparation errors come from the execution. Falling back to the text
+     protocol for the same errors as above */
+  if (!SQL_SUCCEEDED(ret) && Stmt->PendingPrepare != NULL && !QUERY_IS_MULTISTMT(Stmt->Query) &&
+      (Stmt->Error.NativeError == 1295/*ER_UNSUPPORTED_PS*/ || Stmt->Error.NativeError == 1064/*ER_PARSE_ERROR*/))
+  {
+    Stmt->State= MADB_SS_EMULATED;
+    ret= Stmt->Methods->Execute(Stmt, ExecDirect);
+  }
+
+  return ret;
 }
 /* }}} */
 
@@ -449,14 +559,14 @@ void MADB_StmtReset(MADB_Stmt *Stmt)
     if (Stmt->State > MADB_SS_PREPARED)
     {
       MADB_CspsFreeResult(Stmt, &Stmt->CspsResult, Stmt->stmt);
+      MADB_StmtDrainResult(Stmt, Stmt->stmt);
       MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_free_result(%0x)", Stmt->stmt);
       mysql_stmt_free_result(Stmt->stmt);
     }
 
     if (Stmt->State >= MADB_SS_PREPARED)
     {
-      MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
-      MADB_STMT_CLOSE_STMT(Stmt);
+      MADB_StmtReleaseHandle(Stmt);
       Stmt->stmt= MADB_NewStmtHandle(Stmt);
 
       MDBUG_C_PRINT(Stmt->Connection, "-->inited %0x", Stmt->stmt);
@@ -500,6 +610,7 @@ void MADB_StmtReset(MADB_Stmt *Stmt)
     }
   default:
     Stmt->PositionedCommand= 0;
+    Stmt->PendingPrepare= NULL;
     Stmt->State= MADB_SS_INITED;
     MADB_CLEAR_ERROR(&Stmt->Error);
   }
@@ -524,27 +635,95 @@ SQLRETURN MADB_EDPrepare(MADB_Stmt *Stmt)
 }
 /* }}} */
 
+/* {{{ MADB_HasDaeParams - checks if any parameter in any row of the parameter array needs data at execution */
+static BOOL MADB_HasDaeParams(MADB_Stmt *Stmt)
+{
+  SQLULEN Row;
+
+  for (Row= 1; Row <= Stmt->Apd->Header.ArraySize; ++Row)
+  {
+    if (MADB_FindNextDaeParam(Stmt->Apd, -1, (SQLSMALLINT)Row) != MADB_NOPARAM)
+    {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+/* }}} */
+
+/* {{{ MADB_CanExecuteDirect - checks if the statement can be prepared and executed with one call of
+       mariadb_stmt_execute_direct(one round trip with MariaDB servers, two where Connector/C emulates it). That is not possible if any parameter needs data at execution, and is not needed
+       if the statement is already prepared and cached */
+static BOOL MADB_CanExecuteDirect(MADB_Stmt *Stmt)
+{
+  BOOL Cached;
+
+  if (QUERY_IS_MULTISTMT(Stmt->Query) || MADB_POSITIONED_COMMAND(Stmt) || MADB_HasDaeParams(Stmt))
+  {
+    return FALSE;
+  }
+
+  LOCK_MARIADB(Stmt->Connection);
+  Cached= MADB_StmtCacheHas(Stmt->Connection, STMT_STRING(Stmt));
+  UNLOCK_MARIADB(Stmt->Connection);
+
+  return !Cached;
+}
+/* }}} */
+
+/* {{{ MADB_DirectPrepare - Method called from SQLPrepare in case it is SQLExecDirect of a single statement.
+       Nothing is sent to the server - the statement will be prepared by mariadb_stmt_execute_direct in
+       MADB_DoExecute, and Stmt->State remains MADB_SS_INITED until then */
+static SQLRETURN MADB_DirectPrepare(MADB_Stmt *Stmt)
+{
+  Stmt->PendingPrepare= STMT_STRING(Stmt);
+
+  if ((Stmt->ParamCount= (SQLSMALLINT)Stmt->Query.ParamPositions.elements) != 0)
+  {
+    if (Stmt->params)
+    {
+      MADB_FREE(Stmt->params);
+    }
+    Stmt->params= (MYSQL_BIND *)MADB_CALLOC(sizeof(MYSQL_BIND) * Stmt->ParamCount);
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
 /* {{{ MADB_RegularPrepare - Method called from SQLPrepare in case it is SQLExecDirect and if !(server > 10.2)
 (i.e. we aren't going to do mariadb_stmt_exec_direct) */
 SQLRETURN MADB_RegularPrepare(MADB_Stmt *Stmt)
 {
+  MYSQL_STMT *Cached;
+
   LOCK_MARIADB(Stmt->Connection);
 
-  MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_prepare(%0x,%s)", Stmt->stmt, STMT_STRING(Stmt));
-  if (mysql_stmt_prepare(Stmt->stmt, STMT_STRING(Stmt), (unsigned long)strlen(STMT_STRING(Stmt))))
+  /* The statement might be already prepared on the server by this, or other handle. Then the cached statement
+     replaces the fresh one, and there is no need to prepare it again. Metadata comes with it */
+  if ((Cached= MADB_StmtCacheGet(Stmt->Connection, STMT_STRING(Stmt))) != NULL)
   {
-    /* Need to save error first */
-    MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
-    /* We need to close the stmt here, or it becomes unusable like in ODBC-21 */
-    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_close(%0x)", Stmt->stmt);
+    MDBUG_C_PRINT(Stmt->Connection, "-->reusing %0x", Cached);
     MADB_STMT_CLOSE_STMT(Stmt);
-    Stmt->stmt= MADB_NewStmtHandle(Stmt);
+    Stmt->stmt= Cached;
+  }
+  else
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_prepare(%0x,%s)", Stmt->stmt, STMT_STRING(Stmt));
+    if (mysql_stmt_prepare(Stmt->stmt, STMT_STRING(Stmt), (unsigned long)strlen(STMT_STRING(Stmt))))
+    {
+      /* Need to save error first */
+      MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
+      /* We need to close the stmt here, or it becomes unusable like in ODBC-21 */
+      MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_close(%0x)", Stmt->stmt);
+      MADB_STMT_CLOSE_STMT(Stmt);
+      Stmt->stmt= MADB_NewStmtHandle(Stmt);
 
-    UNLOCK_MARIADB(Stmt->Connection);
+      UNLOCK_MARIADB(Stmt->Connection);
 
-    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_init(%0x)->%0x", Stmt->Connection->mariadb, Stmt->stmt);
+      MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_init(%0x)->%0x", Stmt->Connection->mariadb, Stmt->stmt);
 
-    return Stmt->Error.ReturnValue;
+      return Stmt->Error.ReturnValue;
+    }
   }
   UNLOCK_MARIADB(Stmt->Connection);
 
@@ -578,9 +757,13 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
 
   MDBUG_C_PRINT(Stmt->Connection, "%sMADB_StmtPrepare", "\t->");
 
-  LOCK_MARIADB(Stmt->Connection);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
+  /* Only resetting the statement needs the connection - unescaping and parsing are done without holding the lock,
+     so other statements of the connection are not blocked by that */
+  LOCK_MARIADB(Stmt->Connection);
   MADB_StmtReset(Stmt);
+  UNLOCK_MARIADB(Stmt->Connection);
 
   /* After this point we can't have SQL_NTS*/
   ADJUST_LENGTH(StatementText, TextLength);
@@ -591,17 +774,25 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
     return MADB_SetError(&Stmt->Error, MADB_ERR_42000, NULL, 0);
   }
 
-  if (MADB_ResetParser(Stmt, StatementText, TextLength) != 0)
+  /* Applications tend to prepare the same text over and over again - unescaping and parsing it every time
+     is not necessary */
+  MADB_DeleteQuery(&Stmt->Query);
+  if (!MADB_ParseCacheGet(Stmt->Connection, StatementText, TextLength, &Stmt->Query))
   {
-    return Stmt->Error.ReturnValue;
-  }
+    if (MADB_ResetParser(Stmt, StatementText, TextLength) != 0)
+    {
+      return Stmt->Error.ReturnValue;
+    }
 
-  MADB_ParseQuery(&Stmt->Query);
+    MADB_ParseQuery(&Stmt->Query);
 
-  if ((Stmt->Query.QueryType == MADB_QUERY_INSERT || Stmt->Query.QueryType == MADB_QUERY_UPDATE || Stmt->Query.QueryType == MADB_QUERY_DELETE)
-    && MADB_FindToken(&Stmt->Query, "RETURNING"))
-  {
-    Stmt->Query.ReturnsResult= '\1';
+    if ((Stmt->Query.QueryType == MADB_QUERY_INSERT || Stmt->Query.QueryType == MADB_QUERY_UPDATE || Stmt->Query.QueryType == MADB_QUERY_DELETE)
+      && MADB_FindToken(&Stmt->Query, "RETURNING"))
+    {
+      Stmt->Query.ReturnsResult= '\1';
+    }
+
+    MADB_ParseCachePut(Stmt->Connection, StatementText, TextLength, &Stmt->Query);
   }
 
   if (QUERY_IS_MULTISTMT(Stmt->Query) && NO_CACHE(Stmt))
@@ -623,19 +814,20 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
     {
       return MADB_EDPrepare(Stmt);
     }
+
+    LOCK_MARIADB(Stmt->Connection);
     /* We had error preparing any of statements */
-    else if (GetMultiStatements(Stmt, ExecDirect))
+    if (GetMultiStatements(Stmt, ExecDirect))
     {
+      UNLOCK_MARIADB(Stmt->Connection);
       return Stmt->Error.ReturnValue;
     }
+    UNLOCK_MARIADB(Stmt->Connection);
 
     /* all statemtens successfully prepared */
-    UNLOCK_MARIADB(Stmt->Connection);
     return SQL_SUCCESS;
   }
 
-  UNLOCK_MARIADB(Stmt->Connection);
-
   if (!MADB_ValidateStmt(&Stmt->Query))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "SQL command SET NAMES is not allowed", 0);
@@ -683,7 +875,7 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
     if (MADB_SSPS_DISABLED(Stmt))
     {
         MADB_DeleteQuery(&Stmt->Query);
-        Stmt->Query.allocated = Stmt->Query.RefinedText = strndup(StmtStr.str, StmtStr.length);
+        Stmt->Query.allocated = Stmt->Query.RefinedText = MADB_STRNDUP(StmtStr.str, StmtStr.length);
         Stmt->Query.RefinedLength = StmtStr.length;
         MADB_ParseQuery(&Stmt->Query);
     } else
@@ -695,26 +887,12 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
     MADB_DynstrFree(&StmtStr);
   }
 
-  if (Stmt->Options.MaxRows && Stmt->Query.QueryType == MADB_QUERY_SELECT)
+  /* MaxRows is enforced on the client side(see MADB_LimitStoredResult). Appended LIMIT only spares the server from
+     producing rows that would be discarded, thus it is added only where it cannot change the query semantics */
+  if (Stmt->Options.MaxRows > 0 && MADB_SSPS_DISABLED(Stmt) && MADB_IsSimpleSelect(&Stmt->Query) &&
+      MADB_AppendLimit(&Stmt->Query, (SQLULEN)Stmt->Options.MaxRows))
   {
-    unsigned long tmpLen = strlen(Stmt->Query.RefinedText) + 60;
-    char *tmp = MADB_CALLOC(tmpLen);
-    unsigned int updateForOffset;
-
-    if (MADB_CompareToken(&Stmt->Query, Stmt->Query.Tokens.elements-1, "UPDATE", 6, NULL) &&
-        MADB_CompareToken(&Stmt->Query, Stmt->Query.Tokens.elements-2, "FOR", 3, &updateForOffset))
-    {
-      _snprintf(tmp, tmpLen, "SELECT * FROM (%.*s) LIMIT %zd FOR UPDATE", updateForOffset, Stmt->Query.RefinedText, Stmt->Options.MaxRows);
-    } else
-    {
-      _snprintf(tmp, tmpLen, "SELECT * FROM (%s) LIMIT %zd", Stmt->Query.RefinedText, Stmt->Options.MaxRows);
-    }
-    
-    MADB_DeleteQuery(&Stmt->Query);
-    Stmt->Query.RefinedText = tmp;
-    Stmt->Query.RefinedLength = strlen(Stmt->Query.RefinedText);
-    Stmt->Query.allocated = Stmt->Query.RefinedText;
-    MADB_ParseQuery(&Stmt->Query);
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
   }
 
   if (!Stmt->Query.ReturnsResult && !Stmt->Query.HasParameters &&
@@ -740,6 +918,10 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
       Stmt->State = MADB_SS_PREPARED;
       return SQL_SUCCESS;
   }
+  if (ExecDirect != FALSE && MADB_CanExecuteDirect(Stmt))
+  {
+    return MADB_DirectPrepare(Stmt);
+  }
   return MADB_RegularPrepare(Stmt);
 }
 /* }}} */
@@ -753,6 +935,8 @@ SQLRETURN MADB_StmtParamData(MADB_Stmt *Stmt, SQLPOINTER *ValuePtrPtr)
   int i;
   SQLRETURN ret;
 
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   if (Stmt->DataExecutionType == MADB_DAE_NORMAL)
   {
     if (!Stmt->Apd || !(ParamCount= Stmt->ParamCount))
@@ -839,6 +1023,7 @@ SQLRETURN MADB_StmtPutData(MADB_Stmt *Stmt, SQLPOINTER DataPtr, SQLLEN StrLen_or
   SQLULEN         Length= 0;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   if (DataPtr != NULL && StrLen_or_Ind < 0 && StrLen_or_Ind != SQL_NTS && StrLen_or_Ind != SQL_NULL_DATA)
   {
@@ -1176,10 +1361,21 @@ SQLRETURN MADB_DoExecute(MADB_Stmt *Stmt)
 {
   SQLRETURN ret= SQL_SUCCESS;
 
+  /* Statement was not prepared yet(see MADB_DirectPrepare and MADB_PrepareSubStatement) */
+  BOOL ExecDirect= Stmt->PendingPrepare != NULL;
+  int  rc;
+
   /**************************** mysql_stmt_bind_param **********************************/
   unsigned int arr_size = 0;
   mysql_stmt_attr_set(Stmt->stmt, STMT_ATTR_ARRAY_SIZE, (void*)&arr_size);
 
+  if (ExecDirect)
+  {
+    /* Server doesn't tell parameters number before execution, thus we have to tell libmariadb ours */
+    unsigned int ParamCount= (unsigned int)MADB_STMT_PARAM_COUNT(Stmt);
+    mysql_stmt_attr_set(Stmt->stmt, STMT_ATTR_PREBIND_PARAMS, (void*)&ParamCount);
+  }
+
   if (Stmt->ParamCount)
   {
     mysql_stmt_bind_param(Stmt->stmt, Stmt->params);
@@ -1188,9 +1384,22 @@ SQLRETURN MADB_DoExecute(MADB_Stmt *Stmt)
 
   /**************************** mysql_stmt_execute *************************************/
 
-  MDBUG_C_PRINT(Stmt->Connection, "mariadb_stmt_execute(%0x)(%s)", Stmt->stmt, STMT_STRING(Stmt));
+  if (ExecDirect)
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "mariadb_stmt_execute_direct(%0x)(%s)", Stmt->stmt, Stmt->PendingPrepare);
+    /* If that fails, the statement stays not prepared, and next paramset has to try it again */
+    if ((rc= mariadb_stmt_execute_direct(Stmt->stmt, Stmt->PendingPrepare, strlen(Stmt->PendingPrepare))) == 0)
+    {
+      Stmt->PendingPrepare= NULL;
+    }
+  }
+  else
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "mariadb_stmt_execute(%0x)(%s)", Stmt->stmt, STMT_STRING(Stmt));
+    rc= mysql_stmt_execute(Stmt->stmt);
+  }
 
-  if (mysql_stmt_execute(Stmt->stmt))
+  if (rc)
   {
     ret= MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
     MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_execute:ERROR%s", "");
@@ -1258,7 +1467,6 @@ SQLRETURN MADB_InsertParam(MADB_Stmt* Stmt, MADB_DescRecord* ApdRecord, MADB_Des
     SQLLEN *OctetLengthPtr = NULL;
     void* DataPtr;
     SQLLEN Length;
-    char *escapedParameter = NULL;
     my_bool EncloseInQuotes = TRUE;
 
     IndicatorPtr = GetBindOffset(Stmt->Apd, ApdRecord, ApdRecord->IndicatorPtr, ParamSetIdx, sizeof(SQLLEN));
@@ -1287,7 +1495,7 @@ SQLRETURN MADB_InsertParam(MADB_Stmt* Stmt, MADB_DescRecord* ApdRecord, MADB_Des
         if ((*IndicatorPtr == SQL_COLUMN_IGNORE && !ApdRecord->DefaultValue) || *IndicatorPtr == SQL_NULL_DATA)
         {
             // No need to escape NULL, so exit after it is appended.
-            if (MADB_DynstrAppend(final_query, "NULL"))
+            if (MADB_DYNAPPENDCONST(final_query, "NULL"))
             {
                 ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001,"Failed to append the parameter", 0);
             }
@@ -1529,33 +1737,27 @@ SQLRETURN MADB_InsertParam(MADB_Stmt* Stmt, MADB_DescRecord* ApdRecord, MADB_Des
     }
 
 escape:
-    // Make the escape buffer big enough to fit the escape characters added by mysql_real_escape_string.
-    escapedParameter = MADB_CALLOC((data.length << 1) + 1);
-    if (!escapedParameter)
+    // Escaping straight into the query, making sure it has the room for the quotes and the escape characters added by
+    // mysql_real_escape_string. That saves a temporary buffer per parameter.
+    if (MADB_DynstrRealloc(final_query, (data.length << 1) + 3))
     {
-        ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to allocate memory for the escaped parameter", 0);
+        ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to append the escaped parameter", 0);
         goto end;
     }
-    mysql_real_escape_string(Stmt->Connection->mariadb, escapedParameter, data.str, data.length);
 
     if (EncloseInQuotes)
     {
-        if (MADB_DynstrAppend(final_query, "'") ||
-            MADB_DynstrAppend(final_query, escapedParameter) ||
-            MADB_DynstrAppend(final_query, "'"))
-        {
-            ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to append the escaped parameter", 0);
-        }
-    } else
+        final_query->str[final_query->length++] = '\'';
+    }
+    final_query->length += mysql_real_escape_string(Stmt->Connection->mariadb, final_query->str + final_query->length,
+                                                    data.str, data.length);
+    if (EncloseInQuotes)
     {
-        if (MADB_DynstrAppend(final_query, escapedParameter))
-        {
-            ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to append the escaped parameter", 0);
-        }
+        final_query->str[final_query->length++] = '\'';
     }
+    final_query->str[final_query->length] = '\0';
 
 end:
-    MADB_FREE(escapedParameter);
     MADB_DynstrFree(&data);
     return ret;
 }
@@ -1580,6 +1782,13 @@ SQLRETURN MADB_InsertParams(MADB_Stmt *Stmt, unsigned long QueryOffset, SQLULEN
     char *queryStart = Stmt->Query.RefinedText + QueryOffset, *query = queryStart;
     unsigned long queryLen = strlen(query);
 
+    // The query text plus quotes for each parameter is the lower estimate of the final query length.
+    if (MADB_DynstrRealloc(final_query, queryLen + 2 * MADB_STMT_PARAM_COUNT(Stmt) + 1))
+    {
+        ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+        goto error;
+    }
+
     for (i = ParamOffset; i < ParamOffset + MADB_STMT_PARAM_COUNT(Stmt); ++i)
     {
         MADB_DescRecord *ApdRecord, *IpdRecord;
@@ -1825,8 +2034,57 @@ static void CspsReceiveStatementResults(MADB_Stmt* const Stmt, const SQLRETURN r
     }
 }
 
-/* {{{ MADB_StmtExecute */
-SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
+/* {{{ MADB_PrepareSubStatement - prepares a statement of the multi-statement batch. Unless some parameter needs data
+       at execution, the preparation is postponed, and will be sent together with the execution(see MADB_DoExecute).
+       With MariaDB servers a batch of N statements then costs N round trips, and not 2*N. Servers, that present
+       themselves as MySQL(SingleStore among them), or compressed connections, don't support it - Connector/C
+       emulates the direct execution with the prepare and the execute, and there it still costs 2*N */
+static int MADB_PrepareSubStatement(MADB_Stmt *Stmt, char *SubQuery)
+{
+  if (!MADB_HasDaeParams(Stmt))
+  {
+    Stmt->PendingPrepare= SubQuery;
+    return 0;
+  }
+  Stmt->PendingPrepare= NULL;
+  return mysql_stmt_prepare(Stmt->stmt, SubQuery, (unsigned long)strlen(SubQuery));
+}
+/* }}} */
+
+/* {{{ MADB_SubStatementParamCount - number of parameter markers the parser has found in the statement of the batch */
+static unsigned int MADB_SubStatementParamCount(MADB_QUERY *Query, const char *SubQuery)
+{
+  long         Start= (long)(SubQuery - Query->RefinedText), End= Start + (long)strlen(SubQuery), Position;
+  unsigned int i, Count= 0;
+
+  for (i= 0; i < Query->ParamPositions.elements; ++i)
+  {
+    MADB_GetDynamic(&Query->ParamPositions, (char *)&Position, i);
+    if (Position >= Start && Position < End)
+    {
+      ++Count;
+    }
+  }
+  return Count;
+}
+/* }}} */
+
+/* {{{ MADB_StmtLockOnce - takes the connection lock, unless it has been already taken by the execution. Parameters
+       are converted before the lock is taken, so that other statements of the connection are not blocked by that.
+       Once taken, the lock is kept till the end of the execution, since the results of the previous paramset or
+       sub-statement may be still pending on the connection */
+static void MADB_StmtLockOnce(MADB_Stmt *Stmt, BOOL *Locked)
+{
+  if (!*Locked)
+  {
+    LOCK_MARIADB(Stmt->Connection);
+    *Locked= TRUE;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_StmtExecuteNoTimeout */
+static SQLRETURN MADB_StmtExecuteNoTimeout(MADB_Stmt *Stmt, BOOL ExecDirect)
 {
   unsigned int          i;
   MYSQL_RES   *DefaultResult= NULL;
@@ -1834,7 +2092,9 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
   unsigned int ErrorCount=    0;
   unsigned int StatementNr;
   unsigned int ParamOffset=   0; /* for multi statements */
+  unsigned int SubStmtParamCount;
   SQLULEN      j;
+  BOOL         Locked=        FALSE, SetIrdMetadata= FALSE;
   /* For multistatement direct execution */
   char        *CurQuery= Stmt->Query.RefinedText, *QueriesEnd= Stmt->Query.RefinedText + Stmt->Query.RefinedLength;
 
@@ -1842,6 +2102,19 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
   MADB_CLEAR_ERROR(&Stmt->Error);
 
+  if (!SQL_SUCCEEDED(MADB_DbcApplySessionState(Stmt->Connection)))
+  {
+    MADB_CopyError(&Stmt->Error, &Stmt->Connection->Error);
+    return Stmt->Error.ReturnValue;
+  }
+
+  /* Current database is unknown after the query, that could change it, unless the server reports the change. See
+     MADB_StmtCheckSchemaTracked */
+  if (Stmt->Query.ChangesSchema)
+  {
+    Stmt->Connection->CurrentDbUnknown= TRUE;
+  }
+
   if (Stmt->State == MADB_SS_EMULATED)
   {
     return MADB_ExecuteQuery(Stmt, STMT_STRING(Stmt), (SQLINTEGER)strlen(STMT_STRING(Stmt)));
@@ -1863,7 +2136,6 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
   if (MADB_SSPS_DISABLED(Stmt))
   {
-      LOCK_MARIADB(Stmt->Connection);
       Stmt->AffectedRows = 0;
 
       if (Stmt->Ipd->Header.RowsProcessedPtr)
@@ -1875,19 +2147,29 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
       for (StatementNr= 0; StatementNr < STMT_COUNT(Stmt->Query); ++StatementNr)
       {
-          if (QUERY_IS_MULTISTMT(Stmt->Query)
-              && CspsInitStatementFromMultistatement(Stmt, StatementNr, CurQuery, QueriesEnd, &ParamPosId))
+          if (QUERY_IS_MULTISTMT(Stmt->Query))
           {
-              continue; /* bad statement - skip it */
+              // Handles of sub-statements are created on the connection.
+              MADB_StmtLockOnce(Stmt, &Locked);
+              if (CspsInitStatementFromMultistatement(Stmt, StatementNr, CurQuery, QueriesEnd, &ParamPosId))
+              {
+                  continue; /* bad statement - skip it */
+              }
           }
 
           // In APD, Header.ArraySize specifies the number of values in each parameter.
           // Obviously, it is expected to equal 1, but if not, bound params are expected to be the arrays of values.
           // Therefore, for each item in the array we construct a separate SQL query and send it to the engine.
+          // The buffer of the query is reused for all of them.
+          MADB_DynString final_query;
+          if (MADB_InitDynamicString(&final_query, "", 1024, 1024))
+          {
+              ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+              goto end;
+          }
           for (j = 0; j < Stmt->Apd->Header.ArraySize; ++j)
           {
-              MADB_DynString final_query;
-              MADB_InitDynamicString(&final_query, "", 1024, 1024);
+              MADB_DynstrSet(&final_query, "");
 
               const CspsControlFlowResult InitParamsRes
                       = CspsInitStatementParams(Stmt, &final_query, &ErrorCount, &ret, CurQuery, ParamOffset, j);
@@ -1895,7 +2177,6 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
               case CCFR_OK:
                   break;
               case CCFR_CONTINUE:
-                  MADB_DynstrFree(&final_query);
                   continue;
               case CCFR_ERROR:
                   MADB_DynstrFree(&final_query);
@@ -1905,6 +2186,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
                   break;
               }
 
+              MADB_StmtLockOnce(Stmt, &Locked);
               ret = CspsRunStatementQuery(Stmt, &final_query, &ErrorCount, ParamOffset);
 
               if (Stmt->Ipd->Header.ArrayStatusPtr)
@@ -1922,10 +2204,10 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
                                               SQL_PARAM_DIAG_UNAVAILABLE;
                   }
               }
-
-              MADB_DynstrFree(&final_query);
           }
+          MADB_DynstrFree(&final_query);
 
+          MADB_StmtLockOnce(Stmt, &Locked);
           CspsReceiveStatementResults(Stmt, ret);
 
           // Move forward to the next subquery in the multistatement.
@@ -1952,8 +2234,8 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
           // so we must be sure that the field_count value is up to date.
           MADB_StmtResetResultStructures(Stmt);
 
-          // Set the field metadata.
-          MADB_DescSetIrdMetadata(Stmt, mysql_fetch_fields(FetchMetadata(Stmt)), mysql_stmt_field_count(Stmt->stmt));
+          // The field metadata is set after releasing the lock.
+          SetIrdMetadata= TRUE;
 
           Stmt->AffectedRows= -1;
       }
@@ -1970,7 +2252,6 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
     MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
   }
 
-  LOCK_MARIADB(Stmt->Connection);
   Stmt->AffectedRows= 0;
 
   if (Stmt->Ipd->Header.RowsProcessedPtr)
@@ -1982,6 +2263,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
   {
     if (QUERY_IS_MULTISTMT(Stmt->Query))
     {
+      MADB_StmtLockOnce(Stmt, &Locked);
       if (Stmt->MultiStmts && Stmt->MultiStmts[StatementNr] != NULL)
       {
         Stmt->stmt= Stmt->MultiStmts[StatementNr];
@@ -1995,11 +2277,16 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
         if (StatementNr != 0)
         {
-          if (mysql_stmt_prepare(Stmt->stmt, CurQuery, (unsigned long)strlen(CurQuery)))
+          if (MADB_PrepareSubStatement(Stmt, CurQuery))
           {
+            UNLOCK_MARIADB(Stmt->Connection);
             return MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
           }
         }
+        else
+        {
+          Stmt->PendingPrepare= NULL;
+        }
 
         CurQuery+= strlen(CurQuery) + 1;
       }
@@ -2024,8 +2311,9 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
         Stmt->MultiStmts[StatementNr]= Stmt->stmt;
 
-        if (mysql_stmt_prepare(Stmt->stmt, CurQuery, (unsigned long)strlen(CurQuery)))
+        if (MADB_PrepareSubStatement(Stmt, CurQuery))
         {
+          UNLOCK_MARIADB(Stmt->Connection);
           return MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
         }
         CurQuery+= strlen(CurQuery) + 1;
@@ -2033,9 +2321,12 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
       
       Stmt->RebindParams= TRUE;
 
-      if (Stmt->ParamCount != mysql_stmt_param_count(Stmt->stmt))
+      /* Server has not told the number of parameters yet, if the statement is not prepared */
+      SubStmtParamCount= Stmt->PendingPrepare != NULL ? MADB_SubStatementParamCount(&Stmt->Query, Stmt->PendingPrepare) :
+                                                        (unsigned int)mysql_stmt_param_count(Stmt->stmt);
+      if (Stmt->ParamCount != SubStmtParamCount)
       {
-        Stmt->ParamCount= (SQLSMALLINT)mysql_stmt_param_count(Stmt->stmt);
+        Stmt->ParamCount= (SQLSMALLINT)SubStmtParamCount;
         Stmt->params= (MYSQL_BIND*)MADB_REALLOC(Stmt->params, sizeof(MYSQL_BIND) * MADB_STMT_PARAM_COUNT(Stmt));
       }
 
@@ -2098,6 +2389,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
         Stmt->RebindParams= FALSE;
       }
 
+      MADB_StmtLockOnce(Stmt, &Locked);
       ret= MADB_DoExecute(Stmt);
 
       if (!SQL_SUCCEEDED(ret))
@@ -2129,13 +2421,14 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
       /* MADB_CleanBulkOperData(Stmt, ParamOffset); */
       ParamOffset+= MADB_STMT_PARAM_COUNT(Stmt);
 
-      if (!NO_CACHE(Stmt) && mysql_stmt_field_count(Stmt->stmt))
+      if (!NO_CACHE(Stmt) && mysql_stmt_field_count(Stmt->stmt) && mysql_stmt_store_result(Stmt->stmt) == 0)
       {
-        mysql_stmt_store_result(Stmt->stmt);
+        MADB_LimitStoredResult(Stmt, Stmt->stmt);
       }
     }
   }       /* End of for() on statements(Multistatmt) */
 
+  MADB_StmtLockOnce(Stmt, &Locked);
   if (Stmt->MultiStmts)
   {
     Stmt->MultiStmtNr= 0;
@@ -2157,17 +2450,27 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
 
       return MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
     }
-    
+    MADB_LimitStoredResult(Stmt, Stmt->stmt);
+
     /* I don't think we can reliably establish the fact that we do not need to re-fetch the metadata, thus we are re-fetching always
        The fact that we have resultset has been established above in "if" condition(fields count is > 0) */
-    MADB_DescSetIrdMetadata(Stmt, mysql_fetch_fields(FetchMetadata(Stmt)), mysql_stmt_field_count(Stmt->stmt));
+    SetIrdMetadata= TRUE;
 
     Stmt->AffectedRows= -1;
   }
 end:
-  UNLOCK_MARIADB(Stmt->Connection);
+  if (Locked)
+  {
+    UNLOCK_MARIADB(Stmt->Connection);
+  }
   Stmt->LastRowFetched= 0;
 
+  /* Metadata belongs to the statement handle, and building IRD records does not need the connection */
+  if (SetIrdMetadata)
+  {
+    MADB_DescSetIrdMetadata(Stmt, mysql_fetch_fields(FetchMetadata(Stmt)), mysql_stmt_field_count(Stmt->stmt));
+  }
+
   if (DefaultResult)
     mysql_free_result(DefaultResult);
 
@@ -2183,6 +2486,63 @@ end:
 }
 /* }}} */
 
+/* {{{ MADB_StmtCheckSchemaTracked - USE makes the current database known, if the server has reported the new one in the
+       session state of the OK packet, and Connector/C has updated mysql->db from it. Servers, that don't track the
+       session state, or have session_track_schema off, don't report it. After dropped database, or multi-statement,
+       it stays unknown */
+static void MADB_StmtCheckSchemaTracked(MADB_Stmt *Stmt, SQLRETURN ret)
+{
+  MADB_Dbc   *Dbc= Stmt->Connection;
+  const char *Schema;
+  size_t      Length;
+
+  if (!SQL_SUCCEEDED(ret) || Stmt->Query.QueryType != MADB_QUERY_USE || QUERY_IS_MULTISTMT(Stmt->Query))
+  {
+    return;
+  }
+  LOCK_MARIADB(Dbc);
+  if (Dbc->mariadb != NULL && (Dbc->mariadb->server_capabilities & CLIENT_SESSION_TRACKING) &&
+      mysql_session_track_get_first(Dbc->mariadb, SESSION_TRACK_SCHEMA, &Schema, &Length) == 0)
+  {
+    Dbc->CurrentDbUnknown= FALSE;
+  }
+  UNLOCK_MARIADB(Dbc);
+}
+/* }}} */
+
+/* {{{ MADB_StmtExecute - executes the statement within SQL_ATTR_QUERY_TIMEOUT, if it is set. On expiry the query is
+       killed on the server, and HYT00 is returned, even if the server managed to finish the query meanwhile */
+SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
+{
+  MADB_QueryTimer Timer;
+  SQLRETURN       ret;
+
+  /* Buffers of the previous execution are not needed anymore */
+  MADB_StmtArenaReset(Stmt);
+
+  if (Stmt->Options.Timeout == 0)
+  {
+    ret= MADB_StmtExecuteNoTimeout(Stmt, ExecDirect);
+  }
+  else
+  {
+    MADB_QueryTimerStart(&Timer, Stmt->Connection, Stmt->Options.Timeout);
+    ret= MADB_StmtExecuteNoTimeout(Stmt, ExecDirect);
+    if (MADB_QueryTimerStop(&Timer))
+    {
+      if (SQL_SUCCEEDED(ret))
+      {
+        Stmt->Methods->StmtFree(Stmt, SQL_CLOSE);
+      }
+      ret= MADB_SetError(&Stmt->Error, MADB_ERR_HYT00, NULL, 0);
+    }
+  }
+  MADB_StmtCheckSchemaTracked(Stmt, ret);
+
+  return ret;
+}
+/* }}} */
+
 /* {{{ MADB_StmtBindCol */
 SQLRETURN MADB_StmtBindCol(MADB_Stmt *Stmt, SQLUSMALLINT ColumnNumber, SQLSMALLINT TargetType,
     SQLPOINTER TargetValuePtr, SQLLEN BufferLength, SQLLEN *StrLen_or_Ind)
@@ -2405,7 +2765,6 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
 
     DataPtr= (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->DataPtr, RowNumber, ArdRec->OctetLength);
 
-    MADB_FREE(ArdRec->InternalBuffer);
     if (!DataPtr)
     {
       Stmt->result[i].flags|= MADB_BIND_DUMMY;
@@ -2432,8 +2791,7 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
       /* In worst case for 2 bytes of UTF16 in result, we need 3 bytes of utf8.
           For ASCII  we need 2 times less(for 2 bytes of UTF16 - 1 byte UTF8,
           in other cases we need same 2 of 4 bytes. */
-      ArdRec->InternalBuffer=        (char *)MADB_CALLOC((size_t)((ArdRec->OctetLength)*1.5));
-      Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+      Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, (size_t)((ArdRec->OctetLength)*1.5));
       Stmt->result[i].buffer_length= (unsigned long)(ArdRec->OctetLength*1.5);
       Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
       break;
@@ -2443,11 +2801,8 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
       Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
       break;
     case SQL_C_NUMERIC:
-      MADB_FREE(ArdRec->InternalBuffer);
       Stmt->result[i].buffer_length= MADB_DEFAULT_PRECISION + 1/*-*/ + 1/*.*/;
-      ArdRec->InternalBuffer=       (char *)MADB_CALLOC(Stmt->result[i].buffer_length);
-      Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-      
+      Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, Stmt->result[i].buffer_length);
       Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
       break;
     case SQL_TYPE_TIMESTAMP:
@@ -2456,22 +2811,15 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
     case SQL_C_TIMESTAMP:
     case SQL_C_TIME:
     case SQL_C_DATE:
-      MADB_FREE(ArdRec->InternalBuffer);
       if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
       {
-        ArdRec->InternalBuffer= (char *)MADB_CALLOC(Stmt->stmt->fields[i].max_length + 1);
-        if (ArdRec->InternalBuffer == NULL)
-        {
-          return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
-        }
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+        Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, Stmt->stmt->fields[i].max_length + 1);
         Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
         Stmt->result[i].buffer_length= Stmt->stmt->fields[i].max_length + 1;
       }
       else
       {
-        ArdRec->InternalBuffer=       (char *)MADB_CALLOC(sizeof(MYSQL_TIME));
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+        Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, sizeof(MYSQL_TIME));
         Stmt->result[i].buffer_length= sizeof(MYSQL_TIME);
         Stmt->result[i].buffer_type=   MYSQL_TYPE_TIMESTAMP;
       }
@@ -2480,31 +2828,22 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
     case SQL_C_INTERVAL_HOUR_TO_SECOND:
       {
         MYSQL_FIELD *Field= mysql_fetch_field_direct(Stmt->metadata, i);
-        MADB_FREE(ArdRec->InternalBuffer);
         if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
         {
-          ArdRec->InternalBuffer= (char *)MADB_CALLOC(Stmt->stmt->fields[i].max_length + 1);
-          if (ArdRec->InternalBuffer == NULL)
-          {
-            return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
-          }
-          Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+          Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, Stmt->stmt->fields[i].max_length + 1);
           Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
           Stmt->result[i].buffer_length= Stmt->stmt->fields[i].max_length + 1;
         }
         else
         {
-          ArdRec->InternalBuffer=       (char *)MADB_CALLOC(sizeof(MYSQL_TIME));
-          Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+          Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, sizeof(MYSQL_TIME));
           Stmt->result[i].buffer_length= sizeof(MYSQL_TIME);
           Stmt->result[i].buffer_type=   Field && Field->type == MYSQL_TYPE_TIME ? MYSQL_TYPE_TIME : MYSQL_TYPE_TIMESTAMP;
         }
       }
       break;
     case SQL_C_BIT:
-      MADB_FREE(ArdRec->InternalBuffer);
-      ArdRec->InternalBuffer=        (char *)MADB_CALLOC(8);
-      Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+      Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, 8);
       Stmt->result[i].buffer_length= 8;
       Stmt->result[i].buffer_type=   MYSQL_TYPE_LONGLONG;
       break;
@@ -2523,9 +2862,7 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
       {
         /* To keep things simple - we will use internal buffer of the column size, and later(in the MADB_FixFetchedValues) will copy (correct part of)
            it to the application's buffer taking care of endianness. Perhaps it'd be better just not to support this type of conversion */
-        MADB_FREE(ArdRec->InternalBuffer);
-        ArdRec->InternalBuffer=        (char *)MADB_CALLOC(MIN(IrdRec->OctetLength, ArdRec->OctetLength));
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
+        Stmt->result[i].buffer=        MADB_StmtFetchBuffer(Stmt, i, (size_t)MIN(IrdRec->OctetLength, ArdRec->OctetLength));
         Stmt->result[i].buffer_length= (unsigned long)MIN(IrdRec->OctetLength, ArdRec->OctetLength);
         Stmt->result[i].buffer_type=   MYSQL_TYPE_BLOB;
         break;
@@ -2543,6 +2880,11 @@ SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
                                                             &Stmt->result[i].buffer_length);
       break;
     }
+
+    if (Stmt->result[i].buffer == NULL)
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    }
   }
 
   return SQL_SUCCESS;
@@ -2644,7 +2986,7 @@ SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET
             {
               BOOL isTime;
 
-              FieldRc= MADB_Str2Ts(ArdRec->InternalBuffer, *Stmt->stmt->bind[i].length, &tm, FALSE, &Stmt->Error, &isTime);
+              FieldRc= MADB_Str2Ts((char *)Stmt->result[i].buffer, *Stmt->stmt->bind[i].length, &tm, FALSE, &Stmt->Error, &isTime);
               if (SQL_SUCCEEDED(FieldRc))
               {
                 Intermidiate= &tm;
@@ -2657,7 +2999,7 @@ SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET
             }
             else
             {
-              Intermidiate= (MYSQL_TIME *)ArdRec->InternalBuffer;
+              Intermidiate= (MYSQL_TIME *)Stmt->result[i].buffer;
             }
 
             FieldRc= MADB_CopyMadbTimestamp(Stmt, Intermidiate, DataPtr, LengthPtr, IndicatorPtr, ArdRec->Type, IrdRec->ConciseType);
@@ -2667,14 +3009,14 @@ SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET
         case SQL_C_INTERVAL_HOUR_TO_MINUTE:
         case SQL_C_INTERVAL_HOUR_TO_SECOND:
         {
-          MYSQL_TIME          *tm= (MYSQL_TIME*)ArdRec->InternalBuffer, ForConversion;
+          MYSQL_TIME          *tm= (MYSQL_TIME*)Stmt->result[i].buffer, ForConversion;
           SQL_INTERVAL_STRUCT *ts= (SQL_INTERVAL_STRUCT *)DataPtr;
 
           if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
           {
             BOOL isTime;
 
-            FieldRc= MADB_Str2Ts(ArdRec->InternalBuffer, *Stmt->stmt->bind[i].length, &ForConversion, FALSE, &Stmt->Error, &isTime);
+            FieldRc= MADB_Str2Ts((char *)Stmt->result[i].buffer, *Stmt->stmt->bind[i].length, &ForConversion, FALSE, &Stmt->Error, &isTime);
             if (SQL_SUCCEEDED(FieldRc))
             {
               tm= &ForConversion;
@@ -2728,11 +3070,11 @@ SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET
           if (DataPtr != NULL && Stmt->result[i].buffer_length < Stmt->stmt->fields[i].max_length)
           {
             MADB_SetError(&Stmt->Error, MADB_ERR_22003, NULL, 0);
-            ArdRec->InternalBuffer[Stmt->result[i].buffer_length - 1]= 0;
+            ((char *)Stmt->result[i].buffer)[Stmt->result[i].buffer_length - 1]= 0;
             return Stmt->Error.ReturnValue;
           }
 
-          if ((rc= MADB_CharToSQLNumeric(ArdRec->InternalBuffer, Stmt->Ard, ArdRec, NULL, RowNumber)))
+          if ((rc= MADB_CharToSQLNumeric((char *)Stmt->result[i].buffer, Stmt->Ard, ArdRec, NULL, RowNumber)))
           {
             MADB_SetError(&Stmt->Error, rc, NULL, 0);
           }
@@ -3064,7 +3406,7 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
                               // If we don't cache the result, we don't know
                               // the number of rows in resultset
                               //
-                              Stmt->Cursor.RowsetSize:
+                              MADB_StreamedRowsToFetch(Stmt):
                               MADB_RowsToFetch(&Stmt->Cursor, mysql_stmt_num_rows(Stmt->stmt));
   if (Rows2Fetch == 0)
   {
@@ -3209,6 +3551,7 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
     }  /* End of switch on fetch result */
 
     ++Stmt->LastRowFetched;
+    ++Stmt->Cursor.Streamed;
     ++Stmt->PositionedCursor;
 
     /*Conversion etc. At this point, after fetch we can have RowResult either SQL_SUCCESS or SQL_SUCCESS_WITH_INFO */
@@ -3290,7 +3633,7 @@ SQLRETURN MADB_StmtGetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     *(SQLULEN *)ValuePtr= Stmt->Apd->Header.ArraySize;
     break;
   case SQL_ATTR_ASYNC_ENABLE:
-    *(SQLPOINTER *)ValuePtr= SQL_ASYNC_ENABLE_OFF;
+    *(SQLULEN *)ValuePtr= Stmt->Options.AsyncEnable;
     break;
   case SQL_ATTR_ROW_ARRAY_SIZE:
   case SQL_ROWSET_SIZE:
@@ -3344,7 +3687,7 @@ SQLRETURN MADB_StmtGetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     *(SQLULEN *)ValuePtr= SQL_NOSCAN_ON;
     break;
   case SQL_ATTR_QUERY_TIMEOUT:
-    *(SQLULEN *)ValuePtr= 0;
+    *(SQLULEN *)ValuePtr= Stmt->Options.Timeout;
     break;
   case SQL_ATTR_RETRIEVE_DATA:
     *(SQLULEN *)ValuePtr= SQL_RD_ON;
@@ -3464,11 +3807,23 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     Stmt->Ird->Header.RowsProcessedPtr= (SQLULEN*)ValuePtr;
     break;
   case SQL_ATTR_ASYNC_ENABLE:
+#ifndef MADB_ASYNC_DISABLED
+    if ((SQLULEN)ValuePtr != SQL_ASYNC_ENABLE_OFF && (SQLULEN)ValuePtr != SQL_ASYNC_ENABLE_ON)
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY024, NULL, 0);
+    }
+    if (MADB_ASYNC_IN_PROGRESS(Stmt))
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
+    }
+    Stmt->Options.AsyncEnable= (SQLULEN)ValuePtr;
+#else
     if ((SQLULEN)ValuePtr != SQL_ASYNC_ENABLE_OFF)
     {
       MADB_SetError(&Stmt->Error, MADB_ERR_01S02, "Option value changed to default (SQL_ATTR_ASYNC_ENABLE)", 0);
       ret= SQL_SUCCESS_WITH_INFO;
     }
+#endif
     break;
   case SQL_ATTR_SIMULATE_CURSOR:
     Stmt->Options.SimulateCursor= (SQLULEN) ValuePtr;
@@ -3545,11 +3900,7 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     }
     break;
   case SQL_ATTR_QUERY_TIMEOUT:
-    if ((SQLULEN)ValuePtr != 0)
-    {
-       MADB_SetError(&Stmt->Error, MADB_ERR_01S02, "Option value changed to default (no timeout)", 0);
-       ret= SQL_SUCCESS_WITH_INFO;
-    }
+    Stmt->Options.Timeout= (SQLULEN)ValuePtr;
     break;
   case SQL_ATTR_RETRIEVE_DATA:
     if ((SQLULEN)ValuePtr != SQL_RD_ON)
@@ -4386,6 +4737,7 @@ SQLRETURN MADB_StmtColumnPrivileges(MADB_Stmt *Stmt, char *CatalogName, SQLSMALL
   SQLRETURN ret;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   /* TableName is mandatory */
   if (!TableName || !NameLength3)
@@ -4418,6 +4770,7 @@ SQLRETURN MADB_StmtTablePrivileges(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLI
        *p;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   p= StmtStr;
   p += _snprintf(StmtStr, 1024, "SELECT TABLE_SCHEMA AS TABLE_CAT, NULL AS TABLE_SCHEM, TABLE_NAME, "
@@ -4464,6 +4817,8 @@ SQLRETURN MADB_StmtTables(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Catalo
   --------------------------------------------------------------------------------
   */
 
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   MDBUG_C_ENTER(Stmt->Connection, "MADB_StmtTables");
 
   ADJUST_LENGTH(CatalogName, CatalogNameLength);
@@ -4542,8 +4897,8 @@ SQLRETURN MADB_StmtTables(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Catalo
 
     if (CatalogName)
     {
-      MADB_DynstrAppend(&StmtStr, " AND TABLE_SCHEMA ");
-      MADB_DynstrAppend(&StmtStr, "LIKE ");
+      MADB_DYNAPPENDCONST(&StmtStr, " AND TABLE_SCHEMA ");
+      MADB_DYNAPPENDCONST(&StmtStr, "LIKE ");
       MADB_DynstrAppend(&StmtStr, Quote);
       MADB_DynstrAppendMem(&StmtStr, CatalogName, CatalogNameLength);
       MADB_DynstrAppend(&StmtStr, Quote);
@@ -4551,7 +4906,7 @@ SQLRETURN MADB_StmtTables(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Catalo
 
     if (TableName && TableNameLength)
     {
-      MADB_DynstrAppend(&StmtStr, " AND TABLE_NAME LIKE ");
+      MADB_DYNAPPENDCONST(&StmtStr, " AND TABLE_NAME LIKE ");
       MADB_DynstrAppend(&StmtStr, Quote);
       MADB_DynstrAppendMem(&StmtStr, TableName, TableNameLength);
       MADB_DynstrAppend(&StmtStr, Quote);
@@ -4560,24 +4915,24 @@ SQLRETURN MADB_StmtTables(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Catalo
     {
       unsigned int i;
       char *myTypes[3]= {"TABLE", "VIEW", "SYNONYM"};
-      MADB_DynstrAppend(&StmtStr, " AND TABLE_TYPE IN (''");
+      MADB_DYNAPPENDCONST(&StmtStr, " AND TABLE_TYPE IN (''");
       for (i= 0; i < 3; i++)
       {
         if (strstr(TableType, myTypes[i]))
         {
           if (strstr(myTypes[i], "TABLE"))
-            MADB_DynstrAppend(&StmtStr, ", 'BASE TABLE'");
+            MADB_DYNAPPENDCONST(&StmtStr, ", 'BASE TABLE'");
           else
           {
-            MADB_DynstrAppend(&StmtStr, ", '");
+            MADB_DYNAPPENDCONST(&StmtStr, ", '");
             MADB_DynstrAppend(&StmtStr, myTypes[i]);
-            MADB_DynstrAppend(&StmtStr, "'");
+            MADB_DYNAPPENDCONST(&StmtStr, "'");
           }
         }
       }
-      MADB_DynstrAppend(&StmtStr, ") ");
+      MADB_DYNAPPENDCONST(&StmtStr, ") ");
     }
-    MADB_DynstrAppend(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, TABLE_TYPE");
+    MADB_DYNAPPENDCONST(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, TABLE_TYPE");
   }
   MDBUG_C_PRINT(Stmt->Connection, "SQL Statement: %s", StmtStr.str);
 
@@ -4611,6 +4966,7 @@ SQLRETURN MADB_StmtStatistics(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Na
   SQLRETURN ret;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   /* TableName is mandatory */
   if (!TableName || !NameLength3)
@@ -4719,7 +5075,7 @@ static const MADB_ShortTypeInfo SqlColumnsColType[SQL_COLUMNS_FIELD_COUNT] = {
 short allocAndFormatInt(char **buf, int value)
 {
     // maximum 11 chars for a 32-bit signed integer
-    if (!(*buf = malloc(12)))
+    if (!(*buf = MADB_ALLOC(12)))
       return 1;
     sprintf(*buf, "%d", value);
     return 0;
@@ -4732,12 +5088,12 @@ void freeData(char ***data, int nRows, int nCols, const short *needFree)
   {
     for (j = 0; j < nCols; j++)
     {
-      if (data[i][j] && needFree[j]) free(data[i][j]);
+      if (data[i][j] && needFree[j]) MADB_Free(data[i][j]);
     }
     if (data[i])
-      free(data[i]);
+      MADB_Free(data[i]);
   }
-  free(data);
+  MADB_Free(data);
 }
 
 /* {{{ MADB_StmtColumnsNoInfoSchema */
@@ -4755,6 +5111,8 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
   FieldDescrList *tableFields;
   FieldDescr *S2FieldDescr;
 
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   if (CatalogName && NameLength1 <= 0)
     NameLength1 = strlen(CatalogName);
   if (SchemaName && NameLength2 <= 0)
@@ -4775,7 +5133,7 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
     return Stmt->Error.ReturnValue;
 
   int n_rows = 0, allocated_rows = 256;
-  char ***formatted_table_ptr = (char***)calloc(allocated_rows, sizeof(char**)), ***temp_ptr = NULL;
+  char ***formatted_table_ptr = (char***)MADB_CALLOC(allocated_rows * sizeof(char**)), ***temp_ptr = NULL;
   char **current_row_ptr;
   MYSQL_FIELD *field;
   SQLLEN column_char_length, column_length;
@@ -4795,14 +5153,14 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
     if (!(columns_res = S2_ListFields(
       Stmt, CatalogName, NameLength1, table_row[0], table_lengths[0])))
     {
-      free(formatted_table_ptr);
+      MADB_FREE(formatted_table_ptr);
       mysql_free_result(tables_res);
       return Stmt->Error.ReturnValue;
     }
     if (!(show_columns_res = S2_ShowColumnsInTable(
         Stmt, CatalogName, NameLength1, table_row[0], table_lengths[0], ColumnName, NameLength4)))
     {
-      free(formatted_table_ptr);
+      MADB_FREE(formatted_table_ptr);
       mysql_free_result(tables_res);
       mysql_free_result(columns_res);
       return Stmt->Error.ReturnValue;
@@ -4815,7 +5173,7 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
     {
       if (n_rows >= allocated_rows)
       {
-        temp_ptr = realloc(formatted_table_ptr, (allocated_rows = 2 * allocated_rows) * sizeof(char**));
+        temp_ptr = MADB_REALLOC(formatted_table_ptr, (allocated_rows = 2 * allocated_rows) * sizeof(char**));
         if (!temp_ptr)
         {
           MADB_SetError(&Stmt->Error, MADB_ERR_HY001, "Failed to allocate memory for columns data", 0);
@@ -4823,7 +5181,7 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
         }
         formatted_table_ptr = temp_ptr;
       }
-      current_row_ptr = formatted_table_ptr[n_rows] = (char**)calloc(SQL_COLUMNS_FIELD_COUNT, sizeof(char*));
+      current_row_ptr = formatted_table_ptr[n_rows] = (char**)MADB_CALLOC(SQL_COLUMNS_FIELD_COUNT * sizeof(char*));
 
       concise_data_type = MapMariadDbToOdbcType(field);
       if (field->charsetnr != BINARY_CHARSETNR && !Stmt->Connection->IsAnsi)
@@ -4860,13 +5218,13 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
         continue;
       }
       // TABLE_CAT
-      is_alloc_fail |= !(uintptr_t)(current_row_ptr[0] = strdup(NameLength1 > 0 ? CatalogName : Stmt->Connection->mariadb->db));
+      is_alloc_fail |= !(uintptr_t)(current_row_ptr[0] = MADB_STRDUP(NameLength1 > 0 ? CatalogName : Stmt->Connection->mariadb->db));
       // TABLE_SCHEM
       current_row_ptr[1] = NULL;
       // TABLE_NAME
-      is_alloc_fail |= !(uintptr_t)(current_row_ptr[2] = strdup(field->table));
+      is_alloc_fail |= !(uintptr_t)(current_row_ptr[2] = MADB_STRDUP(field->table));
       // COLUMN_NAME
-      is_alloc_fail |= !(uintptr_t)(current_row_ptr[3] = strdup(field->name));
+      is_alloc_fail |= !(uintptr_t)(current_row_ptr[3] = MADB_STRDUP(field->name));
       // DATA_TYPE
       is_alloc_fail |= allocAndFormatInt(&current_row_ptr[4], odbc_data_type);
       // TYPE_NAME
@@ -4903,7 +5261,7 @@ SQLRETURN MADB_StmtColumnsNoInfoSchema(MADB_Stmt *Stmt,
       // COLUMN_DEF
       if (S2FieldDescr->DefaultValue)
       {
-        is_alloc_fail |= !(uintptr_t)(current_row_ptr[12] = strdup(S2FieldDescr->DefaultValue));
+        is_alloc_fail |= !(uintptr_t)(current_row_ptr[12] = MADB_STRDUP(S2FieldDescr->DefaultValue));
       }
       // SQL_DATA_TYPE (non-concise)
       is_alloc_fail |= allocAndFormatInt(&current_row_ptr[13], sql_data_type);
@@ -4976,7 +5334,7 @@ SQLRETURN MADB_StmtColumns(MADB_Stmt *Stmt,
   ADJUST_LENGTH(TableName, NameLength3);
   ADJUST_LENGTH(ColumnName, NameLength4);
 
-  if(MADB_DynstrAppend(&StmtStr, " WHERE TABLE_SCHEMA = "))
+  if(MADB_DYNAPPENDCONST(&StmtStr, " WHERE TABLE_SCHEMA = "))
   {
       ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       goto end;
@@ -4984,9 +5342,9 @@ SQLRETURN MADB_StmtColumns(MADB_Stmt *Stmt,
 
   if (CatalogName)
   {
-    if (MADB_DynstrAppend(&StmtStr, "'") ||
+    if (MADB_DYNAPPENDCONST(&StmtStr, "'") ||
         MADB_DynstrAppendMem(&StmtStr, CatalogName, NameLength1) ||
-        MADB_DynstrAppend(&StmtStr, "' "))
+        MADB_DYNAPPENDCONST(&StmtStr, "' "))
     {
         ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
         goto end;
@@ -4994,7 +5352,7 @@ SQLRETURN MADB_StmtColumns(MADB_Stmt *Stmt,
   }
   else
   {
-      if (MADB_DynstrAppend(&StmtStr, "DATABASE() "))
+      if (MADB_DYNAPPENDCONST(&StmtStr, "DATABASE() "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5003,9 +5361,9 @@ SQLRETURN MADB_StmtColumns(MADB_Stmt *Stmt,
 
   if (TableName)
   {
-      if (MADB_DynstrAppend(&StmtStr, "AND TABLE_NAME LIKE '") ||
+      if (MADB_DYNAPPENDCONST(&StmtStr, "AND TABLE_NAME LIKE '") ||
           MADB_DynstrAppendMem(&StmtStr, TableName, NameLength3) ||
-          MADB_DynstrAppend(&StmtStr, "' "))
+          MADB_DYNAPPENDCONST(&StmtStr, "' "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5014,16 +5372,16 @@ SQLRETURN MADB_StmtColumns(MADB_Stmt *Stmt,
 
   if (ColumnName)
   {
-      if (MADB_DynstrAppend(&StmtStr, "AND COLUMN_NAME LIKE '") ||
+      if (MADB_DYNAPPENDCONST(&StmtStr, "AND COLUMN_NAME LIKE '") ||
           MADB_DynstrAppendMem(&StmtStr, ColumnName, NameLength4) ||
-          MADB_DynstrAppend(&StmtStr, "' "))
+          MADB_DYNAPPENDCONST(&StmtStr, "' "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
       }
   }
 
-  if (MADB_DynstrAppend(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, ORDINAL_POSITION"))
+  if (MADB_DYNAPPENDCONST(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, ORDINAL_POSITION"))
   {
       ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       goto end;
@@ -5162,6 +5520,7 @@ SQLRETURN MADB_StmtProcedureColumns(MADB_Stmt *Stmt, char *CatalogName, SQLSMALL
     MadbErrNo err;
 
     MADB_CLEAR_ERROR(&Stmt->Error);
+    MADB_CHECK_ASYNC_BUSY(Stmt);
 
     /* Preprocess the input strings */
     ADJUST_LENGTH(CatalogName, NameLength1);
@@ -5301,6 +5660,7 @@ SQLRETURN MADB_StmtPrimaryKeysNoInfoSchema(MADB_Stmt *Stmt, char *CatalogName, S
                                 SQLSMALLINT NameLength3)
 {
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
   MYSQL_RES *tables_res, *show_keys_res;
   MYSQL_ROW table_row, keys_row;
   unsigned long *table_lengths, *keys_lengths;
@@ -5323,7 +5683,7 @@ SQLRETURN MADB_StmtPrimaryKeysNoInfoSchema(MADB_Stmt *Stmt, char *CatalogName, S
     return Stmt->Error.ReturnValue;
 
   int n_rows = 0, allocated_rows = 8;
-  char ***formatted_table_ptr = (char***)calloc(allocated_rows, sizeof(char**)), ***temp_ptr = NULL;
+  char ***formatted_table_ptr = (char***)MADB_CALLOC(allocated_rows * sizeof(char**)), ***temp_ptr = NULL;
   char **current_row_ptr;
   MYSQL_FIELD *field;
   short is_alloc_fail = 0;
@@ -5334,7 +5694,7 @@ SQLRETURN MADB_StmtPrimaryKeysNoInfoSchema(MADB_Stmt *Stmt, char *CatalogName, S
   if ( !(show_keys_res = S2_ShowKeysInTable(
         Stmt, CatalogName, NameLength1, table_row[0], table_lengths[0])) )
   {
-    free(formatted_table_ptr);
+    MADB_FREE(formatted_table_ptr);
     mysql_free_result(tables_res);
     mysql_free_result(show_keys_res);
     return Stmt->Error.ReturnValue;
@@ -5350,7 +5710,7 @@ SQLRETURN MADB_StmtPrimaryKeysNoInfoSchema(MADB_Stmt *Stmt, char *CatalogName, S
 
     if (n_rows >= allocated_rows)
     {
-      temp_ptr = realloc(formatted_table_ptr, allocated_rows = 2 * allocated_rows);
+      temp_ptr = MADB_REALLOC(formatted_table_ptr, (allocated_rows = 2 * allocated_rows) * sizeof(char**));
       if (!temp_ptr)
       {
         mysql_free_result(tables_res);
@@ -5360,18 +5720,18 @@ SQLRETURN MADB_StmtPrimaryKeysNoInfoSchema(MADB_Stmt *Stmt, char *CatalogName, S
       }
       formatted_table_ptr = temp_ptr;
     }
-    current_row_ptr = formatted_table_ptr[n_rows] = (char**)calloc(SQL_PRIMARY_KEYS_FIELD_COUNT, sizeof(char*));
+    current_row_ptr = formatted_table_ptr[n_rows] = (char**)MADB_CALLOC(SQL_PRIMARY_KEYS_FIELD_COUNT * sizeof(char*));
     ++n_rows;
      // TABLE_CAT
-    is_alloc_fail |= !(uintptr_t)(current_row_ptr[0] = strdup(NameLength1 > 0 ? CatalogName : Stmt->Connection->mariadb->db));
+    is_alloc_fail |= !(uintptr_t)(current_row_ptr[0] = MADB_STRDUP(NameLength1 > 0 ? CatalogName : Stmt->Connection->mariadb->db));
     // TABLE_SCHEM
     current_row_ptr[1] = NULL;
     // TABLE_NAME
-    is_alloc_fail |= !(uintptr_t)(current_row_ptr[2] = strndup(keys_row[0], keys_lengths[0]));
+    is_alloc_fail |= !(uintptr_t)(current_row_ptr[2] = MADB_STRNDUP(keys_row[0], keys_lengths[0]));
     // COLUMN_NAME
-    is_alloc_fail |= !(uintptr_t)(current_row_ptr[3] = strndup(keys_row[4], keys_lengths[4]));
+    is_alloc_fail |= !(uintptr_t)(current_row_ptr[3] = MADB_STRNDUP(keys_row[4], keys_lengths[4]));
     // KEY_SEQ
-    is_alloc_fail |= !(uintptr_t)(current_row_ptr[4] = strndup(keys_row[3], keys_lengths[3]));
+    is_alloc_fail |= !(uintptr_t)(current_row_ptr[4] = MADB_STRNDUP(keys_row[3], keys_lengths[3]));
     // PK_NAME
     current_row_ptr[5] = "PRIMARY";
     if (is_alloc_fail)
@@ -5408,6 +5768,8 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
   MADB_DynString StmtStr;
   SQLRETURN ret;
 
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   MDBUG_C_ENTER(Stmt->Connection, "StmtSpecialColumns");
 
   /* TableName is mandatory */
@@ -5430,7 +5792,7 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
   ADJUST_LENGTH(SchemaName, NameLength2);
   ADJUST_LENGTH(TableName, NameLength3);
 
-  if(MADB_DynstrAppend(&StmtStr, " WHERE TABLE_SCHEMA = "))
+  if(MADB_DYNAPPENDCONST(&StmtStr, " WHERE TABLE_SCHEMA = "))
   {
       ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       goto end;
@@ -5438,9 +5800,9 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
 
   if (CatalogName)
   {
-      if (MADB_DynstrAppend(&StmtStr, "'") ||
+      if (MADB_DYNAPPENDCONST(&StmtStr, "'") ||
           MADB_DynstrAppendMem(&StmtStr, CatalogName, NameLength1) ||
-          MADB_DynstrAppend(&StmtStr, "' "))
+          MADB_DYNAPPENDCONST(&StmtStr, "' "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5448,7 +5810,7 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
   }
   else
   {
-      if (MADB_DynstrAppend(&StmtStr, "DATABASE() "))
+      if (MADB_DYNAPPENDCONST(&StmtStr, "DATABASE() "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5457,9 +5819,9 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
 
   if (TableName && NameLength3)
   {
-      if (MADB_DynstrAppend(&StmtStr, "AND TABLE_NAME LIKE '") ||
+      if (MADB_DYNAPPENDCONST(&StmtStr, "AND TABLE_NAME LIKE '") ||
           MADB_DynstrAppendMem(&StmtStr, TableName, NameLength3) ||
-          MADB_DynstrAppend(&StmtStr, "' "))
+          MADB_DYNAPPENDCONST(&StmtStr, "' "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5468,7 +5830,7 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
 
   if (Nullable == SQL_NO_NULLS)
   {
-      if (MADB_DynstrAppend(&StmtStr, "AND IS_NULLABLE <> 'YES' "))
+      if (MADB_DYNAPPENDCONST(&StmtStr, "AND IS_NULLABLE <> 'YES' "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
@@ -5477,14 +5839,14 @@ SQLRETURN MADB_StmtSpecialColumns(MADB_Stmt *Stmt, SQLUSMALLINT IdentifierType,
 
   if (IdentifierType == SQL_BEST_ROWID)
   {
-      if (MADB_DynstrAppend(&StmtStr, "AND COLUMN_KEY IN ('PRI', 'UNI') "))
+      if (MADB_DYNAPPENDCONST(&StmtStr, "AND COLUMN_KEY IN ('PRI', 'UNI') "))
       {
           ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           goto end;
       }
   }
 
-  if (MADB_DynstrAppend(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, COLUMN_KEY"))
+  if (MADB_DYNAPPENDCONST(&StmtStr, " ORDER BY TABLE_SCHEMA, TABLE_NAME, COLUMN_KEY"))
   {
       ret = MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       goto end;
@@ -5508,6 +5870,7 @@ SQLRETURN MADB_StmtProcedures(MADB_Stmt *Stmt, char *CatalogName, SQLSMALLINT Na
        *p;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   p= StmtStr;
 
@@ -5546,6 +5909,7 @@ SQLRETURN MADB_StmtForeignKeys(MADB_Stmt *Stmt, char *PKCatalogName, SQLSMALLINT
   char EscapeBuf[256];
 
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   ADJUST_LENGTH(PKCatalogName, NameLength1);
   ADJUST_LENGTH(PKSchemaName, NameLength2);
@@ -5602,44 +5966,44 @@ SQLRETURN MADB_StmtForeignKeys(MADB_Stmt *Stmt, char *PKCatalogName, SQLSMALLINT
 
   if (PKTableName && PKTableName[0])
   {
-    MADB_DynstrAppend(&StmtStr, " AND A.REFERENCED_TABLE_SCHEMA "); 
+    MADB_DYNAPPENDCONST(&StmtStr, " AND A.REFERENCED_TABLE_SCHEMA "); 
 
     if (PKCatalogName && PKCatalogName[0])
     {
-      MADB_DynstrAppend(&StmtStr, "LIKE '");
+      MADB_DYNAPPENDCONST(&StmtStr, "LIKE '");
       mysql_real_escape_string(Stmt->Connection->mariadb, EscapeBuf, PKCatalogName, MIN(NameLength1, 255));
       MADB_DynstrAppend(&StmtStr, EscapeBuf);
-      MADB_DynstrAppend(&StmtStr, "' ");
+      MADB_DYNAPPENDCONST(&StmtStr, "' ");
     }
     else 
-      MADB_DynstrAppend(&StmtStr, "= DATABASE()");
-    MADB_DynstrAppend(&StmtStr, " AND A.REFERENCED_TABLE_NAME = '");
+      MADB_DYNAPPENDCONST(&StmtStr, "= DATABASE()");
+    MADB_DYNAPPENDCONST(&StmtStr, " AND A.REFERENCED_TABLE_NAME = '");
 
     mysql_real_escape_string(Stmt->Connection->mariadb, EscapeBuf, PKTableName, MIN(255, NameLength3));
     MADB_DynstrAppend(&StmtStr, EscapeBuf);
-    MADB_DynstrAppend(&StmtStr, "' ");
+    MADB_DYNAPPENDCONST(&StmtStr, "' ");
   }
 
   if (FKTableName && FKTableName[0])
   {
-    MADB_DynstrAppend(&StmtStr, " AND A.TABLE_SCHEMA = "); 
+    MADB_DYNAPPENDCONST(&StmtStr, " AND A.TABLE_SCHEMA = "); 
 
     if (FKCatalogName && FKCatalogName[0])
     {
-      MADB_DynstrAppend(&StmtStr, "'");
+      MADB_DYNAPPENDCONST(&StmtStr, "'");
       mysql_real_escape_string(Stmt->Connection->mariadb, EscapeBuf, FKCatalogName, MIN(NameLength4, 255));
       MADB_DynstrAppend(&StmtStr, EscapeBuf);
-      MADB_DynstrAppend(&StmtStr, "' ");
+      MADB_DYNAPPENDCONST(&StmtStr, "' ");
     }
     else
-      MADB_DynstrAppend(&StmtStr, "DATABASE() ");
-    MADB_DynstrAppend(&StmtStr, " AND A.TABLE_NAME = '");
+      MADB_DYNAPPENDCONST(&StmtStr, "DATABASE() ");
+    MADB_DYNAPPENDCONST(&StmtStr, " AND A.TABLE_NAME = '");
 
     mysql_real_escape_string(Stmt->Connection->mariadb, EscapeBuf, FKTableName, MIN(255, NameLength6));
     MADB_DynstrAppend(&StmtStr, EscapeBuf);
-    MADB_DynstrAppend(&StmtStr, "' ");
+    MADB_DYNAPPENDCONST(&StmtStr, "' ");
   }
-  MADB_DynstrAppend(&StmtStr, "ORDER BY FKTABLE_CAT, FKTABLE_SCHEM, FKTABLE_NAME, KEY_SEQ, PKTABLE_NAME");
+  MADB_DYNAPPENDCONST(&StmtStr, "ORDER BY FKTABLE_CAT, FKTABLE_SCHEM, FKTABLE_NAME, KEY_SEQ, PKTABLE_NAME");
   
   ret= Stmt->Methods->ExecDirect(Stmt, StmtStr.str, SQL_NTS);
 
@@ -5853,6 +6217,8 @@ void MADB_CspsFreeDAE(MADB_Stmt *Stmt)
 SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT Operation,
                       SQLUSMALLINT LockType, int ArrayOffset)
 {
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   if (!Stmt->result && !Stmt->stmt->fields)
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
@@ -5913,7 +6279,7 @@ SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT
 
         if (MADB_InitDynamicString(&DynStmt, "INSERT INTO ", 8192, 1024) ||
             MADB_DynStrAppendQuoted(&DynStmt, CatalogName) ||
-            MADB_DynstrAppend(&DynStmt, ".") ||
+            MADB_DYNAPPENDCONST(&DynStmt, ".") ||
             MADB_DynStrAppendQuoted(&DynStmt, TableName)||
             MADB_DynStrInsertSet(Stmt, &DynStmt))
         {
@@ -6033,6 +6399,12 @@ SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT
       else
         End= Start;
 
+      if (!SQL_SUCCEEDED(MADB_DbcApplySessionState(Stmt->Connection)))
+      {
+        MADB_CopyError(&Stmt->Error, &Stmt->Connection->Error);
+        return Stmt->Error.ReturnValue;
+      }
+
       while (Start <= End)
       {
         MADB_StmtDataSeek(Stmt, Start);
@@ -6211,7 +6583,23 @@ SQLRETURN MADB_StmtFetchScroll(MADB_Stmt *Stmt, SQLSMALLINT FetchOrientation,
   /* Assuming, that ret before previous "if" was SQL_SUCCESS */
   if (ret == SQL_SUCCESS)
   {
-    ret= Stmt->Methods->Fetch(Stmt);
+    /* Streamed rows are read from the server by the fetch, thus it is covered by SQL_ATTR_QUERY_TIMEOUT as well */
+    if (Stmt->Options.Timeout == 0 || !NO_CACHE(Stmt))
+    {
+      ret= Stmt->Methods->Fetch(Stmt);
+    }
+    else
+    {
+      MADB_QueryTimer Timer;
+
+      MADB_QueryTimerStart(&Timer, Stmt->Connection, Stmt->Options.Timeout);
+      ret= Stmt->Methods->Fetch(Stmt);
+      if (MADB_QueryTimerStop(&Timer))
+      {
+        Stmt->Methods->StmtFree(Stmt, SQL_CLOSE);
+        return MADB_SetError(&Stmt->Error, MADB_ERR_HYT00, NULL, 0);
+      }
+    }
   }
   if (ret == SQL_NO_DATA_FOUND && Stmt->LastRowFetched > 0)
   {
@@ -99,6 +99,7 @@ struct st_ma_stmt_methods
 };
 
 SQLRETURN    MADB_StmtInit          (MADB_Dbc *Connection, SQLHANDLE *pHStmt);
+void         MADB_StmtFreeListClear (MADB_Dbc *Dbc);
 void         MADB_StmtReset         (MADB_Stmt *Stmt);
 SQLUSMALLINT MapColAttributeDescType(SQLUSMALLINT FieldIdentifier);
 MYSQL_RES*   FetchMetadata          (MADB_Stmt *Stmt);
@@ -128,6 +129,12 @@ void         MADB_CspsFreeDAE(MADB_Stmt *Stmt);
 #define MADB_STMT_CLOSE_STMT(aStmt)   mysql_stmt_close((aStmt)->stmt);(aStmt)->stmt= NULL
 #define MADB_SSPS_ENABLED(aStmt) (aStmt)->Connection->Dsn->NoSsps == FALSE
 #define MADB_SSPS_DISABLED(aStmt) !(MADB_SSPS_ENABLED(aStmt))
+/* Number of server-side prepared statements, that are not used by any handle, kept per connection for reuse */
+#define MADB_STMT_CACHE_DEFAULT_SIZE 16
+/* Number of dropped statement objects, kept per connection to be reused by next allocated handles */
+#define MADB_STMT_FREE_LIST_SIZE 32
+/* Size of the statement's arena block. First block is kept by the arena reset */
+#define MADB_STMT_ARENA_BLOCK_SIZE 2048
 #define NO_CACHE(aStmt) ((aStmt)->Options.CursorType == SQL_CURSOR_FORWARD_ONLY && (aStmt)->Connection->Dsn->NoCache)
 /************** SQLColumns       *************/
 #define MADB_DATA_TYPE_ODBC2 \
@@ -44,7 +44,7 @@ char *MADB_GetTableName(MADB_Stmt *Stmt)
     }
   }
   if (TableName)
-    Stmt->TableName= _strdup(TableName);
+    Stmt->TableName= MADB_STRDUP(TableName);
 
   return Stmt->TableName;
 }
@@ -72,16 +72,16 @@ char *MADB_GetCatalogName(MADB_Stmt *Stmt)
     }
   }
   if (CatalogName)
-    Stmt->CatalogName= _strdup(CatalogName);
+    Stmt->CatalogName= MADB_STRDUP(CatalogName);
 
   return Stmt->CatalogName;
 }
 
 my_bool MADB_DynStrAppendQuoted(MADB_DynString *DynString, char *String)
 {
-  if (MADB_DynstrAppend(DynString, "`") ||
+  if (MADB_DYNAPPENDCONST(DynString, "`") ||
       MADB_DynstrAppend(DynString, String) ||
-      MADB_DynstrAppend(DynString, "`"))
+      MADB_DYNAPPENDCONST(DynString, "`"))
     return TRUE;
   return FALSE;
 }
@@ -91,7 +91,7 @@ my_bool MADB_DynStrUpdateSet(MADB_Stmt *Stmt, MADB_DynString *DynString)
   int             i, IgnoredColumns= 0;
   MADB_DescRecord *Record;
 
-  if (MADB_DynstrAppend(DynString, " SET "))
+  if (MADB_DYNAPPENDCONST(DynString, " SET "))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return TRUE;
@@ -110,7 +110,7 @@ my_bool MADB_DynStrUpdateSet(MADB_Stmt *Stmt, MADB_DynString *DynString)
       continue;
     }
     
-    if ((i - IgnoredColumns) && MADB_DynstrAppend(DynString, ","))
+    if ((i - IgnoredColumns) && MADB_DYNAPPENDCONST(DynString, ","))
     {
       MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       return TRUE;
@@ -120,7 +120,7 @@ my_bool MADB_DynStrUpdateSet(MADB_Stmt *Stmt, MADB_DynString *DynString)
       MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       return TRUE;
     }
-    if (MADB_DynstrAppend(DynString, "=?"))
+    if (MADB_DYNAPPENDCONST(DynString, "=?"))
     {
       MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       return TRUE;
@@ -141,7 +141,7 @@ my_bool MADB_DynStrInsertSet(MADB_Stmt *Stmt, MADB_DynString *DynString)
   MADB_DescRecord *Record;
 
   MADB_InitDynamicString(&ColVals, "VALUES (", 32, 32);
-  if (MADB_DynstrAppend(DynString, " ("))
+  if (MADB_DYNAPPENDCONST(DynString, " ("))
   {
     goto dynerror;
     
@@ -158,18 +158,18 @@ my_bool MADB_DynStrInsertSet(MADB_Stmt *Stmt, MADB_DynString *DynString)
     }
 
     if ((NeedComma) && 
-        (MADB_DynstrAppend(DynString, ",") || MADB_DynstrAppend(&ColVals, ",")))
+        (MADB_DYNAPPENDCONST(DynString, ",") || MADB_DYNAPPENDCONST(&ColVals, ",")))
       goto dynerror;
 
     if (MADB_DynStrAppendQuoted(DynString, Stmt->stmt->fields[i].org_name) ||
-        MADB_DynstrAppend(&ColVals, "?"))
+        MADB_DYNAPPENDCONST(&ColVals, "?"))
        goto dynerror;
 
     NeedComma= 1;
   }
-  if (MADB_DynstrAppend(DynString, ") " ) ||
-      MADB_DynstrAppend(&ColVals, ")") ||
-      MADB_DynstrAppend(DynString, ColVals.str))
+  if (MADB_DYNAPPENDCONST(DynString, ") ") ||
+      MADB_DYNAPPENDCONST(&ColVals, ")") ||
+      MADB_DynstrAppendMem(DynString, ColVals.str, ColVals.length))
     goto dynerror;
   MADB_DynstrFree(&ColVals);
   return FALSE;
@@ -182,14 +182,14 @@ dynerror:
 my_bool MADB_DynStrGetColumns(MADB_Stmt *Stmt, MADB_DynString *DynString)
 {
   unsigned int i;
-  if (MADB_DynstrAppend(DynString, " ("))
+  if (MADB_DYNAPPENDCONST(DynString, " ("))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return TRUE;
   }
   for (i=0; i < mysql_stmt_field_count(Stmt->stmt); i++)
   {
-    if (i && MADB_DynstrAppend(DynString, ", "))
+    if (i && MADB_DYNAPPENDCONST(DynString, ", "))
     {
       MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
       return TRUE;
@@ -200,7 +200,7 @@ my_bool MADB_DynStrGetColumns(MADB_Stmt *Stmt, MADB_DynString *DynString)
       return TRUE;
     }
   }
-  if (MADB_DynstrAppend(DynString, " )"))
+  if (MADB_DYNAPPENDCONST(DynString, " )"))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return TRUE;
@@ -250,19 +250,19 @@ my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *Ta
       return TRUE;
     }
   }
-  if (MADB_DynstrAppend(DynString, " WHERE 1"))
+  if (MADB_DYNAPPENDCONST(DynString, " WHERE 1"))
     goto memerror;
   for (i= 0; i < MADB_STMT_COLUMN_COUNT(Stmt); i++)
   {
     MYSQL_FIELD *field= mysql_fetch_field_direct(Stmt->metadata, i);
     if (field->flags & Flag || !Flag)
     {
-      if (MADB_DynstrAppend(DynString, " AND ") ||
+      if (MADB_DYNAPPENDCONST(DynString, " AND ") ||
           MADB_DynStrAppendQuoted(DynString, field->org_name))
           goto memerror;
       if (ParameterMarkers)
       {
-        if (MADB_DynstrAppend(DynString, "=?"))
+        if (MADB_DYNAPPENDCONST(DynString, "=?"))
           goto memerror;
       }
       else
@@ -274,7 +274,7 @@ my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *Ta
         }
         if (StrLength < 0)
         {
-           if (MADB_DynstrAppend(DynString, " IS NULL"))
+           if (MADB_DYNAPPENDCONST(DynString, " IS NULL"))
              goto memerror;
         }
         else
@@ -284,9 +284,9 @@ my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *Ta
           Escaped = MADB_CALLOC(2 * StrLength + 1);
           EscapedLength= mysql_real_escape_string(Stmt->Connection->mariadb, Escaped, Column, (unsigned long)StrLength);
 
-          if (MADB_DynstrAppend(DynString, "= '") ||
+          if (MADB_DYNAPPENDCONST(DynString, "= '") ||
             MADB_DynstrAppend(DynString, Escaped) ||//, EscapedLength) ||
-            MADB_DynstrAppend(DynString, "'"))
+            MADB_DYNAPPENDCONST(DynString, "'"))
           {
             goto memerror;
           }
@@ -296,7 +296,7 @@ my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *Ta
       }
     }
   }
-  if (MADB_DynstrAppend(DynString, " LIMIT 1"))
+  if (MADB_DYNAPPENDCONST(DynString, " LIMIT 1"))
     goto memerror;
   MADB_FREE(Column);
 
@@ -313,7 +313,7 @@ memerror:
 my_bool MADB_DynStrGetValues(MADB_Stmt *Stmt, MADB_DynString *DynString)
 {
   unsigned int i;
-  if (MADB_DynstrAppend(DynString, " VALUES("))
+  if (MADB_DYNAPPENDCONST(DynString, " VALUES("))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return TRUE;
@@ -326,7 +326,7 @@ my_bool MADB_DynStrGetValues(MADB_Stmt *Stmt, MADB_DynString *DynString)
       return TRUE;
     }
   }
-  if (MADB_DynstrAppend(DynString, ")"))
+  if (MADB_DYNAPPENDCONST(DynString, ")"))
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return TRUE;
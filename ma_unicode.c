@@ -366,6 +366,12 @@ SQLRETURN SQL_API SQLExecDirectW(SQLHSTMT StatementHandle,
     MDBUG_C_ENTER(Stmt->Connection, "SQLExecDirectW");
     MDBUG_C_DUMP(Stmt->Connection, Stmt, 0x);
 
+    /* Asynchronous operation in progress has its own copy of the query */
+    if (MADB_ASYNC_IN_PROGRESS(Stmt))
+    {
+        MDBUG_C_RETURN(Stmt->Connection, MADB_AsyncExecDirect(Stmt, NULL, 0), &Stmt->Error);
+    }
+
     CpStmt= MADB_ConvertFromWChar(StatementText, TextLength, &StmtLength, Stmt->Connection->ConnOrSrcCharset, &ConversionError);
     MDBUG_C_DUMP(Stmt->Connection, CpStmt, s);
     if (ConversionError)
@@ -374,7 +380,7 @@ SQLRETURN SQL_API SQLExecDirectW(SQLHSTMT StatementHandle,
         ret= Stmt->Error.ReturnValue;
     }
     else
-        ret= Stmt->Methods->ExecDirect(Stmt, CpStmt, (SQLINTEGER)StmtLength);
+        ret= MADB_AsyncExecDirect(Stmt, CpStmt, (SQLINTEGER)StmtLength);
     MADB_FREE(CpStmt);
 
     MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
@@ -538,6 +544,13 @@ SQLRETURN SQL_API MA_SQLGetDiagRecW(SQLSMALLINT HandleType,
                                    (void *)MessageText, BufferLength, TextLengthPtr, TRUE,
                                    Env->OdbcVersion);
         }
+        case SQL_HANDLE_DBC_INFO_TOKEN:
+        {
+            MADB_DbcInfoToken *Token= (MADB_DbcInfoToken *)Handle;
+            return MADB_GetDiagRec(&Token->Error, RecNumber, (void *)SQLState, NativeErrorPtr,
+                                   (void *)MessageText, BufferLength, TextLengthPtr, TRUE,
+                                   Token->Environment->OdbcVersion);
+        }
         default:
             return SQL_ERROR;
             break;
@@ -716,6 +729,7 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT StatementHandle,
     SQLULEN StmtLength;
     SQLRETURN ret;
     BOOL ConversionError;
+    MADB_AllocCounters *SavedScope;
 
     if (!Stmt)
         return SQL_INVALID_HANDLE;
@@ -723,6 +737,7 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT StatementHandle,
 
     MDBUG_C_ENTER(Stmt->Connection, "SQLPrepareW");
 
+    SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
     StmtStr= MADB_ConvertFromWChar(StatementText, TextLength, &StmtLength, Stmt->Connection->ConnOrSrcCharset, &ConversionError);
 
     MDBUG_C_DUMP(Stmt->Connection, Stmt, 0x);
@@ -737,11 +752,61 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT StatementHandle,
     else
         ret= Stmt->Methods->Prepare(Stmt, StmtStr, (SQLINTEGER)StmtLength, FALSE);
     MADB_FREE(StmtStr);
+    MADB_AllocScopeLeave(SavedScope);
 
     MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
 }
 /* }}} */
 
+/* {{{ SQLPoolConnectW */
+SQLRETURN SQL_API SQLPoolConnectW(SQLHDBC hDbc,
+                                  SQLHDBC_INFO_TOKEN hDbcInfoToken,
+                                  SQLWCHAR *szConnStrOut,
+                                  SQLSMALLINT cchConnStrOutMax,
+                                  SQLSMALLINT *pcchConnStrOut)
+{
+    SQLRETURN   ret;
+    SQLULEN     Length=       0;
+    char        *OutConnStrA= NULL;
+    MADB_Dbc    *Dbc=         (MADB_Dbc *)hDbc;
+
+    if (!Dbc)
+        return SQL_INVALID_HANDLE;
+
+    MDBUG_C_ENTER(Dbc, "SQLPoolConnectW");
+    MDBUG_C_DUMP(Dbc, Dbc, 0x);
+    MDBUG_C_DUMP(Dbc, hDbcInfoToken, 0x);
+
+    MADB_CLEAR_ERROR(&Dbc->Error);
+
+    Dbc->IsAnsi= 0;
+
+    if (szConnStrOut && cchConnStrOutMax)
+    {
+        Length= cchConnStrOutMax*4 /*Max bytes per utf8 character */;
+        OutConnStrA= (char *)MADB_CALLOC(Length);
+
+        if (OutConnStrA == NULL)
+        {
+            ret= MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
+            goto end;
+        }
+    }
+
+    ret= MADB_PoolConnect(Dbc, (MADB_DbcInfoToken *)hDbcInfoToken, (SQLCHAR *)OutConnStrA, Length, pcchConnStrOut);
+    if (SQL_SUCCEEDED(ret) && OutConnStrA != NULL)
+    {
+        Length= MADB_SetString(&utf8, szConnStrOut, cchConnStrOutMax, OutConnStrA, SQL_NTS, &Dbc->Error);
+        if (pcchConnStrOut)
+            *pcchConnStrOut= (SQLSMALLINT)Length;
+    }
+
+    end:
+    MADB_FREE(OutConnStrA);
+    MDBUG_C_RETURN(Dbc, ret, &Dbc->Error);
+}
+/* }}} */
+
 /* {{{ SQLPrimaryKeysW */
 SQLRETURN SQL_API SQLPrimaryKeysW(SQLHSTMT StatementHandle,
                                   SQLWCHAR *CatalogName,
@@ -892,6 +957,65 @@ SQLRETURN SQL_API SQLSetConnectAttrW(SQLHDBC ConnectionHandle,
 }
 /* }}} */
 
+/* {{{ SQLSetConnectAttrForDbcInfoW */
+SQLRETURN SQL_API SQLSetConnectAttrForDbcInfoW(SQLHDBC_INFO_TOKEN hDbcInfoToken,
+                                               SQLINTEGER Attribute,
+                                               SQLPOINTER Value,
+                                               SQLINTEGER StringLength)
+{
+    return MADB_DbcInfoTokenSetAttr((MADB_DbcInfoToken *)hDbcInfoToken, Attribute, Value, StringLength, TRUE);
+}
+/* }}} */
+
+/* {{{ SQLSetConnectInfoW */
+SQLRETURN SQL_API SQLSetConnectInfoW(SQLHDBC_INFO_TOKEN TokenHandle,
+                                     SQLWCHAR *ServerName,
+                                     SQLSMALLINT NameLength1,
+                                     SQLWCHAR *UserName,
+                                     SQLSMALLINT NameLength2,
+                                     SQLWCHAR *Authentication,
+                                     SQLSMALLINT NameLength3)
+{
+    char *MBServerName= NULL, *MBUserName= NULL, *MBAuthentication= NULL;
+    SQLRETURN ret;
+
+    if (!TokenHandle)
+        return SQL_INVALID_HANDLE;
+
+    if (ServerName)
+        MBServerName= MADB_ConvertFromWChar(ServerName, NameLength1, 0, &utf8, NULL);
+    if (UserName)
+        MBUserName= MADB_ConvertFromWChar(UserName, NameLength2, 0, &utf8, NULL);
+    if (Authentication)
+        MBAuthentication= MADB_ConvertFromWChar(Authentication, NameLength3, 0, &utf8, NULL);
+
+    ret= MADB_DbcInfoTokenSetConnectInfo((MADB_DbcInfoToken *)TokenHandle, MBServerName, SQL_NTS, MBUserName, SQL_NTS,
+                                         MBAuthentication, SQL_NTS);
+    MADB_FREE(MBServerName);
+    MADB_FREE(MBUserName);
+    MADB_FREE(MBAuthentication);
+    return ret;
+}
+/* }}} */
+
+/* {{{ SQLSetDriverConnectInfoW */
+SQLRETURN SQL_API SQLSetDriverConnectInfoW(SQLHDBC_INFO_TOKEN TokenHandle,
+                                           SQLWCHAR *InConnectionString,
+                                           SQLSMALLINT StringLength1)
+{
+    char *InConnStrA;
+    SQLRETURN ret;
+
+    if (!TokenHandle)
+        return SQL_INVALID_HANDLE;
+
+    InConnStrA= MADB_ConvertFromWChar(InConnectionString, StringLength1, NULL, &utf8, NULL);
+    ret= MADB_DbcInfoTokenSetDriverConnectInfo((MADB_DbcInfoToken *)TokenHandle, InConnStrA, SQL_NTS);
+    MADB_FREE(InConnStrA);
+    return ret;
+}
+/* }}} */
+
 /* {{{ SQLSetConnectOptionW */
 SQLRETURN SQL_API SQLSetConnectOptionW(SQLHDBC Hdbc, SQLUSMALLINT Option, SQLULEN Param)
 {
@@ -56,9 +56,17 @@ SQLRETURN MA_SQLAllocHandle(SQLSMALLINT HandleType,
         ret= SQL_SUCCESS;
       }
       break;
+    case SQL_HANDLE_DBC_INFO_TOKEN:
+      MADB_CLEAR_ERROR(&((MADB_Env *)InputHandle)->Error);
+      if ((*OutputHandlePtr= (SQLHANDLE)MADB_DbcInfoTokenInit((MADB_Env *)InputHandle)) != NULL)
+      {
+        ret= SQL_SUCCESS;
+      }
+      break;
     case SQL_HANDLE_STMT:
       {
         MADB_Dbc *Connection= (MADB_Dbc *)InputHandle;
+        MADB_AllocCounters *SavedScope;
         MDBUG_C_ENTER(InputHandle, "MA_SQLAllocHandle(Stmt)");
         MDBUG_C_DUMP(InputHandle, InputHandle, 0x);
         MDBUG_C_DUMP(InputHandle, OutputHandlePtr, 0x);
@@ -71,7 +79,9 @@ SQLRETURN MA_SQLAllocHandle(SQLSMALLINT HandleType,
           break;
         }
 
+        SavedScope= MADB_AllocScopeEnter(&Connection->MemCounters);
         ret= MADB_StmtInit(Connection, OutputHandlePtr);
+        MADB_AllocScopeLeave(SavedScope);
         MDBUG_C_DUMP(InputHandle, *OutputHandlePtr, 0x);
         MDBUG_C_RETURN(InputHandle,ret, &Connection->Error);
       }
@@ -255,41 +265,23 @@ SQLRETURN MA_SQLCancel(SQLHSTMT StatementHandle)
   MDBUG_C_ENTER(Stmt->Connection, "SQLCancel");
   MDBUG_C_DUMP(Stmt->Connection, Stmt, 0x);
 
+  /* Suspended asynchronous operation holds the connection's lock, and ends with the error, when the application
+     calls its function next time. Only the handle, that owns the operation, may cancel it */
+  if (Stmt->Connection->AsyncStmt == Stmt)
+  {
+    ret= MADB_DbcKillQuery(Stmt->Connection) == 0 ? SQL_SUCCESS : SQL_ERROR;
+    MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
+  }
   if (TryEnterCriticalSection(&Stmt->Connection->cs))
   {
     LeaveCriticalSection(&Stmt->Connection->cs);
     ret= Stmt->Methods->StmtFree(Stmt, SQL_CLOSE);
 
     MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
-  } else
+  } else if (MADB_DbcKillQuery(Stmt->Connection) == 0)
   {
-    MYSQL *MariaDb, *Kill=Stmt->Connection->mariadb;
-    
-    char StmtStr[30];
-
-    if (!(MariaDb= mysql_init(NULL)))
-    {
-      ret= SQL_ERROR;
-      goto end;
-    }
-    if (!(mysql_real_connect(MariaDb, Kill->host, Kill->user, Kill->passwd,
-                             "", Kill->port, Kill->unix_socket, 0)))
-    {
-      mysql_close(MariaDb);
-      goto end;
-    }
-    
-    _snprintf(StmtStr, 30, "KILL QUERY %ld", mysql_thread_id(Kill));
-    if (mysql_query(MariaDb, StmtStr))
-    {
-      mysql_close(MariaDb);
-      goto end;
-    }
-    mysql_close(MariaDb);
     ret= SQL_SUCCESS;
   }
-end:
-  LeaveCriticalSection(&Stmt->Connection->cs);
 
   MDBUG_C_RETURN(Stmt->Connection, ret, &Stmt->Error);
 }
@@ -337,7 +329,12 @@ SQLRETURN SQL_API SQLCloseCursor(SQLHSTMT StatementHandle)
   MDBUG_C_ENTER(Stmt->Connection, "SQLCloseCursor");
   MDBUG_C_DUMP(Stmt->Connection, StatementHandle, 0x);
 
-  if (!Stmt->stmt || 
+  if (Stmt->Connection->AsyncStmt != NULL)
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
+    ret= Stmt->Error.ReturnValue;
+  }
+  else if (!Stmt->stmt || 
      (!mysql_stmt_field_count(Stmt->stmt) && 
        Stmt->Connection->Environment->OdbcVersion >= SQL_OV_ODBC3))
   {
@@ -391,6 +388,14 @@ SQLRETURN SQLConnectCommon(SQLHDBC ConnectionHandle,
   MDBUG_C_DUMP(Connection, Authentication, s);
   MDBUG_C_DUMP(Connection, NameLength3, d);
 
+  /* Asynchronous connecting in progress - resuming it with the DSN, it has been started with */
+  if (Connection->AsyncConnect.Func == MADB_ASYNC_CONNECT)
+  {
+    Dsn= Connection->AsyncConnect.Dsn;
+    ret= MADB_AsyncConnectDB(Connection, Dsn);
+    goto end;
+  }
+
   if (CheckConnection(Connection))
   {
     MADB_SetError(&Connection->Error, MADB_ERR_08002, NULL, 0);
@@ -416,8 +421,13 @@ SQLRETURN SQLConnectCommon(SQLHDBC ConnectionHandle,
   MADB_DSN_SET_STR(Dsn, UserName, (char *)UserName, NameLength2);
   MADB_DSN_SET_STR(Dsn, Password, (char *)Authentication, NameLength3);
 
-  ret= Connection->Methods->ConnectDB(Connection, Dsn);
+  ret= MADB_AsyncConnectDB(Connection, Dsn);
 
+end:
+  if (ret == SQL_STILL_EXECUTING)
+  {
+    MDBUG_C_RETURN(Connection, ret, &Connection->Error);
+  }
   if (SQL_SUCCEEDED(ret))
   {
     MADB_DSN_Free(Connection->Dsn);
@@ -483,6 +493,13 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC ConnectionHandle)
   MDBUG_C_ENTER(Connection, "SQLDisconnect");
   MDBUG_C_DUMP(Connection, ConnectionHandle, 0x);
 
+  /* Neither statements, nor the connection can be closed under asynchronous operation in progress */
+  if (Connection->AsyncStmt != NULL || Connection->AsyncConnect.Func != MADB_ASYNC_NONE)
+  {
+    MADB_SetError(&Connection->Error, MADB_ERR_HY010, NULL, 0);
+    MDBUG_C_RETURN(Connection, Connection->Error.ReturnValue, &Connection->Error);
+  }
+
   /* Close all statements */
   for (Element= Connection->Stmts; Element; Element= NextElement)
   {
@@ -497,6 +514,8 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC ConnectionHandle)
     MADB_DescFree((MADB_Desc*)Element->data, FALSE);
   }
 
+  MADB_StmtCacheFree(Connection);
+
   if (Connection->mariadb)
   {
     mysql_close(Connection->mariadb);
@@ -509,6 +528,7 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC ConnectionHandle)
     ret= Connection->Error.ReturnValue;
   }
   Connection->ConnOrSrcCharset= NULL;
+  MADB_ParseCacheFree(Connection);
 
   MDBUG_C_RETURN(Connection, ret, &Connection->Error);
 }
@@ -587,7 +607,7 @@ SQLRETURN SQL_API SQLExecute(SQLHSTMT StatementHandle)
   MDBUG_C_ENTER(Stmt->Connection, "SQLExecute");
   MDBUG_C_DUMP(Stmt->Connection, Stmt, 0x);
 
-  return Stmt->Methods->Execute(Stmt, FALSE);
+  return MADB_AsyncExecute(Stmt);
 }
 /* }}} */
 
@@ -608,6 +628,8 @@ SQLRETURN SQL_API SQLExtendedFetch(SQLHSTMT StatementHandle,
     return SQL_INVALID_HANDLE;
   MADB_CLEAR_ERROR(&Stmt->Error);
 
+  MADB_CHECK_ASYNC_BUSY(Stmt);
+
   MDBUG_C_ENTER(Stmt->Connection, "SQLExtendedFetch");
   MDBUG_C_DUMP(Stmt->Connection, FetchOrientation, u);
   MDBUG_C_DUMP(Stmt->Connection, FetchOffset, d);
@@ -655,7 +677,7 @@ SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle)
   MADB_CLEAR_ERROR(&Stmt->Error);
 
   /* SQLFetch is equivalent of SQLFetchScroll(SQL_FETCH_NEXT), 3rd parameter is ignored for SQL_FETCH_NEXT */
-  MDBUG_C_RETURN(Stmt->Connection, Stmt->Methods->FetchScroll(Stmt, SQL_FETCH_NEXT, 1), &Stmt->Error);
+  MDBUG_C_RETURN(Stmt->Connection, MADB_AsyncFetchScroll(Stmt, SQL_FETCH_NEXT, 1), &Stmt->Error);
 }
 /* }}} */
 
@@ -676,7 +698,7 @@ SQLRETURN SQL_API SQLFetchScroll(SQLHSTMT StatementHandle,
 
   MADB_CLEAR_ERROR(&Stmt->Error);
 
-  MDBUG_C_RETURN(Stmt->Connection, Stmt->Methods->FetchScroll(Stmt, FetchOrientation, FetchOffset), &Stmt->Error);
+  MDBUG_C_RETURN(Stmt->Connection, MADB_AsyncFetchScroll(Stmt, FetchOrientation, FetchOffset), &Stmt->Error);
 }
 /* }}} */
 
@@ -740,6 +762,9 @@ SQLRETURN SQL_API SQLFreeHandle(SQLSMALLINT HandleType,
 
       MDBUG_C_RETURN(Dbc, ret, &Dbc->Error);
     }
+  case SQL_HANDLE_DBC_INFO_TOKEN:
+    ret= MADB_DbcInfoTokenFree((MADB_DbcInfoToken *)Handle);
+    break;
   }
 
   MDBUG_RETURN(ret);
@@ -773,11 +798,25 @@ SQLRETURN MA_SQLFreeStmt(SQLHSTMT StatementHandle,
            SQLUSMALLINT Option)
 {
   MADB_Stmt *Stmt= (MADB_Stmt *)StatementHandle;
+  MADB_AllocCounters *SavedScope;
+  SQLRETURN ret;
   MDBUG_C_PRINT(Stmt->Connection, "%sMA_SQLFreeStmt","\t->");
   MDBUG_C_DUMP(Stmt->Connection, Stmt, 0x);
   MDBUG_C_DUMP(Stmt->Connection, Option, d);
 
-  return Stmt->Methods->StmtFree(Stmt, Option);
+  /* Closing the cursor, or dropping the statement, would interfere with the operation, that holds the connection */
+  if (Stmt->Connection->AsyncStmt == Stmt ||
+      (Stmt->Connection->AsyncStmt != NULL && (Option == SQL_CLOSE || Option == SQL_DROP)))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
+  }
+
+  /* Counters belong to the connection, thus stay valid, even if the statement is dropped */
+  SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+  ret= Stmt->Methods->StmtFree(Stmt, Option);
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
 }
 
 SQLRETURN SQL_API SQLFreeStmt(SQLHSTMT StatementHandle,
@@ -827,10 +866,13 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
   MADB_Stmt *Stmt= (MADB_Stmt*)StatementHandle;
   unsigned int i;
   MADB_DescRecord *IrdRec;
+  MADB_AllocCounters *SavedScope;
+  SQLRETURN ret;
 
   if (StatementHandle== SQL_NULL_HSTMT)
     return SQL_INVALID_HANDLE;
   MADB_CLEAR_ERROR(&Stmt->Error);
+  MADB_CHECK_ASYNC_BUSY(Stmt);
 
   /* In case we don't have DM(it check for that) */
   if (TargetValuePtr == NULL)
@@ -856,6 +898,7 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
     return MADB_SetError(&Stmt->Error, MADB_ERR_HY090, NULL, 0);
   }
 
+  SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
   /* reset offsets for other columns. Doing that here since "internal" calls should not do that */
   for (i=0; i < mysql_stmt_field_count(Stmt->stmt); i++)
   {
@@ -870,7 +913,10 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
     }
   }
 
-  return Stmt->Methods->GetData(StatementHandle, Col_or_Param_Num, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr, FALSE);
+  ret= Stmt->Methods->GetData(StatementHandle, Col_or_Param_Num, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr, FALSE);
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
 }
 /* }}} */
 
@@ -953,6 +999,14 @@ SQLRETURN MA_SQLGetDiagRec(SQLSMALLINT HandleType,
                                Env->OdbcVersion);
       }
       break;
+    case SQL_HANDLE_DBC_INFO_TOKEN:
+      {
+        MADB_DbcInfoToken *Token= (MADB_DbcInfoToken *)Handle;
+        ret= MADB_GetDiagRec(&Token->Error, RecNumber, (void *)SQLState, NativeErrorPtr,
+                               (void *)MessageText, BufferLength, TextLengthPtr, FALSE,
+                               Token->Environment->OdbcVersion);
+      }
+      break;
   }
 
   MDBUG_RETURN(ret);
@@ -1038,11 +1092,17 @@ SQLRETURN SQL_API SQLGetStmtOption(SQLHSTMT StatementHandle,
 SQLRETURN SQL_API SQLMoreResults(SQLHSTMT StatementHandle)
 {
   MADB_Stmt *Stmt= (MADB_Stmt *)StatementHandle;
+  MADB_AllocCounters *SavedScope;
+  SQLRETURN ret;
   if (!Stmt)
     return SQL_INVALID_HANDLE;
   MADB_CLEAR_ERROR(&Stmt->Error);
 
-  return MADB_StmtMoreResults(Stmt);
+  SavedScope= MADB_AllocScopeEnter(&Stmt->Connection->MemCounters);
+  ret= MADB_StmtMoreResults(Stmt);
+  MADB_AllocScopeLeave(SavedScope);
+
+  return ret;
 }
 /* }}} */
 
@@ -1296,3 +1356,31 @@ SQLRETURN SQL_API SQLParamOptions(
   return result;
 }
 /* }}} */
+
+/* {{{ SQLGetPoolID */
+SQLRETURN SQL_API SQLGetPoolID(SQLHDBC_INFO_TOKEN hDbcInfoToken,
+                               POOLID *pPoolID)
+{
+  return MADB_GetPoolID((MADB_DbcInfoToken *)hDbcInfoToken, pPoolID);
+}
+/* }}} */
+
+/* {{{ SQLRateConnection */
+SQLRETURN SQL_API SQLRateConnection(SQLHDBC_INFO_TOKEN hRequest,
+                                    SQLHDBC hCandidateConnection,
+                                    BOOL fRequiredTransactionEnlistment,
+                                    TRANSID transId,
+                                    SQLUINTEGER *pRating)
+{
+  return MADB_RateConnection((MADB_DbcInfoToken *)hRequest, (MADB_Dbc *)hCandidateConnection,
+                             fRequiredTransactionEnlistment, pRating);
+}
+/* }}} */
+
+/* {{{ SQLCleanupConnectionPoolID */
+SQLRETURN SQL_API SQLCleanupConnectionPoolID(SQLHENV hEnv,
+                                             POOLID pid)
+{
+  return MADB_CleanupConnectionPoolID((MADB_Env *)hEnv, pid);
+}
+/* }}} */
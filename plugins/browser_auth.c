@@ -45,7 +45,7 @@ int getJsonStringField(MADB_Dbc *Dbc, cJSON *json, const char *fieldName, char *
     }
     return 1;
   }
-  if (!(*dst = strdup(field->valuestring)))
+  if (!(*dst = MADB_STRDUP(field->valuestring)))
   {
     return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
   }
@@ -202,7 +202,7 @@ int parseCredentialsFromJson(MADB_Dbc *Dbc, cJSON *json, const char *jwt, int jw
     goto end;
   }
 
-  if (!(credentials->token = strndup(jwt, jwt_len)))
+  if (!(credentials->token = MADB_STRNDUP(jwt, jwt_len)))
   {
     MADB_SetError(&Dbc->Error, MADB_ERR_HY000, NULL, 0);
     goto end;
@@ -291,7 +291,8 @@ int parseJWTToCredentials(MADB_Dbc *Dbc, const char *token, int token_len, Brows
 
 cleanup:
   MADB_FREE(base64);
-  MADB_FREE(jsonStr);
+  /* b64 allocates with libc */
+  free(jsonStr);
   cJSON_Delete(json);
 
   return Dbc->Error.ReturnValue;
@@ -512,10 +513,10 @@ cleanupRequest:
 
 void makeTestCreds(BrowserAuthCredentials *credentials /*out*/)
 {
-  credentials->username = strdup("test_jwt_user");
-  credentials->email = strdup("test@singlestore.com");
+  credentials->username = MADB_STRDUP("test_jwt_user");
+  credentials->email = MADB_STRDUP("test@singlestore.com");
   credentials->expiration = 2514359920;
-  credentials->token = strdup(getenv("MEMSQL_JWT"));
+  credentials->token = MADB_STRDUP(getenv("MEMSQL_JWT"));
 }
 
 // BrowserAuth opens browser to perform the auth workflow using SSO.
@@ -735,7 +736,7 @@ int PutCachedCredentials(MADB_Dbc *Dbc, BrowserAuthCredentials *bac)
 // Win secure key storage
   CREDENTIALW* winCred = NULL;
   wchar_t* userName = NULL;
-  if ( !(winCred = (CREDENTIALW*)malloc(sizeof(CREDENTIALW))) )
+  if ( !(winCred = (CREDENTIALW*)MADB_ALLOC(sizeof(CREDENTIALW))) )
   {
     MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
     goto endwin;
@@ -750,7 +751,7 @@ int PutCachedCredentials(MADB_Dbc *Dbc, BrowserAuthCredentials *bac)
   winCred->Persist = CRED_PERSIST_LOCAL_MACHINE;
   winCred->AttributeCount = 0;
   winCred->Attributes = NULL;
-  if ( !(userName = (wchar_t*)malloc(sizeof(wchar_t) * (strlen(bac->username) + 1))) )
+  if ( !(userName = (wchar_t*)MADB_ALLOC(sizeof(wchar_t) * (strlen(bac->username) + 1))) )
   {
     MADB_SetError(&Dbc->Error, MADB_ERR_HY001, NULL, 0);
   }
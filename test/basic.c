@@ -814,6 +814,12 @@ ODBC_TEST(sqlcancel)
 
   return OK;
 }
+
+
+ODBC_TEST(sqlcancel_reuse_control)
+{
+  skip("Cancelling the query in progress needs threads");
+}
 #else
 
 #ifdef _WIN32
@@ -847,6 +853,31 @@ ODBC_TEST(sqlcancel)
 
   return OK;
 }
+
+
+/* The second cancel goes over the control connection, established by the first one */
+ODBC_TEST(sqlcancel_reuse_control)
+{
+  HANDLE thread;
+  DWORD waitrc;
+  int i;
+
+  for (i= 0; i < 2; ++i)
+  {
+    thread= CreateThread(NULL, 0, cancel_in_one_second, Stmt, 0, NULL);
+
+    /* SLEEP(n) returns 1 when it is killed. */
+    OK_SIMPLE_STMT(Stmt, "SELECT SLEEP(5)");
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(my_fetch_int(Stmt, 1), 1);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    waitrc= WaitForSingleObject(thread, 10000);
+    IS(!(waitrc == WAIT_TIMEOUT));
+  }
+
+  return OK;
+}
 #else
 void *cancel_in_one_second(void *arg)
 {
@@ -877,9 +908,55 @@ ODBC_TEST(sqlcancel)
 
   return OK;
 }
+
+
+/* The second cancel goes over the control connection, established by the first one */
+ODBC_TEST(sqlcancel_reuse_control)
+{
+  pthread_t thread;
+  int i;
+
+  for (i= 0; i < 2; ++i)
+  {
+    pthread_create(&thread, NULL, cancel_in_one_second, Stmt);
+
+    /* SLEEP(n) returns 1 when it is killed. */
+    OK_SIMPLE_STMT(Stmt, "SELECT SLEEP(10)");
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(my_fetch_int(Stmt, 1), 1);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    pthread_join(thread, NULL);
+  }
+
+  return OK;
+}
 #endif  // ifdef _WIN32
 #endif  // ifndef THREAD
 
+
+ODBC_TEST(t_query_timeout)
+{
+  SQLULEN Timeout= 0;
+
+  CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)1, 0));
+  CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, SQL_ATTR_QUERY_TIMEOUT, &Timeout, 0, NULL));
+  is_num(Timeout, 1);
+
+  /* The query is killed on the server, and the connection stays usable */
+  EXPECT_STMT(Stmt, SQLExecDirect(Stmt, (SQLCHAR *)"SELECT SLEEP(10)", SQL_NTS), SQL_ERROR);
+  CHECK_SQLSTATE(Stmt, "HYT00");
+
+  OK_SIMPLE_STMT(Stmt, "SELECT 1");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), 1);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)0, 0));
+
+  return OK;
+}
+
 ODBC_TEST(t_describe_nulti)
 {
   SQLHENV   henv1;
@@ -1686,6 +1763,135 @@ ODBC_TEST(t_odbc181)
   return OK;
 }
 
+/* Statements of the same connection used from different threads. Unescaping, parsing and parameters conversion are
+   done without the connection lock, and all that must stay correct, while other threads are talking to the server */
+#define CONCURRENT_STMT_THREADS    4
+#define CONCURRENT_STMT_ITERATIONS 50
+
+typedef struct
+{
+  SQLHSTMT Hstmt;
+  int      Id;
+  int      Failed;
+} ConcurrentStmtArg;
+
+static int ConcurrentStmtRun(ConcurrentStmtArg *Arg)
+{
+  SQLINTEGER  Param, Value;
+  SQLLEN      ValueLen;
+  SQLSMALLINT ColumnCount;
+  int         i;
+
+  for (i= 0; i < CONCURRENT_STMT_ITERATIONS; ++i)
+  {
+    Param= Arg->Id * 1000 + i;
+    Value= 0;
+
+    if (!SQL_SUCCEEDED(SQLPrepare(Arg->Hstmt, (SQLCHAR*)"SELECT {fn ABS(?)} + 1 AS `value`", SQL_NTS)) ||
+        !SQL_SUCCEEDED(SQLBindParameter(Arg->Hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &Param, 0, NULL)) ||
+        !SQL_SUCCEEDED(SQLExecute(Arg->Hstmt)) ||
+        !SQL_SUCCEEDED(SQLNumResultCols(Arg->Hstmt, &ColumnCount)) || ColumnCount != 1 ||
+        !SQL_SUCCEEDED(SQLBindCol(Arg->Hstmt, 1, SQL_C_LONG, &Value, 0, &ValueLen)) ||
+        !SQL_SUCCEEDED(SQLFetch(Arg->Hstmt)) || Value != Param + 1 ||
+        SQLFetch(Arg->Hstmt) != SQL_NO_DATA ||
+        !SQL_SUCCEEDED(SQLFreeStmt(Arg->Hstmt, SQL_CLOSE)))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+#ifdef _WIN32
+DWORD WINAPI ConcurrentStmtThread(LPVOID arg)
+{
+  ConcurrentStmtArg *Arg= (ConcurrentStmtArg *)arg;
+
+  Arg->Failed= ConcurrentStmtRun(Arg);
+
+  return 0;
+}
+#else
+#include <pthread.h>
+
+void *ConcurrentStmtThread(void *arg)
+{
+  ConcurrentStmtArg *Arg= (ConcurrentStmtArg *)arg;
+
+  Arg->Failed= ConcurrentStmtRun(Arg);
+
+  return NULL;
+}
+#endif
+
+ODBC_TEST(t_concurrent_statements)
+{
+  ConcurrentStmtArg Arg[CONCURRENT_STMT_THREADS];
+#ifdef _WIN32
+  HANDLE            Thread[CONCURRENT_STMT_THREADS];
+#else
+  pthread_t         Thread[CONCURRENT_STMT_THREADS];
+#endif
+  SQLINTEGER        Rows= 0;
+  SQLRETURN         rc= SQL_ERROR;
+  int               i, Started, TimedOut= 0;
+
+  for (i= 0; i < CONCURRENT_STMT_THREADS; ++i)
+  {
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &Arg[i].Hstmt));
+    Arg[i].Id=     i + 1;
+    Arg[i].Failed= 1;
+  }
+
+  /* Nothing may return from the test before the started threads are joined */
+  for (Started= 0; Started < CONCURRENT_STMT_THREADS; ++Started)
+  {
+#ifdef _WIN32
+    if ((Thread[Started]= CreateThread(NULL, 0, ConcurrentStmtThread, &Arg[Started], 0, NULL)) == NULL)
+#else
+    if (pthread_create(&Thread[Started], NULL, ConcurrentStmtThread, &Arg[Started]) != 0)
+#endif
+    {
+      break;
+    }
+  }
+
+  /* Meanwhile the main thread streams the result on its own statement */
+  if (Started == CONCURRENT_STMT_THREADS &&
+      SQL_SUCCEEDED(rc= SQLExecDirect(Stmt, (SQLCHAR*)"SELECT REPEAT('a', 1024) FROM information_schema.columns LIMIT 500",
+                                      SQL_NTS)))
+  {
+    while (SQLFetch(Stmt) == SQL_SUCCESS)
+    {
+      ++Rows;
+    }
+    rc= SQLFreeStmt(Stmt, SQL_CLOSE);
+  }
+
+  for (i= 0; i < Started; ++i)
+  {
+#ifdef _WIN32
+    TimedOut|= WaitForSingleObject(Thread[i], 60000) == WAIT_TIMEOUT;
+    CloseHandle(Thread[i]);
+#else
+    pthread_join(Thread[i], NULL);
+#endif
+  }
+
+  FAIL_IF(Started < CONCURRENT_STMT_THREADS, "Could not create the thread");
+  FAIL_IF(TimedOut, "The thread has not finished in time");
+  CHECK_STMT_RC(Stmt, rc);
+  FAIL_IF(Rows == 0, "Expected the result to be fetched");
+  for (i= 0; i < CONCURRENT_STMT_THREADS; ++i)
+  {
+    is_num(Arg[i].Failed, 0);
+    CHECK_STMT_RC(Arg[i].Hstmt, SQLFreeHandle(SQL_HANDLE_STMT, Arg[i].Hstmt));
+  }
+
+  return OK;
+}
+
 
 MA_ODBC_TESTS my_tests[]=
 {
@@ -1713,6 +1919,8 @@ MA_ODBC_TESTS my_tests[]=
   {setnames,       "setnames",       NORMAL, ALL_DRIVERS},
   {setnames_conn,  "setnames_conn",  NORMAL, ALL_DRIVERS},
   {sqlcancel,      "sqlcancel",      NORMAL, ALL_DRIVERS},
+  {sqlcancel_reuse_control, "sqlcancel_reuse_control", NORMAL, ALL_DRIVERS},
+  {t_query_timeout, "t_query_timeout", NORMAL, ALL_DRIVERS},
   {t_bug32014,     "t_bug32014",     NORMAL, ALL_DRIVERS},
   {t_bug10128,     "t_bug10128",     NORMAL, ALL_DRIVERS},
   {t_bug32727,     "t_bug32727",     NORMAL, ALL_DRIVERS},
@@ -1734,6 +1942,7 @@ MA_ODBC_TESTS my_tests[]=
   {t_odbc162,     "t_odbc162_CTE_query",      NORMAL , ALL_DRIVERS},
   {t_replace,     "t_replace",      NORMAL , ALL_DRIVERS},
   {t_odbc181,     "t_odbc181",      NORMAL , ALL_DRIVERS},
+  {t_concurrent_statements, "t_concurrent_statements", NORMAL, ALL_DRIVERS},
   {NULL, NULL, 0, ALL_DRIVERS}
 };
 
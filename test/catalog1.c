@@ -645,6 +645,35 @@ ODBC_TEST(t_current_catalog_ansi)
 }
 
 
+ODBC_TEST(t_current_catalog_use)
+{
+  SQLCHAR    db[255];
+  SQLINTEGER len;
+
+  OK_SIMPLE_STMT(Stmt, "DROP DATABASE IF EXISTS test_odbc_current_use");
+  OK_SIMPLE_STMT(Stmt, "CREATE DATABASE test_odbc_current_use");
+
+  /* Current database changed by the statement is seen without application telling the driver */
+  OK_SIMPLE_STMT(Stmt, "USE test_odbc_current_use");
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  CHECK_DBC_RC(Connection, SQLGetConnectAttr(Connection, SQL_ATTR_CURRENT_CATALOG, db, sizeof(db), &len));
+  is_num(len, strlen("test_odbc_current_use"));
+  IS_STR(db, "test_odbc_current_use", len + 1);
+
+  OK_SIMPLE_STMT(Stmt, "DROP DATABASE test_odbc_current_use");
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  CHECK_DBC_RC(Connection, SQLGetConnectAttr(Connection, SQL_ATTR_CURRENT_CATALOG, db, sizeof(db), &len));
+  IS_STR(db, "null", 5);
+
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_CURRENT_CATALOG, (SQLCHAR *)my_schema, SQL_NTS));
+  CHECK_DBC_RC(Connection, SQLGetConnectAttr(Connection, SQL_ATTR_CURRENT_CATALOG, db, sizeof(db), &len));
+  is_num(len, strlen(my_schema));
+  IS_STR(db, my_schema, len);
+
+  return OK;
+}
+
+
 ODBC_TEST(tmysql_showkeys)
 {
   SQLRETURN rc;
@@ -1371,6 +1400,7 @@ MA_ODBC_TESTS my_tests[]=
   {t_tables_bug,"t_tables_bug", NORMAL, ANSI_DRIVER},
   {t_current_catalog_unicode, "t_current_catalog_unicode", NORMAL, ALL_DRIVERS},
   {t_current_catalog_ansi, "t_current_catalog_ansi", NORMAL, ALL_DRIVERS},
+  {t_current_catalog_use, "t_current_catalog_use", NORMAL, ALL_DRIVERS},
   {tmysql_showkeys, "tmysql_showkeys", CSPS_OK | SSPS_FAIL},
   {t_sqltables, "t_sqltables", NORMAL, ALL_DRIVERS},
   {my_information_schema, "my_information_schema", NORMAL, ALL_DRIVERS},
@@ -1370,6 +1370,70 @@ ODBC_TEST(client_side_ipd)
 }
 
 
+#define CS_LARGE_ROWS  3
+#define CS_LARGE_VALUE (1024 * 1024)
+
+/* Static, so that failing checks, that return right away, don't leak them */
+static SQLCHAR LargeValues[CS_LARGE_ROWS * CS_LARGE_VALUE], LargeQuery[CS_LARGE_VALUE + 64];
+
+ODBC_TEST(client_side_large_query)
+{
+    const SQLULEN RowCount = CS_LARGE_ROWS;
+    const SQLLEN ValueLen = CS_LARGE_VALUE;
+    SQLCHAR *Values = LargeValues, *Query = LargeQuery, Substr[8], Buffer[1024];
+    SQLLEN Lengths[3];
+    SQLINTEGER Id[3] = {1, 2, 3};
+    SQLULEN i;
+
+    /* Parameters of the megabyte each, with a character to escape. The query buffer is reused for the next, shorter,
+       parameter set */
+    for (i = 0; i < RowCount; ++i)
+    {
+        memset(Values + i * ValueLen, 'a' + (int)i, ValueLen);
+        Values[i * ValueLen + 100] = '\'';
+        Lengths[i] = ValueLen - i * 1000;
+    }
+
+    OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS cs_large_query");
+    OK_SIMPLE_STMT(Stmt, "CREATE TABLE cs_large_query(id INT, val LONGTEXT)");
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)RowCount, 0));
+    CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, Id, 0, NULL));
+    CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_LONGVARCHAR, ValueLen, 0, Values,
+                                         ValueLen, Lengths));
+    CHECK_STMT_RC(Stmt, SQLPrepare(Stmt, (SQLCHAR *) "INSERT INTO cs_large_query VALUES(?, {fn CONCAT(?, 'x')})", SQL_NTS));
+    CHECK_STMT_RC(Stmt, SQLExecute(Stmt));
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0));
+
+    OK_SIMPLE_STMT(Stmt, "SELECT id, LENGTH(val), SUBSTRING(val, 100, 3) FROM cs_large_query ORDER BY id");
+    for (i = 0; i < RowCount; ++i)
+    {
+        CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+        is_num(my_fetch_int(Stmt, 1), Id[i]);
+        is_num(my_fetch_int(Stmt, 2), Lengths[i] + 1);
+        sprintf((char *)Substr, "%c'%c", 'a' + (int)i, 'a' + (int)i);
+        IS_STR(my_fetch_str(Stmt, Buffer, 3), Substr, 4);
+    }
+    EXPECT_STMT(Stmt, SQLFetch(Stmt), SQL_NO_DATA);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    /* Big query text, that goes through the escape sequences processing */
+    strcpy((char *)Query, "SELECT {fn LENGTH('");
+    memset(Query + strlen((char *)Query), 'z', ValueLen);
+    strcpy((char *)Query + strlen("SELECT {fn LENGTH('") + ValueLen, "')}");
+    OK_SIMPLE_STMT(Stmt, Query);
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(my_fetch_int(Stmt, 1), ValueLen);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS cs_large_query");
+
+    return OK;
+}
+
+
 MA_ODBC_TESTS my_tests[] =
 {
     {client_side_show,                      "client_side_show", CSPS_OK | SSPS_FAIL, ALL_DRIVERS},
@@ -1391,6 +1455,7 @@ MA_ODBC_TESTS my_tests[] =
     {client_side_set_pos_del_multiple_rows, "client_side_set_pos_del_multiple_rows", NORMAL, ALL_DRIVERS},
     {client_side_multistatements,           "client_side_multistatements", NORMAL, ALL_DRIVERS},
     {client_side_ipd, "client_side_ipd", NORMAL, ALL_DRIVERS},
+    {client_side_large_query, "client_side_large_query", NORMAL, ALL_DRIVERS},
     {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 
@@ -20,11 +20,17 @@
 #include "tap.h"
 #include "stdio.h"
 #include <wchar.h>
+#include "ma_allocator.h"
 #if !defined(_WIN32) && !defined(__APPLE__)
 #include <glib.h>
 #include <libsecret/secret.h>
 #endif
 
+#ifndef SQL_ATTR_RESET_CONNECTION
+# define SQL_ATTR_RESET_CONNECTION 116
+# define SQL_RESET_CONNECTION_YES  1UL
+#endif
+
 ODBC_TEST(basic_connect) {
   HSTMT hdbc;
 
@@ -2022,6 +2028,310 @@ ODBC_TEST(driver_connect_browser_sso) {
 // TODO: test NamedPipe parameter and NamedPipe bit in options (has effect only on Windows)
 // TODO: test GUI prompts for Windows and Mac
 
+ODBC_TEST(driver_connect_session_setup) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLCHAR conn[1024];
+
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+  /* Attributes set before connect are applied by the session setup right after the handshake */
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  CHECK_DBC_RC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+
+  CHECK_DBC_RC(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SELECT @@autocommit, @@sql_auto_is_null");
+  CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 0);
+  is_num(my_fetch_int(hstmt, 2), 0);
+  CHECK_STMT_RC(hstmt, SQLFreeHandle(SQL_HANDLE_STMT, hstmt));
+
+  CHECK_DBC_RC(hdbc, SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_COMMIT));
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+  return OK;
+}
+
+ODBC_TEST(driver_connect_reset) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLCHAR conn[1024], buffer[128];
+  SQLULEN autocommit= 0;
+  SQLUINTEGER mode= 0;
+
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;READ_SERVER=%s;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema, my_servername);
+  CHECK_DBC_RC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+
+  if (WindowsDM(hdbc))
+  {
+    CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+    CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+    skip("Windows DM does not let application reset the connection");
+  }
+
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_ONLY, 0));
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  CHECK_DBC_RC(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SET @driver_connect_reset=1");
+  OK_SIMPLE_STMT(hstmt, "SELECT @driver_connect_reset");
+  CHECK_STMT_RC(hstmt, SQLFreeHandle(SQL_HANDLE_STMT, hstmt));
+
+  /* Same as DM does for the connection returned to the pool - session state is dropped, attributes get defaults */
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_RESET_CONNECTION, (SQLPOINTER)SQL_RESET_CONNECTION_YES, 0));
+
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, &autocommit, 0, NULL));
+  is_num(autocommit, SQL_AUTOCOMMIT_ON);
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, &mode, 0, NULL));
+  is_num(mode, SQL_MODE_READ_WRITE);
+
+  CHECK_DBC_RC(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SELECT @driver_connect_reset IS NULL, @@autocommit, DATABASE()");
+  CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 1);
+  is_num(my_fetch_int(hstmt, 2), 1);
+  IS_STR(my_fetch_str(hstmt, buffer, 3), my_schema, strlen((char *)my_schema) + 1);
+  CHECK_STMT_RC(hstmt, SQLFreeHandle(SQL_HANDLE_STMT, hstmt));
+
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+  return OK;
+}
+
+ODBC_TEST(driver_connect_server_info_cache) {
+  HDBC hdbc;
+  SQLCHAR conn[1024], version[3][64];
+  unsigned int i, ttl[]= {60, 60, 0};
+
+  /* The first two connections share the server info via the cache, the last one discovers it itself */
+  for (i= 0; i < sizeof(ttl)/sizeof(ttl[0]); ++i)
+  {
+    CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+    sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;SERVER_INFO_TTL=%u;",
+            my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema, ttl[i]);
+    CHECK_DBC_RC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+    CHECK_DBC_RC(hdbc, SQLGetInfo(hdbc, SQL_DBMS_VER, version[i], sizeof(version[i]), NULL));
+    CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+    CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+  }
+  IS_STR(version[0], version[1], strlen((char *)version[0]) + 1);
+  IS_STR(version[0], version[2], strlen((char *)version[0]) + 1);
+
+  return OK;
+}
+
+ODBC_TEST(driver_connect_async) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLCHAR conn[1024];
+  SQLUINTEGER capable= 0, enabled= 0;
+  SQLRETURN rc;
+  int polls= 0;
+
+  CHECK_DBC_RC(Connection, SQLGetInfo(Connection, SQL_ASYNC_DBC_FUNCTIONS, &capable, 0, NULL));
+  if (capable == SQL_ASYNC_DBC_NOT_CAPABLE)
+  {
+    skip("Asynchronous connecting is not supported by this build of the driver");
+  }
+  is_num(capable, SQL_ASYNC_DBC_CAPABLE);
+
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE, (SQLPOINTER)SQL_ASYNC_DBC_ENABLE_ON, 0));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE, &enabled, 0, NULL));
+  is_num(enabled, SQL_ASYNC_DBC_ENABLE_ON);
+
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  while ((rc= SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)) == SQL_STILL_EXECUTING)
+  {
+    ++polls;
+  }
+  CHECK_DBC_RC(hdbc, rc);
+  FAIL_IF(polls == 0, "Expected connection to be established asynchronously");
+
+  CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SELECT 1");
+  CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 1);
+  CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+
+  /* Failed connect has to end with the error, and leave the handle usable */
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s_wrong;SERVER=%s;PORT=%u;DB=%s;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  while ((rc= SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)) == SQL_STILL_EXECUTING);
+  is_num(rc, SQL_ERROR);
+
+  while ((rc= SQLConnect(hdbc, my_dsn, SQL_NTS, my_uid, SQL_NTS, my_pwd, SQL_NTS)) == SQL_STILL_EXECUTING);
+  CHECK_DBC_RC(hdbc, rc);
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+
+  return OK;
+}
+
+ODBC_TEST(driver_connect_multihost) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLCHAR conn[1024];
+  const char *Strategy[]= {"SEQUENTIAL", "RANDOM", "ROUNDROBIN", "RACE", "LATENCY"};
+  unsigned int i, j;
+
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+
+  /* Port 1 refuses connection, and the next host has to be tried. After few failures port 1 is avoided, and tried
+     last - connection still has to succeed */
+  for (i= 0; i < sizeof(Strategy)/sizeof(Strategy[0]); ++i)
+  {
+    for (j= 0; j < 3; ++j)
+    {
+      sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=127.0.0.1:1,%s:%u;PORT=%u;DB=%s;HOST_STRATEGY=%s;RACE_DELAY=50;",
+              my_drivername, my_uid, my_pwd, my_servername, my_port, my_port, my_schema, Strategy[i]);
+      CHECK_DBC_RC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+
+      CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+      OK_SIMPLE_STMT(hstmt, "SELECT 1");
+      CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+      is_num(my_fetch_int(hstmt, 1), 1);
+      CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+      CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+    }
+  }
+
+  /* Wrong password is not the reason to try other hosts, and its error has to be returned */
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s_wrong;SERVER=%s:%u,127.0.0.1:1;DB=%s;HOST_STRATEGY=RACE;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  EXPECT_DBC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT), SQL_ERROR);
+  CHECK_SQLSTATE_EX(hdbc, SQL_HANDLE_DBC, "28000");
+
+  /* None of hosts is reachable */
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=127.0.0.1:1,127.0.0.1:2;DB=%s;HOST_STRATEGY=RACE;",
+          my_drivername, my_uid, my_pwd, my_schema);
+  EXPECT_DBC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT), SQL_ERROR);
+
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;HOST_STRATEGY=FASTEST;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  EXPECT_DBC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT), SQL_ERROR);
+  CHECK_SQLSTATE_EX(hdbc, SQL_HANDLE_DBC, "HY000");
+
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;PARSE_CACHE=-1;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  EXPECT_DBC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT), SQL_ERROR);
+  CHECK_SQLSTATE_EX(hdbc, SQL_HANDLE_DBC, "HY000");
+
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+
+  return OK;
+}
+
+ODBC_TEST(driver_connect_read_server) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLCHAR conn[1024];
+  SQLUINTEGER mode= 0;
+  unsigned int i;
+  /* Test has one server only - it plays both roles. Unreachable read host has to fall back to the SERVER */
+  const char *ReadServer[]= {(const char *)my_servername, "127.0.0.1:1"};
+
+  for (i= 0; i < sizeof(ReadServer)/sizeof(ReadServer[0]); ++i)
+  {
+    CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+    CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_ONLY, 0));
+
+    sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;READ_SERVER=%s;",
+            my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema, ReadServer[i]);
+    CHECK_DBC_RC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+    CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, &mode, 0, NULL));
+    is_num(mode, SQL_MODE_READ_ONLY);
+
+    /* Switch is possible, while no statement is prepared */
+    CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+    CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_WRITE, 0));
+    CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, &mode, 0, NULL));
+    is_num(mode, SQL_MODE_READ_WRITE);
+
+    OK_SIMPLE_STMT(hstmt, "SELECT DATABASE()");
+    CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+    IS_STR(my_fetch_str(hstmt, conn, 1), my_schema, strlen((const char *)my_schema) + 1);
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    EXPECT_DBC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_ONLY, 0), SQL_ERROR);
+    CHECK_SQLSTATE_EX(hdbc, SQL_HANDLE_DBC, "HY011");
+    CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, &mode, 0, NULL));
+    is_num(mode, SQL_MODE_READ_WRITE);
+
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+    CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_ONLY, 0));
+
+    CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+    OK_SIMPLE_STMT(hstmt, "SELECT 1");
+    CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+    is_num(my_fetch_int(hstmt, 1), 1);
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+
+    CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+    CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+  }
+
+  /* Without read hosts the mode falls back to read-write, and the application is told about that */
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, (SQLPOINTER)SQL_MODE_READ_ONLY, 0));
+  sprintf((char *) conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;",
+          my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema);
+  EXPECT_DBC(hdbc, SQLDriverConnect(hdbc, NULL, conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT),
+             SQL_SUCCESS_WITH_INFO);
+  CHECK_SQLSTATE_EX(hdbc, SQL_HANDLE_DBC, "01S02");
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, SQL_ATTR_ACCESS_MODE, &mode, 0, NULL));
+  is_num(mode, SQL_MODE_READ_WRITE);
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+
+  return OK;
+}
+
+ODBC_TEST(driver_connect_memory_accounting) {
+  HDBC hdbc;
+  HSTMT hstmt;
+  SQLULEN enabled= 0, allocations= 0, frees= 0, bytes= 0;
+
+  CHECK_ENV_RC(Env, SQLAllocConnect(Env, &hdbc));
+  CHECK_DBC_RC(hdbc, SQLConnect(hdbc, my_dsn, SQL_NTS, my_uid, SQL_NTS, my_pwd, SQL_NTS));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_ACCOUNTING, &enabled, 0, NULL));
+  is_num(enabled, SQL_FALSE);
+
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, MADB_ATTR_MEMORY_ACCOUNTING, (SQLPOINTER)SQL_TRUE, 0));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_ACCOUNTING, &enabled, 0, NULL));
+  is_num(enabled, SQL_TRUE);
+
+  CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SELECT 1, 'abc'");
+  CHECK_STMT_RC(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 1);
+  CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_ALLOCATIONS, &allocations, 0, NULL));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_FREES, &frees, 0, NULL));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_BYTES, &bytes, 0, NULL));
+  FAIL_IF(allocations == 0, "Expected allocations to be counted");
+  FAIL_IF(frees == 0, "Expected frees to be counted");
+  FAIL_IF(bytes < allocations, "Expected allocated bytes to be counted");
+
+  /* Setting of the attribute resets counters, and switching it off stops counting */
+  CHECK_DBC_RC(hdbc, SQLSetConnectAttr(hdbc, MADB_ATTR_MEMORY_ACCOUNTING, (SQLPOINTER)SQL_FALSE, 0));
+  CHECK_DBC_RC(hdbc, SQLAllocStmt(hdbc, &hstmt));
+  OK_SIMPLE_STMT(hstmt, "SELECT 1");
+  CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_DROP));
+  CHECK_DBC_RC(hdbc, SQLGetConnectAttr(hdbc, MADB_ATTR_MEMORY_ALLOCATIONS, &allocations, 0, NULL));
+  is_num(allocations, 0);
+
+  CHECK_DBC_RC(hdbc, SQLDisconnect(hdbc));
+  CHECK_DBC_RC(hdbc, SQLFreeConnect(hdbc));
+
+  return OK;
+}
+
 MA_ODBC_TESTS my_tests[]=
 {
   {basic_connect, "basic_connect",     NORMAL, ALL_DRIVERS},
@@ -2045,6 +2355,13 @@ MA_ODBC_TESTS my_tests[]=
   {driver_connect_no_cache_w, "driver_connect_no_cache_w", NORMAL, UNICODE_DRIVER},
   {driver_connect_jwt, "driver_connect_jwt", NORMAL, ALL_DRIVERS},
   {driver_connect_browser_sso, "driver_connect_browser_sso", NORMAL, ALL_DRIVERS},
+  {driver_connect_session_setup, "driver_connect_session_setup", NORMAL, ALL_DRIVERS},
+  {driver_connect_reset, "driver_connect_reset", NORMAL, ALL_DRIVERS},
+  {driver_connect_server_info_cache, "driver_connect_server_info_cache", NORMAL, ALL_DRIVERS},
+  {driver_connect_async, "driver_connect_async", NORMAL, ALL_DRIVERS},
+  {driver_connect_multihost, "driver_connect_multihost", NORMAL, ALL_DRIVERS},
+  {driver_connect_read_server, "driver_connect_read_server", NORMAL, ALL_DRIVERS},
+  {driver_connect_memory_accounting, "driver_connect_memory_accounting", NORMAL, ALL_DRIVERS},
   {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 
@@ -561,6 +561,62 @@ ODBC_TEST(t_free_stmt_with_exp_desc)
 }
 
 
+/* Dropped statement objects are reused by the connection. Handle, allocated next, must look like a brand new one */
+ODBC_TEST(t_recycled_stmt_defaults)
+{
+  SQLHANDLE   hstmt1, expard, ard, apd, ird;
+  SQLINTEGER  param= 7, result= 0, count;
+  SQLULEN     size;
+  SQLSMALLINT columns;
+  int         i;
+
+  CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_DESC, Connection, &expard));
+
+  for (i= 0; i < 3; ++i)
+  {
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &hstmt1));
+
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_APP_ROW_DESC, &ard, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_APP_PARAM_DESC, &apd, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_IMP_ROW_DESC, &ird, 0, NULL));
+    FAIL_IF(ard == expard, "Explicit descriptor should not be set for the new handle");
+
+    CHECK_DESC_RC(ard, SQLGetDescField(ard, 0, SQL_DESC_COUNT, &count, SQL_IS_INTEGER, NULL));
+    is_num(count, 0);
+    CHECK_DESC_RC(apd, SQLGetDescField(apd, 0, SQL_DESC_COUNT, &count, SQL_IS_INTEGER, NULL));
+    is_num(count, 0);
+    CHECK_DESC_RC(ird, SQLGetDescField(ird, 0, SQL_DESC_COUNT, &count, SQL_IS_INTEGER, NULL));
+    is_num(count, 0);
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, &size, 0, NULL));
+    is_num(size, 1);
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE, &size, 0, NULL));
+    is_num(size, 1);
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_MAX_ROWS, &size, 0, NULL));
+    is_num(size, 0);
+
+    /* Leave as much as possible behind for the next handle */
+    if (i == 1)
+    {
+      CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_APP_ROW_DESC, expard, 0));
+    }
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_MAX_ROWS, (SQLPOINTER)5, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &param, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, &result, 0, NULL));
+    OK_SIMPLE_STMT(hstmt1, "SELECT ? + 1, 'abc'");
+    CHECK_STMT_RC(hstmt1, SQLNumResultCols(hstmt1, &columns));
+    is_num(columns, 2);
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(result, param + 1);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  }
+
+  CHECK_DESC_RC(expard, SQLFreeHandle(SQL_HANDLE_DESC, expard));
+
+  return OK;
+}
+
+
 /*
   Bug #41081, Unable to retreive null SQL_NUMERIC with ADO.
   It's setting SQL_DESC_PRECISION after SQLBindCol(). We were
@@ -972,6 +1028,7 @@ MA_ODBC_TESTS my_tests[]=
   {t_mult_stmt_free, "t_mult_stmt_free", ALL_DRIVERS},
   {t_set_null_use_implicit, "t_set_null_use_implicit", ALL_DRIVERS},
   {t_free_stmt_with_exp_desc, "t_free_stmt_with_exp_desc", ALL_DRIVERS},
+  {t_recycled_stmt_defaults, "t_recycled_stmt_defaults", ALL_DRIVERS},
   {t_bug41081,"t_bug41081", ALL_DRIVERS},
   {t_bug44576, "t_bug44576", ALL_DRIVERS},
   {t_desc_curcatalog, "t_desc_curcatalog", ALL_DRIVERS},
@@ -378,6 +378,7 @@ ODBC_TEST(getdata_need_nullind)
 ODBC_TEST(t_handle_err)
 {
   SQLHANDLE henv1, Connection1;
+  SQLUINTEGER AsyncMode;
 
   CHECK_ENV_RC(henv1, SQLAllocHandle(SQL_HANDLE_ENV, NULL, &henv1));
   CHECK_ENV_RC(henv1, SQLSetEnvAttr(henv1, SQL_ATTR_ODBC_VERSION,
@@ -392,10 +393,21 @@ ODBC_TEST(t_handle_err)
                                   (SQLPOINTER)SQL_OV_ODBC3, 0)!= SQL_ERROR, "Error expected");
   CHECK_SQLSTATE_EX(henv1, SQL_HANDLE_ENV, "HY010");
 
-  FAIL_IF(SQLSetConnectAttr(Connection1, SQL_ATTR_ASYNC_ENABLE,
-                                      (SQLPOINTER)SQL_ASYNC_ENABLE_ON,
-                                      SQL_IS_INTEGER) != SQL_SUCCESS_WITH_INFO, "swi expected");
-  CHECK_SQLSTATE_EX(Connection1, SQL_HANDLE_DBC, "01S02");
+  /* Asynchronous execution is not available, if the driver is linked against shared Connector/C library */
+  CHECK_DBC_RC(Connection1, SQLGetInfo(Connection1, SQL_ASYNC_MODE, &AsyncMode, 0, NULL));
+  if (AsyncMode == SQL_AM_NONE)
+  {
+    FAIL_IF(SQLSetConnectAttr(Connection1, SQL_ATTR_ASYNC_ENABLE,
+                                        (SQLPOINTER)SQL_ASYNC_ENABLE_ON,
+                                        SQL_IS_INTEGER) != SQL_SUCCESS_WITH_INFO, "swi expected");
+    CHECK_SQLSTATE_EX(Connection1, SQL_HANDLE_DBC, "01S02");
+  }
+  else
+  {
+    CHECK_DBC_RC(Connection1, SQLSetConnectAttr(Connection1, SQL_ATTR_ASYNC_ENABLE,
+                                        (SQLPOINTER)SQL_ASYNC_ENABLE_ON,
+                                        SQL_IS_INTEGER));
+  }
 
   CHECK_DBC_RC(Connection1, SQLDisconnect(Connection1));
   CHECK_DBC_RC(Connection1, SQLFreeHandle(SQL_HANDLE_DBC, Connection1));
@@ -1124,6 +1124,41 @@ ODBC_TEST(decimal_conversion)
 }
 #undef BUFF_SIZE
 
+#define ESCAPE_COUNT 500
+#define ESCAPE " + {fn ABS({fn LENGTH({fn CONCAT('a', {fn LCASE('B')})})})} + {fn YEAR({d '2001-10-1'})}"
+#define WRONG_ESCAPE " + {fn CONVERT(1, )}"
+ODBC_TEST(many_escape_sequences)
+{
+  /* Static, not to leak on the early return of failed checks */
+  static char query[sizeof("SELECT 0") + ESCAPE_COUNT * (sizeof(ESCAPE) - 1) + sizeof(WRONG_ESCAPE) - 1];
+  char *end;
+  int i;
+
+  strcpy(query, "SELECT 0");
+  end = query + strlen(query);
+  for (i = 0; i < ESCAPE_COUNT; i++)
+  {
+    memcpy(end, ESCAPE, sizeof(ESCAPE));
+    end += sizeof(ESCAPE) - 1;
+  }
+
+  OK_SIMPLE_STMT(Stmt, query);
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), ESCAPE_COUNT * (2 + 2001));
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  // Error in the last escape sequence after many correct ones
+  memcpy(end, WRONG_ESCAPE, sizeof(WRONG_ESCAPE));
+  EXPECT_STMT(Stmt, SQLExecDirect(Stmt, (SQLCHAR*)query, SQL_NTS), SQL_ERROR);
+  CHECK_SQLSTATE(Stmt, "42000");
+
+  return OK;
+}
+#undef WRONG_ESCAPE
+#undef ESCAPE
+#undef ESCAPE_COUNT
+
+
 MA_ODBC_TESTS my_tests[]=
 {
   {date_literal, "date_literal", NORMAL, ALL_DRIVERS},
@@ -1152,6 +1187,7 @@ MA_ODBC_TESTS my_tests[]=
   {sql_native_sql_buffers_unicode, "sql_native_sql_buffers_unicode", NORMAL, ALL_DRIVERS},
   {sql_native_sql_errors, "sql_native_sql_errors", NORMAL, ALL_DRIVERS},
   {decimal_conversion, "decimal_conversion", NORMAL, ALL_DRIVERS},
+  {many_escape_sequences, "many_escape_sequences", NORMAL, ALL_DRIVERS},
   {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 
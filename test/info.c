@@ -50,7 +50,7 @@ ODBC_TEST(sqlgetinfo)
                           sizeof(rgbValue), &pcbInfo));
 
   is_num(pcbInfo, 5);
-  IS_STR(rgbValue, "03.51", 5);
+  IS_STR(rgbValue, "03.80", 5);
 
   CHECK_DBC_RC(Connection, SQLGetInfo(Connection, SQL_DBMS_VER, rgbValue, sizeof(rgbValue), &pcbInfo));
   FAIL_IF(_stricmp(rgbValue,"05.06.0000") < 0, "DBMS version must be at least 05.06.0000");
@@ -667,6 +667,47 @@ ODBC_TEST(multistatement_ddl)
   return OK;
 }
 
+ODBC_TEST(multistatement_prepared_params)
+{
+  SQLINTEGER a, b, Row;
+  SQLLEN rowCount;
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS ms_prep_params");
+
+  CHECK_STMT_RC(Stmt, SQLPrepare(Stmt, (SQLCHAR*)"CREATE TABLE IF NOT EXISTS ms_prep_params(a INT, b INT);"
+                                                 "INSERT INTO ms_prep_params VALUES (?, ?);"
+                                                 "SELECT a, b FROM ms_prep_params WHERE a=?", SQL_NTS));
+
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 10, 0, &a, 0, NULL));
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 2, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 10, 0, &b, 0, NULL));
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 3, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 10, 0, &a, 0, NULL));
+
+  /* Second execution goes over the statements, that were already prepared */
+  for (Row= 1; Row < 3; ++Row)
+  {
+    a= Row;
+    b= Row * 10;
+    CHECK_STMT_RC(Stmt, SQLExecute(Stmt));
+
+    CHECK_STMT_RC(Stmt, SQLMoreResults(Stmt));
+    CHECK_STMT_RC(Stmt, SQLRowCount(Stmt, &rowCount));
+    is_num(rowCount, 1);
+
+    CHECK_STMT_RC(Stmt, SQLMoreResults(Stmt));
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(my_fetch_int(Stmt, 1), Row);
+    is_num(my_fetch_int(Stmt, 2), Row * 10);
+    EXPECT_STMT(Stmt, SQLFetch(Stmt), SQL_NO_DATA);
+
+    EXPECT_STMT(Stmt, SQLMoreResults(Stmt), SQL_NO_DATA);
+  }
+
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS ms_prep_params");
+
+  return OK;
+}
+
 
 MA_ODBC_TESTS my_tests[]=
 {
@@ -688,6 +729,7 @@ MA_ODBC_TESTS my_tests[]=
   {t_odbc169, "t_odbc169", NORMAL, ALL_DRIVERS},
   {t_odbc219, "t_odbc219", NORMAL, ALL_DRIVERS},
   {multistatement_ddl, "multistatement_ddl", NORMAL, ALL_DRIVERS},
+  {multistatement_prepared_params, "multistatement_prepared_params", NORMAL, ALL_DRIVERS},
   {NULL, NULL}
 };
 
@@ -1335,6 +1335,49 @@ ODBC_TEST(odbc279)
 }
 
 
+/* Direct execution of the parameterized statement - paramsets array, data-at-execution parameter, and not bound parameter */
+ODBC_TEST(direxec_params)
+{
+  SQLINTEGER Ids[3]= {1, 2, 3}, Id= 4;
+  SQLLEN     DaeLen= SQL_LEN_DATA_AT_EXEC(0);
+  SQLPOINTER Token;
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_direxec_params");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_direxec_params(id INT, val VARCHAR(16))");
+
+  CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)3, 0));
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, Ids, 0, NULL));
+  OK_SIMPLE_STMT(Stmt, "INSERT INTO t_direxec_params(id, val) VALUES(?, 'array')");
+  CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0));
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &Id, 0, NULL));
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, 16, 0, (SQLPOINTER)2, 0, &DaeLen));
+  EXPECT_STMT(Stmt, SQLExecDirect(Stmt, (SQLCHAR *)"INSERT INTO t_direxec_params(id, val) VALUES(?, ?)", SQL_NTS), SQL_NEED_DATA);
+  EXPECT_STMT(Stmt, SQLParamData(Stmt, &Token), SQL_NEED_DATA);
+  is_num((SQLLEN)Token, 2);
+  CHECK_STMT_RC(Stmt, SQLPutData(Stmt, "dae", 3));
+  CHECK_STMT_RC(Stmt, SQLParamData(Stmt, &Token));
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+
+  /* 2nd parameter is not bound */
+  CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &Id, 0, NULL));
+  EXPECT_STMT(Stmt, SQLExecDirect(Stmt, (SQLCHAR *)"SELECT id FROM t_direxec_params WHERE id=? OR id=?", SQL_NTS), SQL_ERROR);
+  CHECK_SQLSTATE(Stmt, "07002");
+
+  OK_SIMPLE_STMT(Stmt, "SELECT COUNT(*), SUM(id) FROM t_direxec_params WHERE val='array' OR id=? AND val='dae'");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), 4);
+  is_num(my_fetch_int(Stmt, 2), 10);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE t_direxec_params");
+
+  return OK;
+}
+
+
 MA_ODBC_TESTS my_tests[]=
 {
   {unbuffered_result, "unbuffered_result", NORMAL, ALL_DRIVERS},
@@ -1360,6 +1403,7 @@ MA_ODBC_TESTS my_tests[]=
   {timestruct_param, "timestruct_param-seconds", NORMAL, ALL_DRIVERS},
   {consequent_direxec, "consequent_direxec", NORMAL, ALL_DRIVERS},
   {odbc279, "odbc-279-timestruct", NORMAL, ALL_DRIVERS},
+  {direxec_params, "direxec_params", NORMAL, ALL_DRIVERS},
   {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 
@@ -1227,6 +1227,146 @@ ODBC_TEST(t_odbc141)
 }
 
 
+/* Same query text is prepared repeatedly, and by different handles - results must not depend on whether parse
+   result was taken from the connection's cache */
+ODBC_TEST(t_parse_cache)
+{
+  SQLHSTMT Stmt1;
+  SQLINTEGER i, param, value;
+  SQLCHAR buffer[16];
+  SQLCHAR *Query= (SQLCHAR *)"SELECT ? + {fn ABS(-1)}, 'a;b' FROM DUAL WHERE ? > 0";
+
+  CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &Stmt1));
+
+  for (i= 0; i < 5; ++i)
+  {
+    SQLHSTMT Handle= i % 2 ? Stmt1 : Stmt;
+
+    param= i;
+    CHECK_STMT_RC(Handle, SQLPrepare(Handle, Query, SQL_NTS));
+    CHECK_STMT_RC(Handle, SQLBindParameter(Handle, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &param, 0, NULL));
+    CHECK_STMT_RC(Handle, SQLBindParameter(Handle, 2, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &param, 0, NULL));
+    CHECK_STMT_RC(Handle, SQLExecute(Handle));
+
+    if (i == 0)
+    {
+      EXPECT_STMT(Handle, SQLFetch(Handle), SQL_NO_DATA);
+    }
+    else
+    {
+      CHECK_STMT_RC(Handle, SQLFetch(Handle));
+      CHECK_STMT_RC(Handle, SQLGetData(Handle, 1, SQL_C_LONG, &value, 0, NULL));
+      is_num(value, i + 1);
+      IS_STR(my_fetch_str(Handle, buffer, 2), "a;b", 4);
+    }
+    CHECK_STMT_RC(Handle, SQLFreeStmt(Handle, SQL_CLOSE));
+    CHECK_STMT_RC(Handle, SQLFreeStmt(Handle, SQL_RESET_PARAMS));
+  }
+
+  /* Cached text with the different result set and the bad escape are not affected */
+  OK_SIMPLE_STMT(Stmt1, "SELECT 1 UNION SELECT 2 ORDER BY 1 DESC");
+  CHECK_STMT_RC(Stmt1, SQLFetch(Stmt1));
+  is_num(my_fetch_int(Stmt1, 1), 2);
+  CHECK_STMT_RC(Stmt1, SQLFreeStmt(Stmt1, SQL_CLOSE));
+  for (i= 0; i < 2; ++i)
+  {
+    EXPECT_STMT(Stmt1, SQLPrepare(Stmt1, (SQLCHAR *)"SELECT {fn ABS(}", SQL_NTS), SQL_ERROR);
+    CHECK_SQLSTATE(Stmt1, "42000");
+  }
+
+  CHECK_STMT_RC(Stmt1, SQLFreeHandle(SQL_HANDLE_STMT, Stmt1));
+
+  return OK;
+}
+
+
+/* ORM-like pattern - handle is allocated, the query is prepared, executed and the handle is freed. With server-side
+   prepared statements the statement is reused, and the metadata of reused statement has to be correct */
+ODBC_TEST(t_stmt_cache)
+{
+  SQLHSTMT Stmt1;
+  SQLINTEGER i, param, stmt_count;
+  SQLSMALLINT ColumnCount;
+  SQLCHAR ColumnName[64];
+
+  OK_SIMPLE_STMT(Stmt, "SHOW STATUS LIKE 'Prepared_stmt_count'");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  stmt_count= my_fetch_int(Stmt, 2);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  for (i= 0; i < 10; ++i)
+  {
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &Stmt1));
+    CHECK_STMT_RC(Stmt1, SQLPrepare(Stmt1, (SQLCHAR *)"SELECT ? AS stmt_cache_col, 'x' AS other_col", SQL_NTS));
+
+    CHECK_STMT_RC(Stmt1, SQLNumResultCols(Stmt1, &ColumnCount));
+    is_num(ColumnCount, 2);
+    CHECK_STMT_RC(Stmt1, SQLDescribeCol(Stmt1, 1, ColumnName, sizeof(ColumnName), NULL, NULL, NULL, NULL, NULL));
+    IS_STR(ColumnName, "stmt_cache_col", sizeof("stmt_cache_col"));
+
+    param= i;
+    CHECK_STMT_RC(Stmt1, SQLBindParameter(Stmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &param, 0, NULL));
+    CHECK_STMT_RC(Stmt1, SQLExecute(Stmt1));
+    /* Leaving the result not fetched every other time */
+    if (i % 2)
+    {
+      CHECK_STMT_RC(Stmt1, SQLFetch(Stmt1));
+      is_num(my_fetch_int(Stmt1, 1), i);
+    }
+    CHECK_STMT_RC(Stmt1, SQLFreeHandle(SQL_HANDLE_STMT, Stmt1));
+
+    /* Different query in between */
+    CHECK_STMT_RC(Stmt, SQLPrepare(Stmt, (SQLCHAR *)"SELECT 1, 2, 3", SQL_NTS));
+    CHECK_STMT_RC(Stmt, SQLNumResultCols(Stmt, &ColumnCount));
+    is_num(ColumnCount, 3);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  }
+
+  OK_SIMPLE_STMT(Stmt, "SHOW STATUS LIKE 'Prepared_stmt_count'");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  FAIL_IF(my_fetch_int(Stmt, 2) - stmt_count > 2, "Prepared statements are not reused");
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  return OK;
+}
+
+
+/* Statement, cached in one schema, must not be reused after USE has switched to another one, whether the server has
+   reported the change or not */
+ODBC_TEST(t_stmt_cache_schema)
+{
+  SQLHSTMT Stmt1;
+  SQLINTEGER i;
+
+  OK_SIMPLE_STMT(Stmt, "DROP DATABASE IF EXISTS t_stmt_cache_schema");
+  OK_SIMPLE_STMT(Stmt, "CREATE DATABASE t_stmt_cache_schema");
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_stmt_cache_tab");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_stmt_cache_tab(a INT)");
+  OK_SIMPLE_STMT(Stmt, "INSERT INTO t_stmt_cache_tab VALUES(1)");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_stmt_cache_schema.t_stmt_cache_tab(a INT)");
+  OK_SIMPLE_STMT(Stmt, "INSERT INTO t_stmt_cache_schema.t_stmt_cache_tab VALUES(2)");
+
+  for (i= 1; i <= 2; ++i)
+  {
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &Stmt1));
+    CHECK_STMT_RC(Stmt1, SQLPrepare(Stmt1, (SQLCHAR *)"SELECT a FROM t_stmt_cache_tab", SQL_NTS));
+    CHECK_STMT_RC(Stmt1, SQLExecute(Stmt1));
+    CHECK_STMT_RC(Stmt1, SQLFetch(Stmt1));
+    is_num(my_fetch_int(Stmt1, 1), i);
+    CHECK_STMT_RC(Stmt1, SQLFreeHandle(SQL_HANDLE_STMT, Stmt1));
+
+    OK_SIMPLE_STMT(Stmt, "USE t_stmt_cache_schema");
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  }
+
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_CURRENT_CATALOG, (SQLCHAR *)my_schema, SQL_NTS));
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE t_stmt_cache_tab");
+  OK_SIMPLE_STMT(Stmt, "DROP DATABASE t_stmt_cache_schema");
+
+  return OK;
+}
+
+
 MA_ODBC_TESTS my_tests[]=
 {
   {t_prep_basic, "t_prep_basic", NORMAL, ALL_DRIVERS},
@@ -1247,6 +1387,9 @@ MA_ODBC_TESTS my_tests[]=
   {t_bug67702, "t_bug67702", NORMAL, ALL_DRIVERS},
   {t_odbc57, "odbc-57-query_in_parenthesis", NORMAL, ALL_DRIVERS},
   {t_odbc141, "odbc-141-load_data_infile", NORMAL, ALL_DRIVERS},
+  {t_parse_cache, "t_parse_cache", NORMAL, ALL_DRIVERS},
+  {t_stmt_cache, "t_stmt_cache", NORMAL, ALL_DRIVERS},
+  {t_stmt_cache_schema, "t_stmt_cache_schema", NORMAL, ALL_DRIVERS},
   {NULL, NULL}
 };
 
@@ -410,6 +410,7 @@ ODBC_TEST(t_max_rows)
   SQLRETURN rc;
   SQLUINTEGER i;
   SQLSMALLINT cc;
+  SQLLEN rowCount;
 
   OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_max_rows");
   OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_max_rows_rowstore");
@@ -540,12 +541,21 @@ ODBC_TEST(t_max_rows)
     SQLFreeStmt(Stmt,SQL_CLOSE);
   }
 
+  // Queries, that cannot have LIMIT simply appended, are limited by the driver
+  OK_SIMPLE_STMT(Stmt,"select id from t_max_rows union all select id from t_max_rows");
+  IS( 3 == myrowcount(Stmt));
+  SQLFreeStmt(Stmt,SQL_CLOSE);
+  OK_SIMPLE_STMT(Stmt,"select * from (select id from t_max_rows) t order by id -- trailing comment");
+  CHECK_STMT_RC(Stmt, SQLRowCount(Stmt, &rowCount));
+  is_num(3, rowCount);
+  IS( 3 == myrowcount(Stmt));
+  SQLFreeStmt(Stmt,SQL_CLOSE);
+
   // multistatements
-  // TODO PLAT-6212 SQL_ATTR_MAX_ROWS is ignored for multistatements
   OK_SIMPLE_STMT(Stmt,"select * from t_max_rows; select * from t_max_rows;");
-  IS( 10 == myrowcount(Stmt));
+  IS( 3 == myrowcount(Stmt));
   CHECK_STMT_RC(Stmt, SQLMoreResults(Stmt));
-  IS( 10 == myrowcount(Stmt));
+  IS( 3 == myrowcount(Stmt));
   SQLFreeStmt(Stmt,SQL_CLOSE);
 
   rc = SQLSetStmtAttr(Stmt,SQL_ATTR_MAX_ROWS,(SQLPOINTER)0,0);
@@ -567,6 +577,67 @@ ODBC_TEST(t_max_rows)
 }
 
 
+/* Closing the cursor on a big unbuffered result has to neither store the rest of it, nor leave the connection
+   out of sync. The second connection kills the query, once a few kilobytes of the result have been skipped */
+ODBC_TEST(t_close_unread_result)
+{
+  const char *Options[]= {"NO_CACHE=1", "NO_CACHE=1;DRAIN_KILL_SIZE=4096"};
+  SQLCHAR     Conn[1024];
+  SQLHDBC     Hdbc;
+  SQLHSTMT    Hstmt;
+  unsigned int i, Row;
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_close_unread");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_close_unread(a INT, b VARCHAR(256))");
+  for (i= 0; i < 300; ++i)
+  {
+    sprintf((char *)Conn, "INSERT INTO t_close_unread VALUES(%u, REPEAT('x', 200))", i);
+    OK_SIMPLE_STMT(Stmt, Conn);
+  }
+
+  for (i= 0; i < sizeof(Options)/sizeof(Options[0]); ++i)
+  {
+    CHECK_ENV_RC(Env, SQLAllocConnect(Env, &Hdbc));
+    sprintf((char *)Conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;%s",
+            my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema, Options[i]);
+    CHECK_DBC_RC(Hdbc, SQLDriverConnect(Hdbc, NULL, Conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+    CHECK_DBC_RC(Hdbc, SQLAllocHandle(SQL_HANDLE_STMT, Hdbc, &Hstmt));
+
+    /* 90000 rows, ~20MB */
+    OK_SIMPLE_STMT(Hstmt, "SELECT t1.a, t2.b FROM t_close_unread t1, t_close_unread t2");
+    for (Row= 0; Row < 10; ++Row)
+    {
+      CHECK_STMT_RC(Hstmt, SQLFetch(Hstmt));
+    }
+    CHECK_STMT_RC(Hstmt, SQLCloseCursor(Hstmt));
+
+    OK_SIMPLE_STMT(Hstmt, "SELECT 1");
+    CHECK_STMT_RC(Hstmt, SQLFetch(Hstmt));
+    is_num(my_fetch_int(Hstmt, 1), 1);
+    EXPECT_STMT(Hstmt, SQLFetch(Hstmt), SQL_NO_DATA);
+    CHECK_STMT_RC(Hstmt, SQLCloseCursor(Hstmt));
+
+    /* Same with the handle freed without closing the cursor */
+    OK_SIMPLE_STMT(Hstmt, "SELECT t1.a, t2.b FROM t_close_unread t1, t_close_unread t2");
+    CHECK_STMT_RC(Hstmt, SQLFetch(Hstmt));
+    CHECK_STMT_RC(Hstmt, SQLFreeHandle(SQL_HANDLE_STMT, Hstmt));
+
+    CHECK_DBC_RC(Hdbc, SQLAllocHandle(SQL_HANDLE_STMT, Hdbc, &Hstmt));
+    OK_SIMPLE_STMT(Hstmt, "SELECT COUNT(*) FROM t_close_unread");
+    CHECK_STMT_RC(Hstmt, SQLFetch(Hstmt));
+    is_num(my_fetch_int(Hstmt, 1), 300);
+    CHECK_STMT_RC(Hstmt, SQLFreeHandle(SQL_HANDLE_STMT, Hstmt));
+
+    CHECK_DBC_RC(Hdbc, SQLDisconnect(Hdbc));
+    CHECK_DBC_RC(Hdbc, SQLFreeConnect(Hdbc));
+  }
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_close_unread");
+
+  return OK;
+}
+
+
 ODBC_TEST(t_multistep)
 {
   SQLRETURN  rc;
@@ -2313,6 +2384,149 @@ ODBC_TEST(get_data_length)
 }
 
 
+/* Columns, needing conversion, are fetched via the statement's buffers. Those are reused from row to row, and
+   between executions - checking that values do not leak from one row to another, and the buffers survive
+   the cursor closing and the re-execution */
+ODBC_TEST(t_fetch_conversion_buffers)
+{
+  SQLWCHAR             wstr[16];
+  SQL_TIMESTAMP_STRUCT ts;
+  SQLINTEGER           id;
+  SQLCHAR              bit;
+  SQLLEN               wstrLen, tsLen, bitLen;
+  int                  exec, i;
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_fetch_conv_buf");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_fetch_conv_buf (id INT, s VARCHAR(12), d DATETIME, b TINYINT)");
+  OK_SIMPLE_STMT(Stmt, "INSERT INTO t_fetch_conv_buf VALUES (1, 'Row no 1', '2001-01-01 01:01:01', 1),"
+                       "(2, 'Row 2', '2002-02-02 02:02:02', 0), (3, NULL, NULL, NULL), (4, 'R4', '2004-04-04 04:04:04', 1)");
+
+  CHECK_STMT_RC(Stmt, SQLPrepare(Stmt, (SQLCHAR*)"SELECT id, s, d, b FROM t_fetch_conv_buf ORDER BY id", SQL_NTS));
+  CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_LONG, &id, 0, NULL));
+  CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 2, SQL_C_WCHAR, wstr, sizeof(wstr), &wstrLen));
+  CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 3, SQL_C_TYPE_TIMESTAMP, &ts, sizeof(ts), &tsLen));
+  CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 4, SQL_C_BIT, &bit, sizeof(bit), &bitLen));
+
+  for (exec= 0; exec < 3; ++exec)
+  {
+    CHECK_STMT_RC(Stmt, SQLExecute(Stmt));
+
+    for (i= 1; i < 5; ++i)
+    {
+      CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+      is_num(id, i);
+
+      switch (i)
+      {
+      case 1:
+        IS_WSTR(wstr, CW("Row no 1"), 9);
+        is_num(ts.year, 2001);
+        is_num(ts.second, 1);
+        is_num(bit, 1);
+        break;
+      case 2:
+        IS_WSTR(wstr, CW("Row 2"), 6);
+        is_num(ts.year, 2002);
+        is_num(ts.second, 2);
+        is_num(bit, 0);
+        break;
+      case 3:
+        is_num(wstrLen, SQL_NULL_DATA);
+        is_num(tsLen, SQL_NULL_DATA);
+        is_num(bitLen, SQL_NULL_DATA);
+        break;
+      case 4:
+        IS_WSTR(wstr, CW("R4"), 3);
+        is_num(ts.year, 2004);
+        is_num(ts.month, 4);
+        is_num(bit, 1);
+        break;
+      }
+    }
+    EXPECT_STMT(Stmt, SQLFetch(Stmt), SQL_NO_DATA);
+
+    /* 2nd time the cursor is closed before the end of the resultset */
+    if (exec == 1)
+    {
+      CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+      CHECK_STMT_RC(Stmt, SQLExecute(Stmt));
+      CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+      IS_WSTR(wstr, CW("Row no 1"), 9);
+    }
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  }
+
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_fetch_conv_buf");
+
+  return OK;
+}
+
+
+/* Buffered results of tens of megabytes are kept in large, huge page backed blocks with LARGE_PAGES. Scanning such
+   a static cursor, with text and binary protocol, and reusing the statement for the next result */
+ODBC_TEST(t_large_pages_result)
+{
+  const char *Options[]= {"LARGE_PAGES=1", "LARGE_PAGES=1;NO_SSPS=1"};
+  SQLCHAR     Conn[1024];
+  SQLHDBC     Hdbc;
+  SQLHSTMT    Hstmt;
+  SQLINTEGER  a;
+  SQLCHAR     b[256];
+  unsigned int i, Exec, Rows;
+  unsigned long long Sum;
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_large_pages");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_large_pages(a INT, b VARCHAR(255))");
+  for (i= 0; i < 300; ++i)
+  {
+    sprintf((char *)Conn, "INSERT INTO t_large_pages VALUES(%u, REPEAT('x', 200))", i);
+    OK_SIMPLE_STMT(Stmt, Conn);
+  }
+
+  for (i= 0; i < sizeof(Options)/sizeof(Options[0]); ++i)
+  {
+    CHECK_ENV_RC(Env, SQLAllocConnect(Env, &Hdbc));
+    sprintf((char *)Conn, "DRIVER=%s;UID=%s;PWD=%s;SERVER=%s;PORT=%u;DB=%s;%s",
+            my_drivername, my_uid, my_pwd, my_servername, my_port, my_schema, Options[i]);
+    CHECK_DBC_RC(Hdbc, SQLDriverConnect(Hdbc, NULL, Conn, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT));
+    CHECK_DBC_RC(Hdbc, SQLAllocHandle(SQL_HANDLE_STMT, Hdbc, &Hstmt));
+    CHECK_STMT_RC(Hstmt, SQLSetStmtAttr(Hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+    CHECK_STMT_RC(Hstmt, SQLBindCol(Hstmt, 1, SQL_C_LONG, &a, 0, NULL));
+    CHECK_STMT_RC(Hstmt, SQLBindCol(Hstmt, 2, SQL_C_CHAR, b, sizeof(b), NULL));
+
+    for (Exec= 0; Exec < 2; ++Exec)
+    {
+      /* 90000 rows, ~20MB */
+      OK_SIMPLE_STMT(Hstmt, "SELECT t1.a, t2.b FROM t_large_pages t1, t_large_pages t2");
+      Rows= 0;
+      Sum=  0;
+      while (SQLFetch(Hstmt) != SQL_NO_DATA)
+      {
+        ++Rows;
+        Sum+= a;
+      }
+      is_num(Rows, 90000);
+      is_num(Sum, 300ULL * (299 * 300 / 2));
+      is_num(strlen((char *)b), 200);
+
+      CHECK_STMT_RC(Hstmt, SQLFetchScroll(Hstmt, SQL_FETCH_FIRST, 0));
+      CHECK_STMT_RC(Hstmt, SQLFetchScroll(Hstmt, SQL_FETCH_LAST, 0));
+      is_num(strlen((char *)b), 200);
+      CHECK_STMT_RC(Hstmt, SQLCloseCursor(Hstmt));
+    }
+
+    CHECK_STMT_RC(Hstmt, SQLFreeHandle(SQL_HANDLE_STMT, Hstmt));
+    CHECK_DBC_RC(Hdbc, SQLDisconnect(Hdbc));
+    CHECK_DBC_RC(Hdbc, SQLFreeConnect(Hdbc));
+  }
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_large_pages");
+
+  return OK;
+}
+
+
 MA_ODBC_TESTS my_tests[]=
 {
   {my_resultset, "my_resultset",     NORMAL, ALL_DRIVERS},
@@ -2320,6 +2534,7 @@ MA_ODBC_TESTS my_tests[]=
   {t_desc_col, "t_desc_col",     NORMAL, ANSI_DRIVER},
   {t_convert, "t_convert",     NORMAL, ALL_DRIVERS},
   {t_max_rows, "t_max_rows",     NORMAL, ALL_DRIVERS},
+  {t_close_unread_result, "t_close_unread_result",     NORMAL, ALL_DRIVERS},
   {t_multistep, "t_multistep",     NORMAL, ALL_DRIVERS},
   {t_zerolength, "t_zerolength",     NORMAL, ALL_DRIVERS},
   {t_cache_bug, "t_cache_bug",     NORMAL, ALL_DRIVERS},
@@ -2346,6 +2561,8 @@ MA_ODBC_TESTS my_tests[]=
   {t_bug34429, "t_bug34429",     NORMAL, ALL_DRIVERS},
   {t_binary_collation, "t_binary_collation", CSPS_OK | SSPS_FAIL, ANSI_DRIVER},
   {get_data_length, "get_data_length", NORMAL, ALL_DRIVERS},
+  {t_fetch_conversion_buffers, "t_fetch_conversion_buffers", NORMAL, ALL_DRIVERS},
+  {t_large_pages_result, "t_large_pages_result", NORMAL, ALL_DRIVERS},
   {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 
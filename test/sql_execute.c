@@ -178,9 +178,111 @@ ODBC_TEST(execute_2_before_fetch_1) {
 
 ODBC_TEST(execute_async) {
     SQLUINTEGER async_mode;
+    SQLULEN async_enable;
+    SQLHSTMT hstmt;
+    SQLINTEGER value = 0;
+    SQLRETURN rc;
+    int polls = 0;
 
     CHECK_DBC_RC(Connection, SQLGetInfo(Connection, SQL_ASYNC_MODE, &async_mode, 0, NULL));
-    IS(async_mode == SQL_AM_NONE); /* Not supported */
+    if (async_mode == SQL_AM_NONE) {
+        /* Driver is linked against shared Connector/C library, that does not export the coroutine API */
+        EXPECT_STMT(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0),
+                    SQL_SUCCESS_WITH_INFO);
+        CHECK_SQLSTATE(Stmt, "01S02");
+        CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, SQL_ATTR_ASYNC_ENABLE, &async_enable, 0, NULL));
+        is_num(async_enable, SQL_ASYNC_ENABLE_OFF);
+        skip("Asynchronous execution is not supported by this build of the driver");
+    }
+    IS(async_mode == SQL_AM_STATEMENT);
+
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &hstmt));
+    CHECK_STMT_RC(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0));
+    CHECK_STMT_RC(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, &async_enable, 0, NULL));
+    is_num(async_enable, SQL_ASYNC_ENABLE_ON);
+
+    rc = SQLExecDirect(hstmt, (SQLCHAR*)"SELECT 7 FROM (SELECT SLEEP(1)) t", SQL_NTS);
+    is_num(rc, SQL_STILL_EXECUTING);
+    /* Only one asynchronous operation on the connection at a time */
+    EXPECT_STMT(Stmt, SQLExecDirect(Stmt, (SQLCHAR*)"SELECT 1", SQL_NTS), SQL_ERROR);
+    CHECK_SQLSTATE(Stmt, "HY010");
+    while (rc == SQL_STILL_EXECUTING) {
+        ++polls;
+        rc = SQLExecDirect(hstmt, (SQLCHAR*)"SELECT 7 FROM (SELECT SLEEP(1)) t", SQL_NTS);
+    }
+    CHECK_STMT_RC(hstmt, rc);
+    FAIL_IF(polls == 0, "Expected the statement to be executed asynchronously");
+
+    while ((rc = SQLFetch(hstmt)) == SQL_STILL_EXECUTING);
+    CHECK_STMT_RC(hstmt, rc);
+    CHECK_STMT_RC(hstmt, SQLGetData(hstmt, 1, SQL_C_LONG, &value, 0, NULL));
+    is_num(value, 7);
+    while ((rc = SQLFetch(hstmt)) == SQL_STILL_EXECUTING);
+    EXPECT_STMT(hstmt, rc, SQL_NO_DATA);
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    /* Prepared statement */
+    CHECK_STMT_RC(hstmt, SQLPrepare(hstmt, (SQLCHAR*)"SELECT 8", SQL_NTS));
+    while ((rc = SQLExecute(hstmt)) == SQL_STILL_EXECUTING);
+    CHECK_STMT_RC(hstmt, rc);
+    while ((rc = SQLFetch(hstmt)) == SQL_STILL_EXECUTING);
+    CHECK_STMT_RC(hstmt, rc);
+    CHECK_STMT_RC(hstmt, SQLGetData(hstmt, 1, SQL_C_LONG, &value, 0, NULL));
+    is_num(value, 8);
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    /* Connection is usable synchronously afterwards */
+    OK_SIMPLE_STMT(Stmt, "SELECT 1");
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    CHECK_STMT_RC(hstmt, SQLFreeHandle(SQL_HANDLE_STMT, hstmt));
+
+    return OK;
+}
+
+ODBC_TEST(execute_async_busy) {
+    SQLUINTEGER async_mode;
+    SQLHSTMT hstmt;
+    SQLINTEGER value = 0;
+    SQLRETURN rc;
+
+    CHECK_DBC_RC(Connection, SQLGetInfo(Connection, SQL_ASYNC_MODE, &async_mode, 0, NULL));
+    if (async_mode == SQL_AM_NONE) {
+        skip("Asynchronous execution is not supported by this build of the driver");
+    }
+
+    CHECK_DBC_RC(Connection, SQLAllocHandle(SQL_HANDLE_STMT, Connection, &hstmt));
+    CHECK_STMT_RC(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0));
+
+    rc = SQLExecDirect(hstmt, (SQLCHAR*)"SELECT 7 FROM (SELECT SLEEP(1)) t", SQL_NTS);
+    is_num(rc, SQL_STILL_EXECUTING);
+
+    /* Nothing else may be sent over the connection, while the operation is suspended mid-protocol */
+    EXPECT_STMT(Stmt, SQLPrepare(Stmt, (SQLCHAR*)"SELECT 1", SQL_NTS), SQL_ERROR);
+    CHECK_SQLSTATE(Stmt, "HY010");
+    EXPECT_STMT(Stmt, SQLTables(Stmt, NULL, 0, NULL, 0, NULL, 0, NULL, 0), SQL_ERROR);
+    CHECK_SQLSTATE(Stmt, "HY010");
+    EXPECT_STMT(hstmt, SQLGetData(hstmt, 1, SQL_C_LONG, &value, 0, NULL), SQL_ERROR);
+    CHECK_SQLSTATE(hstmt, "HY010");
+    EXPECT_DBC(Connection, SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_COMMIT), SQL_ERROR);
+    CHECK_SQLSTATE_EX(Connection, SQL_HANDLE_DBC, "HY010");
+    EXPECT_DBC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_ON, 0), SQL_ERROR);
+    CHECK_SQLSTATE_EX(Connection, SQL_HANDLE_DBC, "HY010");
+
+    while (rc == SQL_STILL_EXECUTING) {
+        rc = SQLExecDirect(hstmt, (SQLCHAR*)"SELECT 7 FROM (SELECT SLEEP(1)) t", SQL_NTS);
+    }
+    CHECK_STMT_RC(hstmt, rc);
+    while ((rc = SQLFetch(hstmt)) == SQL_STILL_EXECUTING);
+    CHECK_STMT_RC(hstmt, rc);
+    CHECK_STMT_RC(hstmt, SQLGetData(hstmt, 1, SQL_C_LONG, &value, 0, NULL));
+    is_num(value, 7);
+    CHECK_STMT_RC(hstmt, SQLFreeHandle(SQL_HANDLE_STMT, hstmt));
+
+    /* The calls, that have been rejected, succeed once the operation is finished */
+    CHECK_DBC_RC(Connection, SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_COMMIT));
+    CHECK_STMT_RC(Stmt, SQLTables(Stmt, NULL, 0, NULL, 0, NULL, 0, NULL, 0));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
 
     return OK;
 }
@@ -347,6 +449,7 @@ MA_ODBC_TESTS my_tests[] = {
    {execute_1_before_fetch_1, "execute_1_before_fetch_1", NORMAL, ALL_DRIVERS},
    {execute_2_before_fetch_1, "execute_2_before_fetch_1", NORMAL, ALL_DRIVERS},
    {execute_async, "execute_async", NORMAL, ALL_DRIVERS},
+   {execute_async_busy, "execute_async_busy", NORMAL, ALL_DRIVERS},
    {execute_no_data, "execute_no_data", KNOWN_FAILURE, ALL_DRIVERS},    //TODO: bug PLAT-5607
    {execute_unbound, "execute_unbound", NORMAL, ALL_DRIVERS},
    {execute_transaction, "execute_transaction", NORMAL, ALL_DRIVERS},
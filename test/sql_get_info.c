@@ -274,12 +274,16 @@ ODBC_TEST(driver_information)
 {
   SQLHDBC Hdbc;
   SQLCHAR conn[1024];
+  SQLUINTEGER AsyncMode;
 
   CHECK_ENV_RC(Env, SQLAllocHandle(SQL_HANDLE_DBC, Env, &Hdbc));
 
   CHECK_U_SMALL_INT(Connection, SQL_ACTIVE_ENVIRONMENTS, 0);
-  // CHECK_U_INTEGER(Connection, SQL_ASYNC_DBC_FUNCTIONS, SQL_ASYNC_DBC_NOT_CAPABLE); TODO PLAT-5514
-  CHECK_U_INTEGER(Connection, SQL_ASYNC_MODE, SQL_AM_NONE);
+  /* Asynchronous execution is not available, if the driver is linked against shared Connector/C library */
+  CHECK_DBC_RC(Connection, SQLGetInfo(Connection, SQL_ASYNC_MODE, &AsyncMode, 0, NULL));
+  FAIL_IF(AsyncMode != SQL_AM_STATEMENT && AsyncMode != SQL_AM_NONE, "Unexpected SQL_ASYNC_MODE");
+  CHECK_U_INTEGER(Connection, SQL_ASYNC_DBC_FUNCTIONS, AsyncMode == SQL_AM_NONE ? SQL_ASYNC_DBC_NOT_CAPABLE :
+                                                                                  SQL_ASYNC_DBC_CAPABLE);
   // CHECK_U_INTEGER(Connection, SQL_ASYNC_NOTIFICATION, SQL_ASYNC_NOTIFICATION_NOT_CAPABLE); TODO PLAT-5514
   CHECK_U_INTEGER(Connection, SQL_BATCH_ROW_COUNT, SQL_BRC_EXPLICIT);
   CHECK_U_INTEGER(Connection, SQL_BATCH_SUPPORT, SQL_BS_SELECT_EXPLICIT |
@@ -306,9 +310,11 @@ ODBC_TEST(driver_information)
   CHECK_DBC_RC(Hdbc, SQLDisconnect(Hdbc));
 
   CHECK_CHAR(Connection, SQL_DRIVER_NAME, WindowsDM(Connection) ? (is_unicode_driver() ? "ssodbcw.dll" : "ssodbca.dll") : (is_unicode_driver() ? "libssodbcw.so" : "libssodbca.so"));
-  CHECK_CHAR(Connection, SQL_DRIVER_ODBC_VER, "03.51");
+  CHECK_CHAR(Connection, SQL_DRIVER_ODBC_VER, "03.80");
   CHECK_CHAR(Connection, SQL_DRIVER_VER, MARIADB_ODBC_VERSION);
-  // CHECK_U_INTEGER(Connection, SQL_DRIVER_AWARE_POOLING_SUPPORTED, SQL_DRIVER_AWARE_POOLING_NOT_CAPABLE); TODO PLAT-5514
+#ifdef SQL_DRIVER_AWARE_POOLING_SUPPORTED
+  CHECK_U_INTEGER(Connection, SQL_DRIVER_AWARE_POOLING_SUPPORTED, SQL_DRIVER_AWARE_POOLING_CAPABLE);
+#endif
   CHECK_U_INTEGER(Connection, SQL_DYNAMIC_CURSOR_ATTRIBUTES1, SQL_CA1_NEXT |
                                                                 SQL_CA1_ABSOLUTE |
                                                                 SQL_CA1_RELATIVE |
@@ -376,7 +382,7 @@ ODBC_TEST(driver_information)
                                                        SQL_ISV_VIEWS);
   CHECK_U_INTEGER(Connection, SQL_KEYSET_CURSOR_ATTRIBUTES1, 0);
   CHECK_U_INTEGER(Connection, SQL_KEYSET_CURSOR_ATTRIBUTES2, 0);
-  CHECK_U_INTEGER(Connection, SQL_MAX_ASYNC_CONCURRENT_STATEMENTS, 0); // TODO PLAT-5472
+  CHECK_U_INTEGER(Connection, SQL_MAX_ASYNC_CONCURRENT_STATEMENTS, AsyncMode == SQL_AM_NONE ? 0 : 1);
   CHECK_U_SMALL_INT(Connection, SQL_MAX_CONCURRENT_ACTIVITIES, 0); // TODO PLAT-5472
   CHECK_U_SMALL_INT(Connection, SQL_MAX_DRIVER_CONNECTIONS, 0);
   CHECK_U_SMALL_INT(Connection, SQL_ODBC_INTERFACE_CONFORMANCE, SQL_OIC_CORE);
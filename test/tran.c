@@ -164,6 +164,56 @@ ODBC_TEST(t_isolation)
                             sizeof(tx_isolation), NULL));
   CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
   IS_STR(tx_isolation, "READ-UNCOMMITTED", 16);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  /* Invalid level is rejected when it's set, and not when the next statement is executed */
+  EXPECT_DBC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_TXN_ISOLATION, (SQLPOINTER)0x7fff, 0), SQL_ERROR);
+  CHECK_SQLSTATE_EX(Connection, SQL_HANDLE_DBC, "HY024");
+  OK_SIMPLE_STMT(Stmt, "SELECT 1");
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  return OK;
+}
+
+
+/**
+  Autocommit mode changes reach the server before the next statement, and switching autocommit on still commits
+  the open transaction right away
+*/
+ODBC_TEST(t_deferred_autocommit)
+{
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_ON, 0));
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+
+  OK_SIMPLE_STMT(Stmt, "SELECT @@autocommit");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), 0);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE IF EXISTS t_deferred_autocommit");
+  OK_SIMPLE_STMT(Stmt, "CREATE TABLE t_deferred_autocommit (a INT)");
+  CHECK_DBC_RC(Connection, SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_COMMIT));
+
+  OK_SIMPLE_STMT(Stmt, "INSERT INTO t_deferred_autocommit VALUES(1)");
+  CHECK_DBC_RC(Connection, SQLSetConnectAttr(Connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_ON, 0));
+  CHECK_DBC_RC(Connection, SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_ROLLBACK));
+
+  OK_SIMPLE_STMT(Stmt, "SELECT COUNT(*), @@autocommit FROM t_deferred_autocommit");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), 1);
+  is_num(my_fetch_int(Stmt, 2), 1);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+  /* Autocommit, changed by the application's own SET, is not overridden by the driver before the next statement */
+  OK_SIMPLE_STMT(Stmt, "SET autocommit=0");
+  OK_SIMPLE_STMT(Stmt, "SELECT @@autocommit");
+  CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+  is_num(my_fetch_int(Stmt, 1), 0);
+  CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+  OK_SIMPLE_STMT(Stmt, "SET autocommit=1");
+
+  OK_SIMPLE_STMT(Stmt, "DROP TABLE t_deferred_autocommit");
 
   return OK;
 }
@@ -174,6 +224,7 @@ MA_ODBC_TESTS my_tests[]=
   {my_transaction,"my_transaction", ALL_DRIVERS},
   {t_tran, "t_tran", ALL_DRIVERS},
   {t_isolation,"t_isolation", ALL_DRIVERS},
+  {t_deferred_autocommit, "t_deferred_autocommit", ALL_DRIVERS},
   {NULL, NULL, NORMAL, ALL_DRIVERS}
 };
 